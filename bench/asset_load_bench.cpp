@@ -0,0 +1,133 @@
+#include "asset_cache.h"
+#include "config.h"
+#include "fake_xplm.h"
+#include "path.h"
+#include <XPLMGraphics.h>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nanosvgrast.h"
+
+// Statusbar icons at the size Image rasterizes them for a 1024 pixel wide tablet (16 * 1024 / 800).
+static constexpr unsigned int iconSize = 20;
+
+static const std::vector<std::string> &iconFiles() {
+    static std::vector<std::string> files;
+    if (!files.empty()) {
+        return files;
+    }
+
+    for (const auto &entry : std::filesystem::directory_iterator(ASSETS_DIR "/icons")) {
+        files.push_back(entry.path().string());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+static std::string pluginDirectory() {
+    static std::string directory;
+    if (directory.empty()) {
+        directory = (std::filesystem::temp_directory_path() / "avitab_browser_asset_bench").string();
+        std::filesystem::create_directories(directory);
+    }
+
+    return directory;
+}
+
+// What Image::Image did for every icon before the asset cache: parse, rasterize and upload on the sim thread.
+static void BM_AssetLoadSynchronous(benchmark::State &state) {
+    FakeXPLM::reset();
+    const auto &files = iconFiles();
+    for (auto _ : state) {
+        std::vector<int> textureIds;
+        for (int i = 0; i < state.range(0); ++i) {
+            NSVGimage *image = nsvgParseFromFile(files[i].c_str(), "px", 96);
+            struct NSVGrasterizer *rast = nsvgCreateRasterizer();
+            unsigned char *data = (unsigned char *)calloc(iconSize * iconSize, 4);
+            nsvgRasterize(rast, image, 0, 0, (float)iconSize / image->width, data, iconSize, iconSize, iconSize * 4);
+            nsvgDeleteRasterizer(rast);
+            nsvgDelete(image);
+
+            int textureId;
+            XPLMGenerateTextureNumbers(&textureId, 1);
+            XPLMBindTexture2d(textureId, 0);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, iconSize, iconSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+            free(data);
+            textureIds.push_back(textureId);
+        }
+        benchmark::DoNotOptimize(textureIds.data());
+    }
+}
+BENCHMARK(BM_AssetLoadSynchronous)->Arg(5)->Arg(20)->Arg(50)->Unit(benchmark::kMillisecond);
+
+// Loads the icons through the asset cache. Reports either the time the sim thread spends in
+// acquire() and update() (the load hitch), or the wall time until every texture exists.
+// The second argument keeps the on-disk raster cache from the previous iteration.
+static void assetLoad(benchmark::State &state, bool simThreadOnly) {
+    FakeXPLM::reset();
+    Path::getInstance()->pluginDirectory = pluginDirectory();
+    AssetCache *cache = AssetCache::getInstance();
+    const auto &files = iconFiles();
+    bool warmRasterCache = state.range(1);
+    std::filesystem::remove_all(pluginDirectory() + "/raster_cache");
+
+    for (auto _ : state) {
+        if (!warmRasterCache) {
+            std::filesystem::remove_all(pluginDirectory() + "/raster_cache");
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::chrono::duration<double> simThreadTime(0);
+        std::vector<unsigned int> ids;
+        for (int i = 0; i < state.range(0); ++i) {
+            CachedAsset asset;
+            if (cache->acquire(files[i], iconSize, iconSize, &asset)) {
+                ids.push_back(asset.id);
+            }
+        }
+        simThreadTime += std::chrono::steady_clock::now() - start;
+
+        // One update() per draw callback, until every icon has its texture.
+        size_t readyCount = 0;
+        while (readyCount < ids.size()) {
+            auto updateStart = std::chrono::steady_clock::now();
+            cache->update();
+            simThreadTime += std::chrono::steady_clock::now() - updateStart;
+
+            readyCount = 0;
+            for (unsigned int id : ids) {
+                AssetTexture texture;
+                bool isPending;
+                if (cache->texture(id, &texture, &isPending) || !isPending) {
+                    readyCount++;
+                }
+            }
+            if (readyCount < ids.size()) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+
+        std::chrono::duration<double> totalTime = std::chrono::steady_clock::now() - start;
+        state.SetIterationTime(simThreadOnly ? simThreadTime.count() : totalTime.count());
+
+        for (unsigned int id : ids) {
+            cache->release(id);
+        }
+        cache->destroy();
+    }
+}
+
+static void BM_AssetLoadSimThread(benchmark::State &state) {
+    assetLoad(state, true);
+}
+BENCHMARK(BM_AssetLoadSimThread)->ArgsProduct({{5, 20, 50}, {0, 1}})->UseManualTime()->Unit(benchmark::kMillisecond);
+
+static void BM_AssetLoadUntilReady(benchmark::State &state) {
+    assetLoad(state, false);
+}
+BENCHMARK(BM_AssetLoadUntilReady)->ArgsProduct({{5, 20, 50}, {0, 1}})->UseManualTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,124 @@
+#include "dataref.h"
+#include "fake_xplm.h"
+#include <XPLMDataAccess.h>
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+// The cache Dataref::update() walked before the typed snapshot columns: a variant per name, with
+// a handle lookup, a value lookup and a callback lookup by string for every entry on every tick.
+class LegacyDatarefCache {
+    using Value = std::variant<int, float, double, std::string, std::vector<int>>;
+    std::unordered_map<std::string, XPLMDataRef> refs;
+    std::unordered_map<std::string, Value> cachedValues;
+    std::unordered_map<std::string, std::function<void(Value)>> callbacks;
+
+public:
+    void monitor(const std::string &name, std::function<void(Value)> callback) {
+        cachedValues[name] = get(name.c_str());
+        callbacks[name] = callback;
+    }
+
+    float get(const char *ref) {
+        auto it = refs.find(ref);
+        XPLMDataRef handle = it != refs.end() ? it->second : (refs[ref] = XPLMFindDataRef(ref));
+        return handle ? XPLMGetDataf(handle) : 0.0f;
+    }
+
+    void update() {
+        for (auto &[key, data] : cachedValues) {
+            std::visit([&](auto &&value) {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, float>) {
+                    float newValue = get(key.c_str());
+                    bool didChange = value != newValue;
+                    cachedValues[key] = newValue;
+                    if (didChange && callbacks.find(key) != callbacks.end()) {
+                        callbacks[key](cachedValues[key]);
+                    }
+                }
+            }, data);
+        }
+    }
+};
+
+// Refs are shared between the sizes, so they must run from small to large: the columns only grow.
+static std::string benchRefName(int i) {
+    return "bench/update/float" + std::to_string(i);
+}
+
+static void BM_DatarefUpdate(benchmark::State &state) {
+    Dataref *dataref = Dataref::getInstance();
+    for (int i = 0; i < state.range(0); ++i) {
+        std::string name = benchRefName(i);
+        FakeXPLM::setFloat(name, (float)i);
+        dataref->monitorExistingDataref<float>(name.c_str(), [](float value) {});
+    }
+    dataref->update();
+
+    for (auto _ : state) {
+        dataref->update();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    dataref->destroyAllBindings();
+}
+BENCHMARK(BM_DatarefUpdate)->Arg(50)->Arg(500)->Arg(5000);
+
+static void BM_LegacyDatarefUpdate(benchmark::State &state) {
+    LegacyDatarefCache cache;
+    for (int i = 0; i < state.range(0); ++i) {
+        std::string name = benchRefName(i);
+        FakeXPLM::setFloat(name, (float)i);
+        cache.monitor(name, [](auto value) {});
+    }
+
+    for (auto _ : state) {
+        cache.update();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LegacyDatarefUpdate)->Arg(50)->Arg(500)->Arg(5000);
+
+static void BM_DatarefGetCached(benchmark::State &state) {
+    Dataref *dataref = Dataref::getInstance();
+    std::vector<DatarefKey> keys;
+    for (int i = 0; i < state.range(0); ++i) {
+        std::string name = benchRefName(i);
+        FakeXPLM::setFloat(name, (float)i);
+        keys.emplace_back(name.c_str());
+        dataref->getCached<float>(keys.back());
+    }
+
+    for (auto _ : state) {
+        for (const auto &key : keys) {
+            benchmark::DoNotOptimize(dataref->getCached<float>(key));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DatarefGetCached)->Arg(50)->Arg(500)->Arg(5000);
+
+static void BM_DatarefGetCachedByName(benchmark::State &state) {
+    Dataref *dataref = Dataref::getInstance();
+    std::vector<std::string> names;
+    for (int i = 0; i < state.range(0); ++i) {
+        names.push_back(benchRefName(i));
+        FakeXPLM::setFloat(names.back(), (float)i);
+        dataref->getCached<float>(names.back().c_str());
+    }
+
+    for (auto _ : state) {
+        for (const auto &name : names) {
+            benchmark::DoNotOptimize(dataref->getCached<float>(name.c_str()));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DatarefGetCachedByName)->Arg(50)->Arg(500)->Arg(5000);
@@ -0,0 +1,17 @@
+#include "dirty_rect_coalescer.h"
+#include <benchmark/benchmark.h>
+
+// A page with a blinking caret, a spinner and a scrolling ticker reports a few rects per paint;
+// an animated map or chart can report hundreds. Merging is quadratic in the pending count.
+static void BM_DirtyRectMerge(benchmark::State &state) {
+    const int count = (int)state.range(0);
+    for (auto _ : state) {
+        DirtyRectCoalescer coalescer;
+        for (int i = 0; i < count; ++i) {
+            coalescer.add({(i * 97) % 1900, (i * 61) % 1060, 12, 12});
+        }
+        benchmark::DoNotOptimize(coalescer.take(0));
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_DirtyRectMerge)->Arg(8)->Arg(32)->Arg(128)->Arg(512);
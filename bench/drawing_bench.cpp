@@ -0,0 +1,115 @@
+#include "drawing.h"
+#include "appstate.h"
+#include "config.h"
+#include "fake_gl.h"
+#include "fake_xplm.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+
+static constexpr int rectCount = 100;
+static constexpr float radius = 10.0f;
+
+static float absoluteX(float normalizedX) {
+    return AppState::getInstance()->tabletDimensions.x + AppState::getInstance()->tabletDimensions.width * normalizedX;
+}
+
+static float absoluteY(float normalizedY) {
+    return AppState::getInstance()->tabletDimensions.y + AppState::getInstance()->tabletDimensions.height * normalizedY;
+}
+
+// Drawing::DrawRoundedRect before the retained geometry: five immediate mode blocks with cos/sin
+// per corner vertex, plus two line passes per 2px of radius for the sides.
+static void legacyDrawRoundedRect(float x1, float y1, float x2, float y2, float radius) {
+    constexpr int cornerSegments = 16;
+    glBegin(GL_QUADS);
+    glVertex2f(absoluteX(x1) + radius, absoluteY(y1));
+    glVertex2f(absoluteX(x1) + radius, absoluteY(y2));
+    glVertex2f(absoluteX(x2) - radius, absoluteY(y2));
+    glVertex2f(absoluteX(x2) - radius, absoluteY(y1));
+    glEnd();
+
+    const float corners[4][3] = {
+        {x1, y2, 2.0f},
+        {x2, y2, 3.0f},
+        {x1, y1, 1.0f},
+        {x2, y1, 0.0f},
+    };
+    for (const auto &corner : corners) {
+        float centerX = absoluteX(corner[0]) + (corner[0] == x1 ? radius : -radius);
+        float centerY = absoluteY(corner[1]) + (corner[1] == y1 ? radius : -radius);
+        glBegin(GL_TRIANGLE_FAN);
+        glVertex2f(centerX, centerY);
+        for (int i = 0; i <= cornerSegments; ++i) {
+            float angle = (M_PI_2 * corner[2]) + i * (M_PI_2 / cornerSegments);
+            glVertex2f(centerX + cos(angle) * radius, centerY - sin(angle) * radius);
+        }
+        glEnd();
+    }
+
+    glLineWidth(2);
+    int numPasses = ceil(radius / 2.0f);
+    for (int i = 0; i < numPasses; ++i) {
+        float offset = i * 2.0f + 1.0f;
+        glBegin(GL_LINES);
+        glVertex2f(roundf(absoluteX(x1) + offset), absoluteY(y1) + radius);
+        glVertex2f(roundf(absoluteX(x1) + offset), absoluteY(y2) - radius);
+        glEnd();
+
+        glBegin(GL_LINES);
+        glVertex2f(roundf(absoluteX(x2) - offset), absoluteY(y2) - radius);
+        glVertex2f(roundf(absoluteX(x2) - offset), absoluteY(y1) + radius);
+        glEnd();
+    }
+}
+
+// 100 distinct pills in a 10x10 grid, like tab pills and notifications but many more of them.
+// The frame argument shifts their width, to model shapes that change size every frame.
+template <typename DrawFunction>
+static void drawFrame(DrawFunction draw, int frame) {
+    for (int i = 0; i < rectCount; ++i) {
+        float x = (i % 10) * 0.1f;
+        float y = (i / 10) * 0.1f;
+        draw(x, y, x + 0.08f + (frame % 2) * 0.01f, y + 0.06f, radius);
+    }
+}
+
+static void setUpTablet() {
+    FakeXPLM::reset();
+    FakeGL::reset();
+    AppState::getInstance()->tabletDimensions = {0, 0, 1024, 768, 1024, 768, 1024, 738};
+}
+
+static void reportDrawCalls(benchmark::State &state) {
+    state.counters["draw_calls"] = benchmark::Counter(FakeGL::drawCalls(), benchmark::Counter::kAvgIterations);
+}
+
+static void BM_RoundedRectImmediate(benchmark::State &state) {
+    setUpTablet();
+    for (auto _ : state) {
+        drawFrame(legacyDrawRoundedRect, 0);
+    }
+    reportDrawCalls(state);
+}
+BENCHMARK(BM_RoundedRectImmediate);
+
+static void BM_RoundedRectRetained(benchmark::State &state) {
+    setUpTablet();
+    drawFrame(Drawing::DrawRoundedRect, 0);
+    FakeGL::reset();
+    for (auto _ : state) {
+        drawFrame(Drawing::DrawRoundedRect, 0);
+    }
+    reportDrawCalls(state);
+}
+BENCHMARK(BM_RoundedRectRetained);
+
+// Worst case for the cache: every shape changes size every frame, so each one is tessellated again.
+static void BM_RoundedRectRetainedResizing(benchmark::State &state) {
+    setUpTablet();
+    int frame = 0;
+    for (auto _ : state) {
+        drawFrame(Drawing::DrawRoundedRect, ++frame);
+    }
+    reportDrawCalls(state);
+}
+BENCHMARK(BM_RoundedRectRetainedResizing);
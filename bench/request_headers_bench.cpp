@@ -0,0 +1,55 @@
+#include "request_headers.h"
+#include <benchmark/benchmark.h>
+#include <string>
+
+static const std::string userAgent = "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/117.0.0.0 Safari/537.36";
+
+// A subresource request as Chromium hands it to OnBeforeResourceLoad.
+static CefRefPtr<CefRequest> createRequest() {
+    CefRefPtr<CefRequest> request = CefRequest::Create();
+    request->SetURL("https://tiles.example.com/maps/12/2104/1346.png");
+    request->SetHeaderByName("Accept", "image/avif,image/webp,image/apng,image/svg+xml,image/*,*/*;q=0.8", true);
+    request->SetHeaderByName("Accept-Encoding", "gzip, deflate, br", true);
+    request->SetHeaderByName("Accept-Language", "en-US,en;q=0.9", true);
+    request->SetHeaderByName("Referer", "https://www.example.com/maps", true);
+    request->SetHeaderByName("Sec-Fetch-Dest", "image", true);
+    request->SetHeaderByName("Sec-Fetch-Mode", "no-cors", true);
+    request->SetHeaderByName("Sec-Fetch-Site", "same-site", true);
+    request->SetHeaderByName("User-Agent", "Mozilla/5.0 Chrome/117.0.0.0", true);
+    return request;
+}
+
+// What OnBeforeResourceLoad did before: copy the header map, replace the User-Agent with the config string, and write it all back.
+static void BM_RequestHeadersCopyMap(benchmark::State &state) {
+    CefRefPtr<CefRequest> request = createRequest();
+    for (auto _ : state) {
+        CefRequest::HeaderMap headers;
+        request->GetHeaderMap(headers);
+        auto it = headers.find("User-Agent");
+        if (it != headers.end()) {
+            headers.erase("User-Agent");
+            headers.insert(std::make_pair("User-Agent", userAgent));
+            request->SetHeaderMap(headers);
+        }
+    }
+}
+BENCHMARK(BM_RequestHeadersCopyMap);
+
+static void BM_RequestHeadersApply(benchmark::State &state) {
+    RequestHeaders::getInstance()->configure(userAgent, {});
+    CefRefPtr<CefRequest> request = createRequest();
+    for (auto _ : state) {
+        RequestHeaders::getInstance()->apply(request, "");
+    }
+}
+BENCHMARK(BM_RequestHeadersApply);
+
+static void BM_RequestHeadersApplyWithDomainRules(benchmark::State &state) {
+    RequestHeaders::getInstance()->configure(userAgent, {"Accept-Language: en-GB", "example.com X-Client: avitab", "other.org X-Client: avitab"});
+    CefRefPtr<CefRequest> request = createRequest();
+    std::string url = request->GetURL().ToString();
+    for (auto _ : state) {
+        RequestHeaders::getInstance()->apply(request, url);
+    }
+}
+BENCHMARK(BM_RequestHeadersApplyWithDomainRules);
@@ -5,8 +5,16 @@
 #include "config.h"
 #include "dataref.h"
 #include "drawing.h"
+#include "geolocation_channel.h"
+#include "message_pump.h"
+#include "offline_cache.h"
 #include "path.h"
+#include "performance.h"
+#include "request_filter.h"
+#include "request_headers.h"
+#include "trace.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <filesystem>
@@ -22,8 +30,6 @@
 #include <include/cef_version.h>
 #include <include/wrapper/cef_closure_task.h>
 #include <include/wrapper/cef_helpers.h>
-#include <iomanip>
-#include <sstream>
 #include <XPLMDisplay.h>
 #include <XPLMGraphics.h>
 #include <XPLMProcessing.h>
@@ -37,15 +43,44 @@
 #include "unix_keycodes.h"
 #endif
 
+static const DatarefKey latitudeRef("sim/flightmodel/position/latitude");
+static const DatarefKey longitudeRef("sim/flightmodel/position/longitude");
+static const DatarefKey groundspeedRef("sim/flightmodel/position/groundspeed");
+static const DatarefKey elevationRef("sim/flightmodel/position/elevation");
+static const DatarefKey magneticHeadingRef("sim/flightmodel/position/mag_psi");
+static const DatarefKey windDirectionRef("sim/weather/wind_direction_degt");
+static const DatarefKey windSpeedRef("sim/weather/wind_speed_kt");
+static const DatarefKey heightAboveGroundRef("sim/flightmodel/position/y_agl");
+static const DatarefKey indicatedAirspeedRef("sim/flightmodel/position/indicated_airspeed");
+static const DatarefKey trackRef("sim/flightmodel/position/hpath");
+static const DatarefKey framePeriodRef("sim/operation/misc/frame_rate_period");
+
+static constexpr float tabBudgetInterval = 5.0f;
+// Assumed JavaScript heap of tabs that never reported theirs, e.g. because their CSP blocks the tab reporter.
+static constexpr long long estimatedTabHeapBytes = 64LL * 1024 * 1024;
+
 Browser::Browser() {
     textureId = 0;
+    uploader = nullptr;
+    frameStore = nullptr;
+    governor = nullptr;
+    activeTab = nullptr;
+    requestContext = nullptr;
+    lastTabBudgetTime = 0.0f;
+    lastMouseX = -1;
+    lastMouseY = -1;
     offsetStart = 0.0f;
     offsetEnd = 0.0f;
     lastGpsUpdateTime = 0.0f;
+    lastGpsFallbackTime = 0.0f;
     backButton = nullptr;
     handler = nullptr;
     currentUrl = "";
     leftMouseButtonDown = false;
+    prewarming = false;
+    prewarmed = false;
+    measureFirstFrame = false;
+    showTime = 0.0f;
 }
 
 void Browser::initialize() {
@@ -100,6 +135,7 @@ void Browser::initialize() {
                 return false;
             }
 
+            AppState::getInstance()->browser->visibilityWillChange(false);
             AppState::getInstance()->browserVisible = false;
             Dataref::getInstance()->executeCommand("AviTab/Home");
 
@@ -153,7 +189,26 @@ void Browser::initialize() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-    currentUrl = AppState::getInstance()->config.homepage;
+    uploader = new TextureUploader(
+        textureId,
+        AppState::getInstance()->tabletDimensions.textureWidth,
+        AppState::getInstance()->tabletDimensions.textureHeight,
+        AppState::getInstance()->tabletDimensions.bytesPerPixel);
+    uploader->setFrameBudget((size_t) AppState::getInstance()->config.upload_budget * 1024);
+
+    OfflineCache::getInstance()->initialize(Path::getInstance()->pluginDirectory + "/offline_cache", AppState::getInstance()->config.offline_cache_patterns);
+
+    RequestFilter::getInstance()->load(Path::getInstance()->pluginDirectory + "/filters");
+    for (const auto &list : RequestFilter::getInstance()->lists) {
+        debug("Loaded request filter list %s with %u rules.\n", list->name.c_str(), list->ruleCount);
+    }
+
+    RequestHeaders::getInstance()->configure(AppState::getInstance()->config.user_agent, AppState::getInstance()->config.request_headers);
+
+    governor = new FrameRateGovernor(AppState::getInstance()->config.framerate, AppState::getInstance()->config.idle_framerate);
+
+    activeTab = createTab("", AppState::getInstance()->config.homepage);
+    currentUrl = activeTab->url;
 
     Dataref::getInstance()->createDataref<std::string>("avitab_browser/url", &currentUrl, true, [this](std::string newUrl) {
         if (!newUrl.starts_with("http") && !newUrl.starts_with("chrome://") && !newUrl.starts_with("data:")) {
@@ -164,6 +219,12 @@ void Browser::initialize() {
         return true;
     });
 
+    Dataref::getInstance()->createDataref<float>("avitab_browser/message_pump/frequency", &MessagePump::getInstance()->pumpsPerSecond);
+    Dataref::getInstance()->createDataref<float>("avitab_browser/message_pump/milliseconds", &MessagePump::getInstance()->averagePumpMilliseconds);
+    Dataref::getInstance()->createDataref<int>("avitab_browser/framerate/current", &governor->frameRate);
+    Dataref::getInstance()->createDataref<std::string>("avitab_browser/framerate/reason", &governor->reason);
+    Dataref::getInstance()->createDataref<int>("avitab_browser/perf/framerate", &governor->frameRate);
+
     Dataref::getInstance()->createCommand("avitab_browser/refresh", "Refresh the current web page", [this](XPLMCommandPhase inPhase) {
         if (inPhase != xplm_CommandBegin) {
             return;
@@ -176,26 +237,38 @@ void Browser::initialize() {
 }
 
 void Browser::destroy() {
-    if (handler && handler->browserInstance) {
-        handler->browserInstance->GetHost()->CloseBrowser(true);
+    for (const auto &list : RequestFilter::getInstance()->lists) {
+        debug("Request filter list %s blocked %llu requests.\n", list->name.c_str(), list->hits.load());
+    }
+
+    // Discarded tabs may still be closing.
+    bool hasOpenBrowsers = !closingHandlers.empty();
+    for (BrowserTab *tab : tabs) {
+        if (tab->handler && tab->handler->browserInstance) {
+            tab->handler->browserInstance->GetHost()->CloseBrowser(true);
+            hasOpenBrowsers = true;
+        }
+    }
 
+    if (hasOpenBrowsers) {
         auto startTime = std::chrono::steady_clock::now() + std::chrono::seconds(99);
         auto gracePeriod = std::chrono::milliseconds(500);
         while (1) {
-            // Get some message loop reps in so the browser can properly close.
+            // Get some message loop reps in so the browsers can properly close.
             CefDoMessageLoopWork();
 
-            if (!handler->browserInstance && startTime > std::chrono::steady_clock::now()) {
-                // The browser has closed. Start grace countdown.
+            releaseClosedHandlers();
+            bool allClosed = closingHandlers.empty() && std::none_of(tabs.begin(), tabs.end(), [](BrowserTab *tab) {
+                return tab->handler && tab->handler->browserInstance;
+            });
+            if (allClosed && startTime > std::chrono::steady_clock::now()) {
+                // The browsers have closed. Start grace countdown.
                 startTime = std::chrono::steady_clock::now();
             } else if (std::chrono::steady_clock::now() - startTime > gracePeriod) {
                 break;
             }
         }
 
-        handler->destroy();
-        handler = nullptr;
-
         // Never call CefShutdown(); since this makes all further CefInitialize(); crash.
         // #if IBM
         // debug("Cleaning up CEF instance...\n");
@@ -203,6 +276,41 @@ void Browser::destroy() {
         // #endif
     }
 
+    for (CefRefPtr<BrowserHandler> closing : closingHandlers) {
+        closing->destroy();
+    }
+    closingHandlers.clear();
+
+    for (BrowserTab *tab : tabs) {
+        if (tab->handler) {
+            tab->handler->destroy();
+            tab->handler = nullptr;
+        }
+
+        delete tab->frameStore;
+        delete tab;
+    }
+    tabs.clear();
+    activeTab = nullptr;
+    handler = nullptr;
+    frameStore = nullptr;
+    requestContext = nullptr;
+
+    if (uploader) {
+        uploader->destroy();
+        delete uploader;
+        uploader = nullptr;
+    }
+
+    if (governor) {
+        // These read straight from the governor.
+        Dataref::getInstance()->unbind("avitab_browser/framerate/current");
+        Dataref::getInstance()->unbind("avitab_browser/framerate/reason");
+        Dataref::getInstance()->unbind("avitab_browser/perf/framerate");
+        delete governor;
+        governor = nullptr;
+    }
+
     if (textureId) {
         XPLMBindTexture2d(textureId, 0);
         glDeleteTextures(1, (GLuint *) &textureId);
@@ -215,24 +323,70 @@ void Browser::destroy() {
     }
 }
 
+void Browser::prewarm() {
+    if (!AppState::getInstance()->config.prewarm || !textureId || handler) {
+        return;
+    }
+
+    debug("Pre-warming the browser in the background...\n");
+    prewarming = true;
+    if (!createBrowser()) {
+        prewarming = false;
+        return;
+    }
+
+    MessagePump::getInstance()->wake();
+}
+
+bool Browser::isPrewarming() {
+    return prewarming;
+}
+
+bool Browser::hasPage() {
+    return handler != nullptr;
+}
+
 void Browser::resetHandler() {
     if (handler) {
         handler->destroy();
         handler = nullptr;
+        activeTab->handler = nullptr;
     }
 }
 
 void Browser::visibilityWillChange(bool becomesVisible) {
+    prewarming = false;
+
     if (becomesVisible) {
         // If handler exists but browserInstance is null, the browser was closed by a page
         // Clear the handler so we can create a fresh one
         if (handler && !handler->browserInstance) {
             handler = nullptr;
+            activeTab->handler = nullptr;
         }
 
         if (!handler) {
             createBrowser();
         }
+
+        if (measureFirstFrame) {
+            showTime = XPLMGetElapsedTime();
+        }
+    }
+
+    if (handler && handler->browserInstance) {
+        CefRefPtr<CefBrowserHost> host = handler->browserInstance->GetHost();
+        host->WasHidden(!becomesVisible);
+        if (AppState::getInstance()->config.mute_when_hidden) {
+            host->SetAudioMuted(!becomesVisible || AppState::getInstance()->config.audio_muted);
+        }
+
+        if (becomesVisible) {
+            // The texture still holds the last frame, which is shown until the fresh one arrives.
+            host->Invalidate(PET_VIEW);
+            notifyInput();
+            host->SetWindowlessFrameRate(governor->frameRate);
+        }
     }
 
     lastGpsUpdateTime = becomesVisible ? XPLMGetElapsedTime() : 0.0f;
@@ -243,15 +397,45 @@ void Browser::update() {
         return;
     }
 
+    TRACE_SCOPE("Browser::update");
+    PerformanceTimer timer(Performance::getInstance()->browserUpdate);
+
     if (handler && AppState::getInstance()->browserVisible) {
-        CefDoMessageLoopWork();
+        MessagePump::getInstance()->pumpIfDue();
+
+        float framePeriod = Dataref::getInstance()->getCached<float>(framePeriodRef);
+        if (governor->update(XPLMGetElapsedTime(), framePeriod > 0.0f ? 1.0f / framePeriod : 0.0f) && handler->browserInstance) {
+            handler->browserInstance->GetHost()->SetWindowlessFrameRate(governor->frameRate);
+        }
+    } else if (handler && prewarming) {
+        MessagePump::getInstance()->pumpIfDue();
+
+        if (handler->browserInstance && handler->hasPainted && !handler->browserInstance->IsLoading()) {
+            // The homepage is ready, park it until the browser is opened.
+            debug("Pre-warmed browser is ready.\n");
+            handler->browserInstance->GetHost()->WasHidden(true);
+            prewarming = false;
+        }
+    } else if (handler) {
+        MessagePump::getInstance()->pumpInBackground();
     }
 
     if (backButton) {
         backButton->visible = AppState::getInstance()->browserVisible;
     }
 
-    if (lastGpsUpdateTime > __FLT_EPSILON__ && XPLMGetElapsedTime() > lastGpsUpdateTime + 1.0f) {
+    if (activeTab && currentUrl != activeTab->url) {
+        currentUrl = activeTab->url;
+    }
+
+    releaseClosedHandlers();
+    if (XPLMGetElapsedTime() > lastTabBudgetTime + tabBudgetInterval) {
+        lastTabBudgetTime = XPLMGetElapsedTime();
+        discardTabsOverBudget();
+    }
+
+    float gpsUpdateInterval = 1.0f / AppState::getInstance()->config.geolocation_rate;
+    if (lastGpsUpdateTime > __FLT_EPSILON__ && XPLMGetElapsedTime() > lastGpsUpdateTime + gpsUpdateInterval) {
         updateGPSLocation();
     }
 }
@@ -271,6 +455,21 @@ void Browser::draw() {
         0  // No depth write, e.g. glDepthMask(GL_FALSE);
     );
 
+    if (uploader && frameStore) {
+        // Paints only land in the frame store; the newest complete frame is uploaded here, once per sim frame.
+        if (frameStore->acquire()) {
+            uploader->queue(frameStore->frontRects());
+            governor->notifyPaint();
+
+            if (measureFirstFrame && showTime > 0.0f) {
+                measureFirstFrame = false;
+                debug("Time to first paint after opening the browser: %.0f ms (%s).\n", (XPLMGetElapsedTime() - showTime) * 1000.0f, prewarmed ? "pre-warmed" : "cold start");
+            }
+        }
+
+        uploader->flush(frameStore->frontPixels(), frameStore->stride());
+    }
+
     XPLMBindTexture2d(textureId, 0);
 
     const auto &tabletDimensions = AppState::getInstance()->tabletDimensions;
@@ -298,6 +497,13 @@ void Browser::draw() {
     if (backButton) {
         backButton->draw();
     }
+
+    if (uploader) {
+        uploader->endFrame();
+        Performance::getInstance()->upload.add(uploader->lastFrameMilliseconds);
+        Performance::getInstance()->uploadCalls.add((float) uploader->lastFrameCalls);
+        Performance::getInstance()->addUploadedBytes(uploader->lastFrameBytes);
+    }
 }
 
 void Browser::mouseMove(float normalizedX, float normalizedY) {
@@ -310,6 +516,12 @@ void Browser::mouseMove(float normalizedX, float normalizedY) {
     }
 
     CefMouseEvent mouseEvent = getMouseEvent(normalizedX, normalizedY);
+    if (mouseEvent.x != lastMouseX || mouseEvent.y != lastMouseY) {
+        lastMouseX = mouseEvent.x;
+        lastMouseY = mouseEvent.y;
+        notifyInput();
+    }
+
     if (leftMouseButtonDown) {
         mouseEvent.modifiers |= EVENTFLAG_LEFT_MOUSE_BUTTON;
     }
@@ -330,6 +542,8 @@ bool Browser::click(XPLMMouseStatus status, float normalizedX, float normalizedY
         return false;
     }
 
+    notifyInput();
+
     if (status == xplm_MouseDown) {
         leftMouseButtonDown = true;
         handler->browserInstance->GetHost()->SendMouseClickEvent(mouseEvent, MBT_LEFT, false, 1);
@@ -354,18 +568,22 @@ void Browser::scroll(float normalizedX, float normalizedY, int clicks, bool hori
         return;
     }
 
+    notifyInput();
     CefMouseEvent mouseEvent = getMouseEvent(normalizedX, normalizedY);
     mouseEvent.modifiers = EVENTFLAG_NONE;
     handler->browserInstance->GetHost()->SendMouseWheelEvent(mouseEvent, horizontal ? clicks : 0, horizontal ? 0 : clicks);
 }
 
 void Browser::loadUrl(std::string url) {
+    currentUrl = url;
+    if (activeTab) {
+        activeTab->url = url;
+    }
+
     if (!textureId || !handler) {
-        currentUrl = url;
         return;
     }
 
-    currentUrl = url;
     if (handler->browserInstance) {
         handler->browserInstance->GetMainFrame()->LoadURL(url);
     }
@@ -396,6 +614,7 @@ void Browser::key(unsigned char key, unsigned char virtualKey, XPLMKeyFlags flag
         return;
     }
 
+    notifyInput();
     CefKeyEvent keyEvent;
     keyEvent.type = (flags == 0 || (flags & xplm_DownFlag) == xplm_DownFlag) ? KEYEVENT_KEYDOWN : KEYEVENT_KEYUP;
 
@@ -575,17 +794,26 @@ bool Browser::createBrowser() {
 
     context_settings.persist_user_preferences = true;
     context_settings.persist_session_cookies = true;
-    CefRefPtr<CefRequestContext> request_context = CefRequestContext::CreateContext(context_settings, nullptr);
+    // All tabs share one request context, so cookies, cache and logins carry over between them.
+    if (!requestContext) {
+        requestContext = CefRequestContext::CreateContext(context_settings, nullptr);
+    }
+
+    governor->reset(XPLMGetElapsedTime());
+    prewarmed = prewarming;
+    measureFirstFrame = true;
+    showTime = 0.0f;
 
     CefBrowserSettings browser_settings;
-    browser_settings.windowless_frame_rate = AppState::getInstance()->config.framerate;
+    browser_settings.windowless_frame_rate = prewarming ? AppState::getInstance()->config.idle_framerate : governor->frameRate;
     browser_settings.background_color = CefColorSetARGB(0xFF, 0xFF, 0xFF, 0xFF);
 
 #if XPLANE_VERSION == 11
     // CEF is not automatically loaded when starting X-Plane 11. Initialize CEF.
-    CefRefPtr<CefApp> app;
+    CefRefPtr<CefApp> app = new MessagePumpApp();
     CefSettings settings;
     settings.windowless_rendering_enabled = true;
+    settings.external_message_pump = true;
     CefString(&settings.cache_path) = cachePath;
 
 #if IBM
@@ -605,15 +833,30 @@ bool Browser::createBrowser() {
     CefMainArgs main_args;
 #endif
 
-    debug("Initializing a new CEF instance for X-Plane 11...\n");
-    if (!CefInitialize(main_args, settings, app, nullptr)) {
-        debug("Could not initialize CEF instance.\n");
-        return false;
+    // CEF can only be initialized once per process, and is never shut down.
+    static bool cefInitialized = false;
+    if (!cefInitialized) {
+        debug("Initializing a new CEF instance for X-Plane 11...\n");
+        if (!CefInitialize(main_args, settings, app, nullptr)) {
+            debug("Could not initialize CEF instance.\n");
+            return false;
+        }
+        cefInitialized = true;
+        debug("CEF instance for X-Plane 11 has been set up successfully.\n");
     }
-    debug("CEF instance for X-Plane 11 has been set up successfully.\n");
 #endif
 
-    handler = CefRefPtr<BrowserHandler>(new BrowserHandler(textureId, &currentUrl, AppState::getInstance()->tabletDimensions.browserWidth, AppState::getInstance()->tabletDimensions.browserHeight));
+    if (!activeTab->frameStore) {
+        activeTab->frameStore = createFrameStore();
+    }
+    frameStore = activeTab->frameStore;
+
+    handler = CefRefPtr<BrowserHandler>(new BrowserHandler(frameStore, &activeTab->url, AppState::getInstance()->tabletDimensions.browserWidth, AppState::getInstance()->tabletDimensions.browserHeight));
+    handler->restoreScrollX = activeTab->scrollX;
+    handler->restoreScrollY = activeTab->scrollY;
+    activeTab->handler = handler;
+    activeTab->scrollX = 0;
+    activeTab->scrollY = 0;
 
     CefWindowInfo window_info;
 #if LIN
@@ -624,7 +867,7 @@ bool Browser::createBrowser() {
     //window_info.shared_texture_enabled
     window_info.windowless_rendering_enabled = true;
 
-    bool browserCreated = CefBrowserHost::CreateBrowser(window_info, handler, currentUrl, browser_settings, nullptr, request_context);
+    bool browserCreated = CefBrowserHost::CreateBrowser(window_info, handler, activeTab->url, browser_settings, nullptr, requestContext);
     if (!browserCreated) {
         AppState::getInstance()->showNotification(new Notification("Error creating browser", "An error occured while starting the browser.\nPlease verify if there are any updates for the " FRIENDLY_NAME " plugin and try again."));
     }
@@ -632,44 +875,209 @@ bool Browser::createBrowser() {
     return true;
 }
 
+FrameStore *Browser::createFrameStore() {
+    return new FrameStore(
+        AppState::getInstance()->tabletDimensions.textureWidth,
+        AppState::getInstance()->tabletDimensions.textureHeight,
+        AppState::getInstance()->tabletDimensions.bytesPerPixel);
+}
+
+BrowserTab *Browser::createTab(std::string key, std::string url) {
+    BrowserTab *tab = new BrowserTab();
+    tab->key = key;
+    tab->url = url;
+    tab->handler = nullptr;
+    tab->frameStore = nullptr;
+    tab->lastUsedTime = XPLMGetElapsedTime();
+    tab->scrollX = 0;
+    tab->scrollY = 0;
+    tabs.push_back(tab);
+
+    return tab;
+}
+
+void Browser::openTab(std::string url) {
+    if (!textureId) {
+        return;
+    }
+
+    auto it = std::find_if(tabs.begin(), tabs.end(), [&url](BrowserTab *tab) { return tab->key == url; });
+    if (it == tabs.end()) {
+        switchToTab(createTab(url, url));
+    } else if (*it == activeTab) {
+        // Opening the visible tab again goes back to its start page.
+        loadUrl(url);
+    } else {
+        switchToTab(*it);
+    }
+}
+
+void Browser::switchToTab(BrowserTab *tab) {
+    if (tab == activeTab) {
+        return;
+    }
+
+    if (handler) {
+        handler->isForeground = false;
+        handler->setFrameStore(nullptr);
+        if (handler->browserInstance) {
+            handler->browserInstance->GetHost()->WasHidden(true);
+        }
+    }
+
+    // Hidden tabs don't paint, so their frame buffers are freed until they are shown again.
+    delete activeTab->frameStore;
+    activeTab->frameStore = nullptr;
+
+    activeTab->lastUsedTime = XPLMGetElapsedTime();
+    tab->lastUsedTime = XPLMGetElapsedTime();
+    activeTab = tab;
+    currentUrl = tab->url;
+    frameStore = nullptr;
+    handler = tab->handler;
+    if (handler && handler->isClosed) {
+        // Closed by the page itself, start over.
+        handler->destroy();
+        handler = nullptr;
+        tab->handler = nullptr;
+    }
+
+    AppState::getInstance()->statusbar->setActiveTab(handler ? handler->title : "");
+    AppState::getInstance()->statusbar->loading = handler && handler->browserInstance && handler->browserInstance->IsLoading();
+
+    if (handler) {
+        // The texture shows the previous tab until the repaint fills the new frame store.
+        tab->frameStore = createFrameStore();
+        frameStore = tab->frameStore;
+        handler->setFrameStore(frameStore);
+        handler->isForeground = true;
+        notifyInput();
+
+        if (AppState::getInstance()->browserVisible && handler->browserInstance) {
+            CefRefPtr<CefBrowserHost> host = handler->browserInstance->GetHost();
+            host->WasHidden(false);
+            host->Invalidate(PET_VIEW);
+            host->SetWindowlessFrameRate(governor->frameRate);
+        }
+    } else if (AppState::getInstance()->browserVisible) {
+        createBrowser();
+    }
+
+    discardTabsOverBudget();
+}
+
+void Browser::discardTab(BrowserTab *tab) {
+    if (!tab->handler || tab == activeTab) {
+        return;
+    }
+
+    debug("Discarding background tab %s (%lld MB estimated).\n", tab->url.c_str(), tabMemoryBytes(tab) / (1024 * 1024));
+    tab->scrollX = tab->handler->scrollX;
+    tab->scrollY = tab->handler->scrollY;
+    tab->handler->setFrameStore(nullptr);
+    if (tab->handler->browserInstance) {
+        // Released once OnBeforeClose has run, so destroy() can wait for it.
+        tab->handler->browserInstance->GetHost()->CloseBrowser(true);
+        closingHandlers.push_back(tab->handler);
+    } else {
+        tab->handler->destroy();
+    }
+    tab->handler = nullptr;
+
+    delete tab->frameStore;
+    tab->frameStore = nullptr;
+}
+
+void Browser::releaseClosedHandlers() {
+    std::erase_if(closingHandlers, [](CefRefPtr<BrowserHandler> &closing) {
+        if (!closing->isClosed) {
+            return false;
+        }
+
+        closing->destroy();
+        return true;
+    });
+}
+
+long long Browser::tabMemoryBytes(BrowserTab *tab) {
+    long long bytes = tab->handler->heapBytes;
+    if (bytes <= 0) {
+        bytes = estimatedTabHeapBytes;
+    }
+
+    if (tab->frameStore) {
+        bytes += tab->frameStore->memoryBytes();
+    }
+
+    return bytes;
+}
+
+void Browser::discardTabsOverBudget() {
+    long long budget = (long long) AppState::getInstance()->config.tab_memory_budget * 1024 * 1024;
+    if (budget <= 0) {
+        return;
+    }
+
+    while (true) {
+        long long total = 0;
+        BrowserTab *leastRecentlyUsed = nullptr;
+        for (BrowserTab *tab : tabs) {
+            if (!tab->handler) {
+                continue;
+            }
+
+            total += tabMemoryBytes(tab);
+            if (tab != activeTab && (!leastRecentlyUsed || tab->lastUsedTime < leastRecentlyUsed->lastUsedTime)) {
+                leastRecentlyUsed = tab;
+            }
+        }
+
+        if (total <= budget || !leastRecentlyUsed) {
+            return;
+        }
+
+        discardTab(leastRecentlyUsed);
+    }
+}
+
 void Browser::updateGPSLocation() {
+    TRACE_SCOPE("Browser::updateGPSLocation");
     if (!handler || !handler->browserInstance) {
         return;
     }
 
-    float latitude = Dataref::getInstance()->get<float>("sim/flightmodel/position/latitude");
-    float longitude = Dataref::getInstance()->get<float>("sim/flightmodel/position/longitude");
-    float speedMetersSecond = Dataref::getInstance()->get<float>("sim/flightmodel/position/groundspeed");
-    float altitudeMetersAboveSeaLevel = Dataref::getInstance()->get<float>("sim/flightmodel/position/elevation");
-    float magneticHeading = Dataref::getInstance()->get<float>("sim/flightmodel/position/mag_psi");
-
-    float windDirection = Dataref::getInstance()->get<float>("sim/weather/wind_direction_degt");
-    float windSpeed = Dataref::getInstance()->get<float>("sim/weather/wind_speed_kt");
-
-    float altitudeMetersAboveGroundLevel = Dataref::getInstance()->get<float>("sim/flightmodel/position/y_agl");
-    float airspeedKts = Dataref::getInstance()->get<float>("sim/flightmodel/position/indicated_airspeed");
-
-    std::stringstream stream;
-    stream << "window.avitab_location = { ";
-    stream << "coords: { ";
-    stream << "latitude: " << std::fixed << std::setprecision(6) << latitude << ", ";
-    stream << "longitude: " << std::fixed << std::setprecision(6) << longitude << ", ";
-    stream << "accuracy: 10, ";
-    stream << "altitude: " << std::fixed << std::setprecision(0) << altitudeMetersAboveSeaLevel << ", ";
-    stream << "altitudeAccuracy: 10, ";
-    stream << "heading: " << std::fixed << std::setprecision(0) << magneticHeading << ", ";
-    stream << "speed: " << std::fixed << std::setprecision(0) << speedMetersSecond << ", ";
-    stream << "}, ";
-    stream << "wind: { ";
-    stream << "direction: " << std::fixed << std::setprecision(0) << windDirection << ", ";
-    stream << "speedKts: " << std::fixed << std::setprecision(0) << windSpeed << ", ";
-    stream << "}, ";
-    stream << "extra: { ";
-    stream << "altitudeAgl: " << std::fixed << std::setprecision(0) << altitudeMetersAboveGroundLevel << ", ";
-    stream << "airspeedKts: " << std::fixed << std::setprecision(0) << airspeedKts << ", ";
-    stream << "}, timestamp: Date.now() }; for (let key in window.avitab_watchers) { window.avitab_watchers[key](window.avitab_location); }";
-
-    handler->browserInstance->GetMainFrame()->ExecuteJavaScript(stream.str(), handler->browserInstance->GetMainFrame()->GetURL(), 0);
+    float latitude = Dataref::getInstance()->get<float>(latitudeRef);
+    float longitude = Dataref::getInstance()->get<float>(longitudeRef);
+    float speedMetersSecond = Dataref::getInstance()->get<float>(groundspeedRef);
+    float altitudeMetersAboveSeaLevel = Dataref::getInstance()->get<float>(elevationRef);
+    float magneticHeading = Dataref::getInstance()->get<float>(magneticHeadingRef);
+
+    float windDirection = Dataref::getInstance()->get<float>(windDirectionRef);
+    float windSpeed = Dataref::getInstance()->get<float>(windSpeedRef);
+
+    float altitudeMetersAboveGroundLevel = Dataref::getInstance()->get<float>(heightAboveGroundRef);
+    float airspeedKts = Dataref::getInstance()->get<float>(indicatedAirspeedRef);
+    float track = Dataref::getInstance()->get<float>(trackRef);
+
+    GeolocationChannel::getInstance()->publish({
+        latitude,
+        longitude,
+        altitudeMetersAboveSeaLevel,
+        magneticHeading,
+        speedMetersSecond,
+        windDirection,
+        windSpeed,
+        altitudeMetersAboveGroundLevel,
+        airspeedKts,
+        track,
+    });
+
+    // Pages whose CSP blocks the channel get the sample as a (tiny) script instead, at most once per second.
+    if (!GeolocationChannel::getInstance()->isPulled() && XPLMGetElapsedTime() > lastGpsFallbackTime + 1.0f) {
+        handler->browserInstance->GetMainFrame()->ExecuteJavaScript(GeolocationChannel::getInstance()->fallbackScript(), handler->browserInstance->GetMainFrame()->GetURL(), 0);
+        lastGpsFallbackTime = XPLMGetElapsedTime();
+    }
+
     lastGpsUpdateTime = XPLMGetElapsedTime();
 }
 
@@ -681,3 +1089,10 @@ CefMouseEvent Browser::getMouseEvent(float normalizedX, float normalizedY) {
     mouseEvent.y = tabletDimensions.browserHeight * (1.0f - ((normalizedY - offsetStart) / (offsetEnd - offsetStart)));
     return mouseEvent;
 }
+
+void Browser::notifyInput() {
+    MessagePump::getInstance()->notifyInput();
+    if (governor) {
+        governor->notifyInput(XPLMGetElapsedTime());
+    }
+}
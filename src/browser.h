@@ -3,23 +3,63 @@
 
 #include "browser_handler.h"
 #include "button.h"
+#include "frame_rate_governor.h"
+#include "frame_store.h"
+#include "texture_uploader.h"
 
 #include <include/cef_app.h>
+#include <string>
+#include <vector>
 #include <XPLMDefs.h>
 #include <XPLMDisplay.h>
 
+// A persistent page, kept alive in the background while another tab is shown.
+// Only the visible tab has a frame store. Discarded tabs have no handler either, but remember where they were.
+struct BrowserTab {
+        std::string key;
+        std::string url;
+        CefRefPtr<BrowserHandler> handler;
+        FrameStore *frameStore;
+        float lastUsedTime;
+        int scrollX;
+        int scrollY;
+};
+
 class Browser {
     private:
         int textureId;
+        TextureUploader *uploader;
+        FrameStore *frameStore;
+        FrameRateGovernor *governor;
+        std::vector<BrowserTab *> tabs;
+        std::vector<CefRefPtr<BrowserHandler>> closingHandlers;
+        BrowserTab *activeTab;
+        CefRefPtr<CefRequestContext> requestContext;
+        float lastTabBudgetTime;
         float offsetStart;
         float offsetEnd;
         float lastGpsUpdateTime;
+        float lastGpsFallbackTime;
+        int lastMouseX;
+        int lastMouseY;
         Button *backButton;
         CefRefPtr<BrowserHandler> handler;
         bool leftMouseButtonDown;
+        bool prewarming;
+        bool prewarmed;
+        bool measureFirstFrame;
+        float showTime;
         bool createBrowser();
+        FrameStore *createFrameStore();
+        BrowserTab *createTab(std::string key, std::string url);
+        void switchToTab(BrowserTab *tab);
+        void discardTab(BrowserTab *tab);
+        void discardTabsOverBudget();
+        void releaseClosedHandlers();
+        long long tabMemoryBytes(BrowserTab *tab);
         void updateGPSLocation();
         CefMouseEvent getMouseEvent(float normalizedX, float normalizedY);
+        void notifyInput();
 
     public:
         Browser();
@@ -28,11 +68,15 @@ class Browser {
 
         void initialize();
         void destroy();
+        void prewarm();
+        bool isPrewarming();
+        bool hasPage();
         void resetHandler();
         void visibilityWillChange(bool becomesVisible);
         void update();
         void draw();
         void loadUrl(std::string url);
+        void openTab(std::string url);
         bool hasInputFocus();
         void setFocus(bool focus);
         void mouseMove(float normalizedX, float normalizedY);
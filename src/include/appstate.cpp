@@ -6,21 +6,40 @@
 #include "INIReader.h"
 #include "path.h"
 #include "config.h"
+#include "asset_cache.h"
 #include "dataref.h"
+#include "message_pump.h"
+#include "performance.h"
 #include "json.hpp"
 #include <iostream>
 #include <cmath>
 #include <regex>
+#include <ctime>
+#include <algorithm>
+#include <iterator>
 #include "json.hpp"
 #include <curl/curl.h>
 
+static const DatarefKey b738TabPowerRef("laminar/B738/tab/power");
+static const DatarefKey b738TabBootActiveRef("laminar/B738/tab/boot_active");
+static const DatarefKey b738TabMenuPageRef("laminar/B738/tab/menu_page");
+static const DatarefKey b738TabNightModeRef("laminar/B738/tab/efb_night_mode");
+static const DatarefKey avitabPanelEnabledRef("avitab/panel_enabled");
+static const DatarefKey avitabPanelPoweredRef("avitab/panel_powered");
+static const DatarefKey avitabIsInMenuRef("avitab/is_in_menu");
+static const DatarefKey avitabBrightnessRef("avitab/brightness");
+static const DatarefKey thrandaAvitabSwapRef("thranda/avitab/aviTabSwap");
+static const DatarefKey ixegShowAvitabRef("ixeg/733/misc/show_avitab");
+
 AppState* AppState::instance = nullptr;
 
 AppState::AppState() {
     remoteVersion = "";
+    versionCheckAborted = false;
     shouldBrowserVisible = false;
     notification = nullptr;
     mainMenuButton = nullptr;
+    pixelScaleMeasured = false;
     aircraftVariant = VariantUnknown;
     pluginInitialized = false;
     shouldCaptureClickEvents = false;
@@ -72,6 +91,8 @@ bool AppState::initialize() {
     
     determineAircraftVariant();
     
+    pixelScaleMeasured = false;
+    Performance::getInstance()->initialize();
     statusbar->initialize();
     browser->initialize();
     
@@ -116,11 +137,12 @@ bool AppState::initialize() {
     
     if (aircraftVariant == VariantIXEG737) {
         Dataref::getInstance()->monitorExistingDataref<int>("avitab/is_in_menu", [this](int isInMenu) {
-            Dataref::getInstance()->set<int>("avitab/panel_enabled", (shouldBrowserVisible || browserVisible) && !isInMenu ? 0 : 1);
+            Dataref::getInstance()->set<int>(avitabPanelEnabledRef, (shouldBrowserVisible || browserVisible) && !isInMenu ? 0 : 1);
         });
     }
     
     pluginInitialized = true;
+    browser->prewarm();
     return true;
 }
 
@@ -131,6 +153,12 @@ void AppState::deinitialize() {
     
     Dataref::getInstance()->destroyAllBindings();
     
+    if (versionCheckThread.joinable()) {
+        // Cut a slow or hanging fetch short instead of waiting for its timeout.
+        versionCheckAborted = true;
+        versionCheckThread.join();
+    }
+    
     tasks.clear();
     buttons.clear();
     notification = nullptr;
@@ -146,14 +174,45 @@ void AppState::deinitialize() {
 }
 
 void AppState::checkLatestVersion() {
-    if (!remoteVersion.empty()) {
-        // Version information was already fetched. Only check once per session.
+    if (!remoteVersion.empty() || versionCheckThread.joinable()) {
+        // Version information was already fetched, or is being fetched. Only check once per session.
+        return;
+    }
+    
+    std::string cachedTag;
+    if (readCachedVersionTag(cachedTag)) {
+        handleLatestVersion(cachedTag);
         return;
     }
     
+    // Never block the sim thread on the network. The result is handed back through the task queue.
+    versionCheckAborted = false;
+    versionCheckThread = std::thread([this]() {
+        std::string error;
+        std::string tag = fetchLatestVersionTag(VERSION_CHECK_URL, versionCheckAborted, error);
+        if (versionCheckAborted) {
+            return;
+        }
+        
+        if (!tag.empty()) {
+            writeCachedVersionTag(tag);
+        }
+        
+        executeDelayed([this, tag, error]() {
+            handleLatestVersion(tag, error);
+        }, 0);
+    });
+}
+
+std::string AppState::fetchLatestVersionTag(std::string url, const std::atomic<bool> &aborted, std::string &error) {
     std::string response;
     CURL* curl = curl_easy_init();
-    curl_easy_setopt(curl, CURLOPT_URL, VERSION_CHECK_URL);
+    if (!curl) {
+        error = "Could not initialize curl";
+        return "";
+    }
+    
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, +[](void* contents, size_t size, size_t nmemb, std::string* userp) {
         userp->append((char*)contents, size * nmemb);
         return size * nmemb;
@@ -162,11 +221,20 @@ void AppState::checkLatestVersion() {
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
     curl_easy_setopt(curl, CURLOPT_USERAGENT, "Mozilla/5.0");
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, (long)VERSION_CHECK_TIMEOUT_SECONDS);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, (long)VERSION_CHECK_TIMEOUT_SECONDS);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, +[](void* clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow) {
+        return ((const std::atomic<bool> *)clientp)->load() ? 1 : 0;
+    });
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &aborted);
     CURLcode status = curl_easy_perform(curl);
+    curl_easy_cleanup(curl);
     if (status != CURLE_OK) {
-        debug("Version fetch failed: %s\n", curl_easy_strerror(status));
+        error = std::string("Version fetch failed: ") + curl_easy_strerror(status);
+        return "";
     }
-    curl_easy_cleanup(curl);
 
     try {
         std::string tag = nlohmann::json::parse(response)[0]["tag_name"];
@@ -174,7 +242,58 @@ void AppState::checkLatestVersion() {
             tag = tag.substr(1);
         }
         
-        remoteVersion = tag;
+        return tag;
+    } catch (const std::exception& e) {
+        error = std::string("Could not parse latest version information from GitHub. Reason: ") + e.what();
+        return "";
+    }
+}
+
+bool AppState::readCachedVersionTag(std::string &tag) {
+    std::ifstream file(Path::getInstance()->pluginDirectory + "/version_cache.json");
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    try {
+        nlohmann::json cache = nlohmann::json::parse(file);
+        long long fetchedAt = cache["fetched_at"].get<long long>();
+        if (std::time(nullptr) - fetchedAt > VERSION_CHECK_CACHE_SECONDS) {
+            return false;
+        }
+        
+        tag = cache["tag"].get<std::string>();
+        return !tag.empty();
+    } catch (const std::exception& e) {
+        return false;
+    }
+}
+
+void AppState::writeCachedVersionTag(std::string tag) {
+    nlohmann::json cache = {
+        {"tag", tag},
+        {"fetched_at", (long long)std::time(nullptr)}
+    };
+    
+    std::ofstream file(Path::getInstance()->pluginDirectory + "/version_cache.json");
+    if (file.is_open()) {
+        file << cache.dump();
+    }
+}
+
+void AppState::handleLatestVersion(std::string tag, std::string error) {
+    if (!error.empty()) {
+        debug("%s\n", error.c_str());
+    }
+    
+    if (tag.empty()) {
+        // Assume we're on the latest version to prevent refetching
+        remoteVersion = VERSION;
+        return;
+    }
+    
+    remoteVersion = tag;
+    try {
         std::string cleanedRemote = std::regex_replace(tag, std::regex("[^0-9]"), "");
         std::string cleanedLocal = std::regex_replace(VERSION, std::regex("[^0-9]"), "");
         int remoteVersionNumber = std::stoi(cleanedRemote);
@@ -185,9 +304,7 @@ void AppState::checkLatestVersion() {
             showNotification(new Notification("Update available", description));
         }
     } catch (const std::exception& e) {
-        debug("Could not fetch latest version information from GitHub. Reason: %s\n", e.what());
-        // Assume we're on the latest version to prevent refetching
-        remoteVersion = VERSION;
+        debug("Could not compare version information. Reason: %s\n", e.what());
     }
 }
 
@@ -198,52 +315,52 @@ void AppState::update() {
     
     bool canBrowserVisible = false;
     if (aircraftVariant == VariantZibo738 || aircraftVariant == VariantLevelUp737) {
-        hasPower = Dataref::getInstance()->getCached<int>("laminar/B738/tab/power") == 1 && Dataref::getInstance()->getCached<int>("laminar/B738/tab/boot_active") == 0;
-        canBrowserVisible = hasPower && Dataref::getInstance()->getCached<int>("laminar/B738/tab/menu_page") == 8;
+        hasPower = Dataref::getInstance()->getCached<int>(b738TabPowerRef) == 1 && Dataref::getInstance()->getCached<int>(b738TabBootActiveRef) == 0;
+        canBrowserVisible = hasPower && Dataref::getInstance()->getCached<int>(b738TabMenuPageRef) == 8;
 
-        brightness = aircraftVariant == VariantZibo738 && Dataref::getInstance()->getCached<int>("laminar/B738/tab/efb_night_mode") ? 0.5f : 1.0f;
-        mainMenuButton->visible = (Dataref::getInstance()->getCached<int>("laminar/B738/tab/menu_page") == 11 && !Dataref::getInstance()->getCached<int>("avitab/panel_enabled"));
+        brightness = aircraftVariant == VariantZibo738 && Dataref::getInstance()->getCached<int>(b738TabNightModeRef) ? 0.5f : 1.0f;
+        mainMenuButton->visible = (Dataref::getInstance()->getCached<int>(b738TabMenuPageRef) == 11 && !Dataref::getInstance()->getCached<int>(avitabPanelEnabledRef));
     }
     else if (aircraftVariant == VariantFelis742) {
-        hasPower = Dataref::getInstance()->getCached<int>("avitab/panel_powered") && Dataref::getInstance()->getCached<int>("avitab/panel_enabled");
-        canBrowserVisible = hasPower && Dataref::getInstance()->getCached<int>("avitab/is_in_menu") == 0;
+        hasPower = Dataref::getInstance()->getCached<int>(avitabPanelPoweredRef) && Dataref::getInstance()->getCached<int>(avitabPanelEnabledRef);
+        canBrowserVisible = hasPower && Dataref::getInstance()->getCached<int>(avitabIsInMenuRef) == 0;
         
-        brightness = fmin(1.0f, fmax(0.0f, Dataref::getInstance()->getCached<float>("avitab/brightness")));
-        mainMenuButton->visible = hasPower && Dataref::getInstance()->getCached<int>("avitab/panel_enabled") && Dataref::getInstance()->getCached<int>("avitab/is_in_menu");
+        brightness = fmin(1.0f, fmax(0.0f, Dataref::getInstance()->getCached<float>(avitabBrightnessRef)));
+        mainMenuButton->visible = hasPower && Dataref::getInstance()->getCached<int>(avitabPanelEnabledRef) && Dataref::getInstance()->getCached<int>(avitabIsInMenuRef);
     }
     else if (aircraftVariant == VariantJustFlight) {
         bool hadPower = hasPower;
-        hasPower = Dataref::getInstance()->getCached<int>("avitab/panel_powered") && Dataref::getInstance()->getCached<int>("avitab/panel_enabled") && Dataref::getInstance()->getCached<int>("thranda/avitab/aviTabSwap");
-        canBrowserVisible = hasPower && Dataref::getInstance()->getCached<int>("avitab/is_in_menu") == 0;
+        hasPower = Dataref::getInstance()->getCached<int>(avitabPanelPoweredRef) && Dataref::getInstance()->getCached<int>(avitabPanelEnabledRef) && Dataref::getInstance()->getCached<int>(thrandaAvitabSwapRef);
+        canBrowserVisible = hasPower && Dataref::getInstance()->getCached<int>(avitabIsInMenuRef) == 0;
         
         if (!hadPower && hasPower) {
             // The Duchess creates a window to capture clicks whenever AviTab is opened. We want to be on top of that window.
             XPLMBringWindowToFront(mainWindow);
         }
         
-        brightness = fmin(1.0f, fmax(0.0f, Dataref::getInstance()->getCached<float>("avitab/brightness")));
-        mainMenuButton->visible = AppState::getInstance()->hasPower && Dataref::getInstance()->getCached<int>("avitab/is_in_menu");
+        brightness = fmin(1.0f, fmax(0.0f, Dataref::getInstance()->getCached<float>(avitabBrightnessRef)));
+        mainMenuButton->visible = AppState::getInstance()->hasPower && Dataref::getInstance()->getCached<int>(avitabIsInMenuRef);
     }
     else if (aircraftVariant == VariantIXEG737) {
-        hasPower = Dataref::getInstance()->getCached<int>("avitab/panel_powered") && Dataref::getInstance()->getCached<int>("ixeg/733/misc/show_avitab");
-        canBrowserVisible = hasPower && Dataref::getInstance()->getCached<int>("avitab/is_in_menu") == 0;
+        hasPower = Dataref::getInstance()->getCached<int>(avitabPanelPoweredRef) && Dataref::getInstance()->getCached<int>(ixegShowAvitabRef);
+        canBrowserVisible = hasPower && Dataref::getInstance()->getCached<int>(avitabIsInMenuRef) == 0;
         
-        brightness = fmin(1.0f, fmax(0.0f, Dataref::getInstance()->getCached<float>("avitab/brightness")));
-        mainMenuButton->visible = AppState::getInstance()->hasPower && Dataref::getInstance()->getCached<int>("avitab/is_in_menu");
+        brightness = fmin(1.0f, fmax(0.0f, Dataref::getInstance()->getCached<float>(avitabBrightnessRef)));
+        mainMenuButton->visible = AppState::getInstance()->hasPower && Dataref::getInstance()->getCached<int>(avitabIsInMenuRef);
     }
     else {
-        hasPower = Dataref::getInstance()->getCached<int>("avitab/panel_powered") && Dataref::getInstance()->getCached<int>("avitab/panel_enabled");
-        canBrowserVisible = hasPower && Dataref::getInstance()->getCached<int>("avitab/is_in_menu") == 0;
+        hasPower = Dataref::getInstance()->getCached<int>(avitabPanelPoweredRef) && Dataref::getInstance()->getCached<int>(avitabPanelEnabledRef);
+        canBrowserVisible = hasPower && Dataref::getInstance()->getCached<int>(avitabIsInMenuRef) == 0;
         
-        brightness = fmin(1.0f, fmax(0.0f, Dataref::getInstance()->getCached<float>("avitab/brightness")));
-        mainMenuButton->visible = AppState::getInstance()->hasPower && Dataref::getInstance()->getCached<int>("avitab/is_in_menu");
+        brightness = fmin(1.0f, fmax(0.0f, Dataref::getInstance()->getCached<float>(avitabBrightnessRef)));
+        mainMenuButton->visible = AppState::getInstance()->hasPower && Dataref::getInstance()->getCached<int>(avitabIsInMenuRef);
     }
     
     if (browserVisible && !canBrowserVisible) {
         browser->visibilityWillChange(false);
         browserVisible = false;
         
-        if (!hasPower && Dataref::getInstance()->getCached<int>("avitab/is_in_menu") == 0) {
+        if (!hasPower && Dataref::getInstance()->getCached<int>(avitabIsInMenuRef) == 0) {
             Dataref::getInstance()->executeCommand("AviTab/Home");
         }
     }
@@ -258,17 +375,21 @@ void AppState::update() {
         notification->update();
     }
     
-    tasks.erase(
-        std::remove_if(tasks.begin(), tasks.end(), [&](const DelayedTask& task) {
-            if (XPLMGetElapsedTime() > task.executeAfterElapsedSeconds) {
-                task.func();
-                return true;
-            }
-            
-            return false;
-        }),
-        tasks.end()
-    );
+    std::vector<DelayedTask> dueTasks;
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex);
+        float elapsedTime = XPLMGetElapsedTime();
+        auto firstDue = std::stable_partition(tasks.begin(), tasks.end(), [&](const DelayedTask& task) {
+            return elapsedTime <= task.executeAfterElapsedSeconds;
+        });
+        dueTasks.assign(std::make_move_iterator(firstDue), std::make_move_iterator(tasks.end()));
+        tasks.erase(firstDue, tasks.end());
+    }
+    
+    // Run outside the lock, tasks may schedule new tasks.
+    for (const auto& task : dueTasks) {
+        task.func();
+    }
 }
 
 void AppState::draw() {
@@ -276,6 +397,21 @@ void AppState::draw() {
         return;
     }
     
+    PerformanceTimer timer(Performance::getInstance()->draw);
+    AssetCache::getInstance()->update();
+    
+    if (!pixelScaleMeasured) {
+        // Only known once we draw; the statusbar icons were rasterized before that.
+        pixelScaleMeasured = true;
+        float measured = measurePixelScale();
+        if (std::fabs(measured - pixelScale) > 0.05f) {
+            debug("The tablet is drawn at %.2f pixels per unit, rasterizing the statusbar icons again.\n", measured);
+            pixelScale = measured;
+            statusbar->destroy();
+            statusbar->initialize();
+        }
+    }
+    
     if (aircraftVariant == VariantIXEG737 && browserVisible) {
         XPLMSetGraphicsState(
                              0, // No fog, equivalent to glDisable(GL_FOG);
@@ -314,6 +450,25 @@ void AppState::draw() {
     }
 }
 
+float AppState::measurePixelScale() {
+    GLfloat modelview[16];
+    GLfloat projection[16];
+    GLint viewport[4];
+    glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
+    glGetFloatv(GL_PROJECTION_MATRIX, projection);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    
+    // Length of one horizontal tablet unit in viewport pixels: the x axis through both matrices.
+    float clipX = projection[0] * modelview[0] + projection[4] * modelview[1] + projection[8] * modelview[2] + projection[12] * modelview[3];
+    float clipY = projection[1] * modelview[0] + projection[5] * modelview[1] + projection[9] * modelview[2] + projection[13] * modelview[3];
+    float scale = std::hypot(clipX * viewport[2] / 2.0f, clipY * viewport[3] / 2.0f);
+    if (!std::isfinite(scale) || scale <= 0.0f) {
+        return 1.0f;
+    }
+    
+    return std::clamp(scale, 0.5f, 4.0f);
+}
+
 bool AppState::updateButtons(float normalizedX, float normalizedY, ButtonState state) {
     bool didAct = false;
     for (const auto& button : buttons) {
@@ -348,13 +503,25 @@ void AppState::showBrowser(std::string url) {
             Dataref::getInstance()->executeCommand("AviTab/app_about");
         }
         shouldBrowserVisible = true;
+        MessagePump::getInstance()->wake();
     }
     
     if (!url.empty()) {
-        browser->loadUrl(url);
+        browser->openTab(url);
     }
 }
 
+float AppState::tabletPollInterval() {
+    if (shouldBrowserVisible) {
+        // Waiting for the tablet to switch to our page.
+        return -1.0f;
+    }
+    
+    // Power, page and menu state are only polled in update(), and the statusbar should follow them
+    // promptly even while the tablet is off. Only the CEF pumping backs off further.
+    return REFRESH_INTERVAL_SECONDS_TABLET;
+}
+
 void AppState::hideBrowser() {
     if (!hasPower || !browserVisible) {
         return;
@@ -377,9 +544,13 @@ void AppState::showNotification(Notification *aNotification) {
 }
 
 void AppState::executeDelayed(CallbackFunc func, float delaySeconds) {
+    // A zero delay runs on the next update() and skips the XPLM call, so background threads can use it too.
+    float executeAfterElapsedSeconds = delaySeconds > 0 ? XPLMGetElapsedTime() + delaySeconds : 0.0f;
+    
+    std::lock_guard<std::mutex> lock(tasksMutex);
     tasks.push_back({
         func,
-        XPLMGetElapsedTime() + delaySeconds
+        executeAfterElapsedSeconds
     });
 }
 
@@ -421,6 +592,28 @@ hide_addressbar=
 # The browser will still sleep / idle when able or not visible.
 # Leave empty for default framerate.
 framerate=
+# idle_framerate: The number of frames per second to render the browser when the page is idle.
+# The browser speeds up to framerate as soon as you interact with it or the page animates. The default value is 2.
+idle_framerate=
+# mute_when_hidden: Whether web pages should be muted while the browser is hidden or the tablet is off. Default is false.
+mute_when_hidden=
+# prewarm: Whether the browser should load the homepage in the background when the aircraft loads.
+# Makes the browser open faster the first time, at the cost of some memory and CPU while loading. Default is false.
+prewarm=
+# tab_memory_budget: Each statusbar bookmark keeps its own tab alive in the background.
+# When the tabs together use more memory than this (in MB), the least recently used ones are closed.
+# They are reloaded, at the same scroll position, when opened again. Set to 0 to never close tabs. The default value is 512.
+tab_memory_budget=
+# upload_budget: The maximum amount of pixel data (in KB) uploaded to the GPU per sim frame.
+# Updates that don't fit are carried over to the next frame. Lower values smooth out stutters on slow GPUs.
+# Leave empty or set to 0 for no limit.
+upload_budget=
+# geolocation_rate: How many times per second the aircraft position is sent to web pages, from 1 to 20.
+# Higher values make moving maps smoother. The default value is 1.
+geolocation_rate=
+# geolocation_interpolation: Whether web pages should move the aircraft position along its track between updates.
+# Makes moving maps animate smoothly, even with a low geolocation_rate. Default is false.
+geolocation_interpolation=
 
 # Statusbar: Define up to 5 bookmarks for easy access.
 # Use icon_<index> and url_<index> for each icon.
@@ -437,6 +630,22 @@ icon_4=
 url_4=
 icon_5=
 url_5=
+
+# Offline cache: Responses matching these URL patterns are kept on disk and served from there,
+# so the pages keep working without a connection. They are refreshed in the background when online.
+# Use * as a wildcard, e.g. pattern_1=https://dispatch.simbrief.com/*. Define up to 10 patterns.
+[offline_cache]
+pattern_1=
+pattern_2=
+pattern_3=
+
+# Request headers: Extra headers sent with every request, written as Name: value, e.g. header_1=Accept-Language: nl-NL.
+# Put a domain in front to only send the header to that domain and its subdomains, e.g. header_2=example.com User-Agent: Mozilla/5.0 ...
+# A header for a domain overrides the same header for all domains, including user_agent. Define up to 10 headers.
+[request_headers]
+header_1=
+header_2=
+header_3=
 )";
         
         std::ofstream fileOutputHandle(filename);
@@ -463,6 +672,13 @@ url_5=
     config.user_agent = reader.GetString("browser", "user_agent", "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/117.2.5.0 Safari/537.36");
     config.hide_addressbar = reader.GetBoolean("browser", "hide_addressbar", false);
     config.framerate = reader.GetInteger("browser", "framerate", 25);
+    config.idle_framerate = std::clamp((int)reader.GetInteger("browser", "idle_framerate", 2), 1, (int)std::max(config.framerate, (unsigned char)1));
+    config.mute_when_hidden = reader.GetBoolean("browser", "mute_when_hidden", false);
+    config.prewarm = reader.GetBoolean("browser", "prewarm", false);
+    config.tab_memory_budget = reader.GetInteger("browser", "tab_memory_budget", 512);
+    config.upload_budget = reader.GetInteger("browser", "upload_budget", 0);
+    config.geolocation_rate = std::clamp((int)reader.GetInteger("browser", "geolocation_rate", 1), 1, 20);
+    config.geolocation_interpolation = reader.GetBoolean("browser", "geolocation_interpolation", false);
     
     config.statusbarIcons.clear();
     
@@ -482,6 +698,22 @@ url_5=
         }
     }
     
+    config.offline_cache_patterns.clear();
+    for (int i = 1; i <= 10; ++i) {
+        std::string pattern = reader.Get("offline_cache", "pattern_" + std::to_string(i), "");
+        if (!pattern.empty()) {
+            config.offline_cache_patterns.push_back(pattern);
+        }
+    }
+    
+    config.request_headers.clear();
+    for (int i = 1; i <= 10; ++i) {
+        std::string header = reader.Get("request_headers", "header_" + std::to_string(i), "");
+        if (!header.empty()) {
+            config.request_headers.push_back(header);
+        }
+    }
+    
     if (!loadAvitabConfig()) {
         debug("Could not find AviTab.json config file in aircraft directory, or the JSON file is malformed. Not loading the plugin for this aircraft.\n");
         return false;
@@ -1,7 +1,10 @@
 #ifndef APPSTATE_H
 #define APPSTATE_H
 
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <XPLMDisplay.h>
 #include "button.h"
@@ -30,11 +33,20 @@ struct AppConfiguration {
     std::string user_agent;
     bool hide_addressbar;
     unsigned char framerate;
+    unsigned char idle_framerate;
+    bool mute_when_hidden;
+    bool prewarm;
+    unsigned int tab_memory_budget;
+    unsigned int upload_budget;
+    unsigned char geolocation_rate;
+    bool geolocation_interpolation;
     struct StatusBarIcon {
         std::string icon;
         std::string url;
     };
     std::vector<StatusBarIcon> statusbarIcons;
+    std::vector<std::string> offline_cache_patterns;
+    std::vector<std::string> request_headers;
 #if DEBUG
     float debug_value_1;
     float debug_value_2;
@@ -66,12 +78,20 @@ private:
     std::string remoteVersion;
     bool shouldBrowserVisible;
     std::vector<DelayedTask> tasks;
+    std::mutex tasksMutex;
+    std::thread versionCheckThread;
+    std::atomic<bool> versionCheckAborted;
     std::vector<Button *> buttons;
     Notification *notification;
     Button *mainMenuButton;
+    bool pixelScaleMeasured;
     bool loadAvitabConfig();
+    float measurePixelScale();
     bool fileExists(std::string filename);
     void determineAircraftVariant();
+    bool readCachedVersionTag(std::string &tag);
+    void writeCachedVersionTag(std::string tag);
+    void handleLatestVersion(std::string tag, std::string error = "");
 
 public:
     XPLMWindowID mainWindow;
@@ -83,14 +103,19 @@ public:
     bool shouldCaptureClickEvents = false;
     bool hasPower = false;
     bool browserVisible = false;
+    // Pixels per tablet unit where the tablet is drawn; vector icons are rasterized at this density.
+    float pixelScale = 1.0f;
     Statusbar *statusbar;
     Browser *browser;
     CursorType activeCursor;
     
     static AppState* getInstance();
+    // Runs on the version check thread, so failures are returned in error instead of logged.
+    static std::string fetchLatestVersionTag(std::string url, const std::atomic<bool> &aborted, std::string &error);
     bool initialize();
     void deinitialize();
     void checkLatestVersion();
+    float tabletPollInterval();
     
     void update();
     void draw();
@@ -6,55 +6,91 @@
 
 #include "appstate.h"
 #include "config.h"
+#include "geolocation_channel.h"
+#include "message_pump.h"
+#include "offline_cache.h"
 #include "path.h"
+#include "performance.h"
+#include "request_filter.h"
+#include "request_headers.h"
+#include "trace.h"
 
 #include <cmath>
 #include <include/base/cef_callback.h>
 #include <include/cef_app.h>
 #include <include/cef_base.h>
 #include <include/cef_parser.h>
+#include <include/cef_stream.h>
 #include <include/views/cef_browser_view.h>
 #include <include/views/cef_window.h>
 #include <include/wrapper/cef_closure_task.h>
 #include <include/wrapper/cef_helpers.h>
+#include <include/wrapper/cef_stream_resource_handler.h>
 #include <sstream>
 #include <string>
 #include <XPLMGraphics.h>
 #include <XPLMProcessing.h>
 #include <XPLMUtilities.h>
 
-BrowserHandler::BrowserHandler(int aTextureId, std::string *aCurrentUrl, unsigned short aWidth, unsigned short aHeight) {
-    textureId = aTextureId;
+BrowserHandler::BrowserHandler(FrameStore *aFrameStore, std::string *aCurrentUrl, unsigned short aWidth, unsigned short aHeight) {
+    frameStore = aFrameStore;
     popupRect = {0, 0, 0, 0};
     popupShown = false;
+    needsFullDraw = false;
     currentUrl = aCurrentUrl;
     windowWidth = aWidth;
     windowHeight = aHeight;
     cursorState = CursorDefault;
     hasInputFocus = false;
+    hasPainted = false;
+    isForeground = true;
+    isClosed = false;
+    title = "";
+    heapBytes = 0;
+    scrollX = 0;
+    scrollY = 0;
+    restoreScrollX = 0;
+    restoreScrollY = 0;
     browserInstance = nullptr;
+    createdTime = std::chrono::steady_clock::now();
 }
 
 BrowserHandler::~BrowserHandler() {
-    textureId = 0;
+    frameStore = nullptr;
     browserInstance = nullptr;
     cursorState = CursorDefault;
     hasInputFocus = false;
 }
 
 void BrowserHandler::destroy() {
-    textureId = 0;
+    frameStore = nullptr;
+    currentUrl = nullptr;
     cursorState = CursorDefault;
     hasInputFocus = false;
 }
 
+void BrowserHandler::setFrameStore(FrameStore *aFrameStore) {
+    frameStore = aFrameStore;
+    // A new frame store starts out empty, so the next paint has to fill all of it.
+    needsFullDraw = aFrameStore != nullptr;
+}
+
 void BrowserHandler::OnAfterCreated(CefRefPtr<CefBrowser> browser) {
     browserInstance = browser;
     browserInstance->GetHost()->SetAudioMuted(AppState::getInstance()->config.audio_muted);
+    if (!isForeground) {
+        // The tab was switched away from while the browser was being created.
+        browserInstance->GetHost()->WasHidden(true);
+    }
 }
 
 bool BrowserHandler::DoClose(CefRefPtr<CefBrowser> browser) {
-    textureId = 0;
+    frameStore = nullptr;
+
+    if (!isForeground) {
+        // Background tabs are closed when they are discarded, the visible tab is left alone.
+        return false;
+    }
 
     if (AppState::getInstance()->statusbar) {
         AppState::getInstance()->statusbar->setActiveTab("");
@@ -66,10 +102,11 @@ bool BrowserHandler::DoClose(CefRefPtr<CefBrowser> browser) {
 }
 
 void BrowserHandler::OnBeforeClose(CefRefPtr<CefBrowser> browser) {
-    textureId = 0;
+    frameStore = nullptr;
     browserInstance = nullptr;
+    isClosed = true;
 
-    if (AppState::getInstance()->statusbar) {
+    if (isForeground && AppState::getInstance()->statusbar) {
         AppState::getInstance()->statusbar->setActiveTab("");
     }
 }
@@ -101,56 +138,44 @@ void BrowserHandler::GetViewRect(CefRefPtr<CefBrowser> browser, CefRect &rect) {
 }
 
 void BrowserHandler::OnTitleChange(CefRefPtr<CefBrowser> browser, const CefString &title) {
-    AppState::getInstance()->statusbar->setActiveTab(title.ToString());
+    this->title = title.ToString();
+    if (isForeground) {
+        AppState::getInstance()->statusbar->setActiveTab(this->title);
+    }
 }
 
 void BrowserHandler::OnPaint(CefRefPtr<CefBrowser> browser, PaintElementType type, const RectList &dirtyRects, const void *buffer, int width, int height) {
-    if (!textureId) {
+    if (!frameStore) {
         return;
     }
 
-    XPLMBindTexture2d(textureId, 0);
-    constexpr uint32_t bytes_per_pixel = 4;
-
-    for (const auto &rect : dirtyRects) {
-        const uint8_t *rectBuffer = static_cast<const uint8_t *>(buffer) + rect.y * width * bytes_per_pixel + rect.x * bytes_per_pixel;
-
-        glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
-
-        if (needsFullDraw) {
-            glTexSubImage2D(
-                GL_TEXTURE_2D,
-                0,
-                0, 0,
-                width, height,
-                GL_BGRA,
-                GL_UNSIGNED_BYTE,
-                buffer);
-            needsFullDraw = false;
-        } else if (popupShown) {
-            if (type == PET_POPUP) {
-                glTexSubImage2D(
-                    GL_TEXTURE_2D,
-                    0,
-                    popupRect.x + rect.x, popupRect.y + rect.y,
-                    rect.width, rect.height,
-                    GL_BGRA,
-                    GL_UNSIGNED_BYTE,
-                    rectBuffer);
+    TRACE_SCOPE("BrowserHandler::OnPaint");
+    PerformanceTimer timer(Performance::getInstance()->paint);
+    Performance::getInstance()->dirtyRects.add((float) dirtyRects.size());
+    if (!hasPainted) {
+        hasPainted = true;
+        long long milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - createdTime).count();
+        debug("First paint %lld ms after creating the browser.\n", milliseconds);
+    }
+
+    std::vector<TextureRegion> regions;
+    if (needsFullDraw) {
+        regions.push_back({0, 0, width, height, 0, 0});
+        needsFullDraw = false;
+    } else if (popupShown) {
+        if (type == PET_POPUP) {
+            for (const auto &rect : dirtyRects) {
+                regions.push_back({rect.x, rect.y, rect.width, rect.height, popupRect.x + rect.x, popupRect.y + rect.y});
             }
-        } else {
-            glTexSubImage2D(
-                GL_TEXTURE_2D,
-                0,
-                rect.x, rect.y,
-                rect.width, rect.height,
-                GL_BGRA,
-                GL_UNSIGNED_BYTE,
-                rectBuffer);
         }
-
-        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    } else {
+        for (const auto &rect : dirtyRects) {
+            regions.push_back({rect.x, rect.y, rect.width, rect.height, rect.x, rect.y});
+        }
     }
+
+    frameStore->write(buffer, width, height, regions);
+    MessagePump::getInstance()->notifyPaint();
 }
 
 bool BrowserHandler::OnCursorChange(CefRefPtr<CefBrowser> browser, CefCursorHandle cursor, cef_cursor_type_t type, const CefCursorInfo &custom_cursor_info) {
@@ -176,11 +201,22 @@ void BrowserHandler::OnVirtualKeyboardRequested(CefRefPtr<CefBrowser> browser, T
 }
 
 void BrowserHandler::OnLoadingStateChange(CefRefPtr<CefBrowser> browser, bool isLoading, bool canGoBack, bool canGoForward) {
-    AppState::getInstance()->statusbar->loading = isLoading;
+    if (isForeground) {
+        AppState::getInstance()->statusbar->loading = isLoading;
+    }
+
+    if (isLoading) {
+        loadStartTime = std::chrono::steady_clock::now();
+    } else {
+        if (loadStartTime != std::chrono::steady_clock::time_point()) {
+            Performance::getInstance()->pageLoad.add(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - loadStartTime).count());
+            loadStartTime = {};
+        }
 
-    if (!isLoading) {
         injectAddressBar(browser);
-        *currentUrl = browser->GetMainFrame()->GetURL().ToString();
+        if (currentUrl) {
+            *currentUrl = browser->GetMainFrame()->GetURL().ToString();
+        }
     }
 }
 
@@ -341,17 +377,54 @@ void BrowserHandler::OnDownloadUpdated(CefRefPtr<CefBrowser> browser, CefRefPtr<
     }
 }
 
+CefRefPtr<CefResourceHandler> BrowserHandler::GetResourceHandler(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request) {
+    std::string url = request->GetURL().ToString();
+    if (url.starts_with(GeolocationChannel::url)) {
+        return GeolocationChannel::getInstance()->createResourceHandler();
+    }
+
+    if (url.starts_with(tabStateUrl)) {
+        long long heap = 0;
+        int x = 0;
+        int y = 0;
+        size_t query = url.find('?');
+        if (query != std::string::npos && sscanf(url.c_str() + query, "?heap=%lld&x=%d&y=%d", &heap, &x, &y) == 3) {
+            heapBytes = heap;
+            scrollX = x;
+            scrollY = y;
+        }
+
+        static char response[] = "ok";
+        return new CefStreamResourceHandler("text/plain", CefStreamReader::CreateForData(response, sizeof(response) - 1));
+    }
+
+    return OfflineCache::getInstance()->createResourceHandler(browser, request);
+}
+
+CefRefPtr<CefResponseFilter> BrowserHandler::GetResourceResponseFilter(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response) {
+    return OfflineCache::getInstance()->createResponseFilter(request, response);
+}
+
+void BrowserHandler::OnResourceLoadComplete(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response, URLRequestStatus status, int64_t received_content_length) {
+    OfflineCache::getInstance()->completeResponse(request, response, status == UR_SUCCESS);
+}
+
 cef_return_value_t BrowserHandler::OnBeforeResourceLoad(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request, CefRefPtr<CefCallback> callback) {
-    CefRequest::HeaderMap headers;
-    request->GetHeaderMap(headers);
-    auto it = headers.find("User-Agent");
-    if (it == headers.end()) {
+    RequestHeaders *requestHeaders = RequestHeaders::getInstance();
+    bool isMainFrame = request->GetResourceType() == RT_MAIN_FRAME;
+    if (isMainFrame && !requestHeaders->needsUrl()) {
+        requestHeaders->apply(request, "");
         return RV_CONTINUE;
     }
 
-    headers.erase("User-Agent");
-    headers.insert(std::make_pair("User-Agent", AppState::getInstance()->config.user_agent));
-    request->SetHeaderMap(headers);
+    std::string url = request->GetURL().ToString();
+
+    // Never block the page itself, only what it pulls in.
+    if (!isMainFrame && url.rfind("https://avitab-browser.local/", 0) != 0 && RequestFilter::getInstance()->match(url) >= 0) {
+        return RV_CANCEL;
+    }
+
+    requestHeaders->apply(request, url);
     return RV_CONTINUE;
 }
 
@@ -373,9 +446,39 @@ void BrowserHandler::OnLoadEnd(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame
 
     overrideGeolocationAndNavigator(browser);
     injectAddressBar(browser);
+    injectTabReporter(browser);
+
+    if (restoreScrollX || restoreScrollY) {
+        std::string script = "window.scrollTo(" + std::to_string(restoreScrollX) + ", " + std::to_string(restoreScrollY) + ");";
+        frame->ExecuteJavaScript(script, frame->GetURL(), 0);
+        restoreScrollX = 0;
+        restoreScrollY = 0;
+    }
+}
+
+void BrowserHandler::injectTabReporter(CefRefPtr<CefBrowser> browser) {
+    TRACE_SCOPE("BrowserHandler::injectTabReporter");
+    const std::string script = R"(
+        if (!window.avitab_report_tab) {
+            window.avitab_report_tab = () => {
+                const heap = (performance.memory && performance.memory.usedJSHeapSize) || 0;
+                fetch(')" + std::string(tabStateUrl) + R"(?heap=' + heap + '&x=' + Math.round(window.scrollX) + '&y=' + Math.round(window.scrollY), { mode: 'no-cors', cache: 'no-store' }).catch(() => {});
+            };
+            setInterval(window.avitab_report_tab, 5000);
+            document.addEventListener('visibilitychange', () => {
+                if (document.hidden) {
+                    window.avitab_report_tab();
+                }
+            });
+            window.avitab_report_tab();
+        }
+    )";
+
+    browser->GetMainFrame()->ExecuteJavaScript(script, browser->GetMainFrame()->GetURL(), 0);
 }
 
 void BrowserHandler::overrideGeolocationAndNavigator(CefRefPtr<CefBrowser> browser) {
+    TRACE_SCOPE("BrowserHandler::overrideGeolocationAndNavigator");
     std::string userAgent = AppState::getInstance()->config.user_agent;
 
     std::string javascript =
@@ -421,13 +524,15 @@ void BrowserHandler::overrideGeolocationAndNavigator(CefRefPtr<CefBrowser> brows
         "    }"
         "};"
         "setUserAgent(window, \"" +
-        userAgent + "\");"
-                    "window.dispatchEvent(new Event('load'));";
+        userAgent + "\");" +
+        GeolocationChannel::getInstance()->receiverScript(AppState::getInstance()->config.geolocation_rate, AppState::getInstance()->config.geolocation_interpolation) +
+        "window.dispatchEvent(new Event('load'));";
 
     browser->GetMainFrame()->ExecuteJavaScript(javascript.c_str(), browser->GetMainFrame()->GetURL(), 0);
 }
 
 void BrowserHandler::injectAddressBar(CefRefPtr<CefBrowser> browser) {
+    TRACE_SCOPE("BrowserHandler::injectAddressBar");
     if (AppState::getInstance()->config.hide_addressbar) {
         return;
     }
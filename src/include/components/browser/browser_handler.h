@@ -2,7 +2,10 @@
 #define BROWSER_HANDLER_H
 
 #include "cursor.h"
+#include "frame_store.h"
 
+#include <atomic>
+#include <chrono>
 #include <include/cef_client.h>
 #include <include/cef_version.h>
 
@@ -24,25 +27,41 @@ class BrowserHandler : public CefClient,
                        public CefResourceRequestHandler {
     private:
         IMPLEMENT_REFCOUNTING(BrowserHandler);
-        int textureId;
+        FrameStore *frameStore;
         PopupRect popupRect;
         bool popupShown;
         bool needsFullDraw;
         std::string *currentUrl;
         unsigned short windowWidth;
         unsigned short windowHeight;
+        std::chrono::steady_clock::time_point createdTime;
+        std::chrono::steady_clock::time_point loadStartTime;
         void injectAddressBar(CefRefPtr<CefBrowser> browser);
         void overrideGeolocationAndNavigator(CefRefPtr<CefBrowser> browser);
+        void injectTabReporter(CefRefPtr<CefBrowser> browser);
 
     public:
-        BrowserHandler(int textureId, std::string *currentUrl, unsigned short width, unsigned short height);
+        BrowserHandler(FrameStore *frameStore, std::string *currentUrl, unsigned short width, unsigned short height);
         ~BrowserHandler();
 
+        // Pages report their JS heap size and scroll position here, so background tabs can be discarded and restored.
+        static constexpr const char *tabStateUrl = "https://avitab-browser.local/tab";
+
         bool hasInputFocus;
+        bool hasPainted;
+        bool isForeground;
+        bool isClosed;
+        std::string title;
+        std::atomic<long long> heapBytes;
+        std::atomic<int> scrollX;
+        std::atomic<int> scrollY;
+        int restoreScrollX;
+        int restoreScrollY;
         CursorType cursorState;
         CefRefPtr<CefBrowser> browserInstance;
 
         void destroy();
+        void setFrameStore(FrameStore *frameStore);
 
         CefRefPtr<CefDisplayHandler> GetDisplayHandler() override {
             return this;
@@ -105,6 +124,9 @@ class BrowserHandler : public CefClient,
         void OnBeforeDownload(CefRefPtr<CefBrowser> browser, CefRefPtr<CefDownloadItem> download_item, const CefString &suggested_name, CefRefPtr<CefBeforeDownloadCallback> callback) override;
         void OnDownloadUpdated(CefRefPtr<CefBrowser> browser, CefRefPtr<CefDownloadItem> download_item, CefRefPtr<CefDownloadItemCallback> callback) override;
         void OnLoadEnd(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, int httpStatusCode) override;
+        CefRefPtr<CefResourceHandler> GetResourceHandler(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request) override;
+        CefRefPtr<CefResponseFilter> GetResourceResponseFilter(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response) override;
+        void OnResourceLoadComplete(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response, URLRequestStatus status, int64_t received_content_length) override;
         cef_return_value_t OnBeforeResourceLoad(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request, CefRefPtr<CefCallback> callback) override;
 #if DEBUG
         bool OnBeforeBrowse(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request, bool user_gesture, bool is_redirect) override;
@@ -0,0 +1,113 @@
+#include "dirty_rect_coalescer.h"
+
+#include <algorithm>
+
+static DirtyRect unite(const DirtyRect &a, const DirtyRect &b) {
+    int x1 = std::min(a.x, b.x);
+    int y1 = std::min(a.y, b.y);
+    int x2 = std::max(a.x + a.width, b.x + b.width);
+    int y2 = std::max(a.y + a.height, b.y + b.height);
+    return {x1, y1, x2 - x1, y2 - y1};
+}
+
+static bool contains(const DirtyRect &outer, const DirtyRect &inner) {
+    return inner.x >= outer.x && inner.y >= outer.y && inner.x + inner.width <= outer.x + outer.width && inner.y + inner.height <= outer.y + outer.height;
+}
+
+DirtyRectCoalescer::DirtyRectCoalescer(size_t aCallOverheadBytes, unsigned char aBytesPerPixel) {
+    callOverheadBytes = aCallOverheadBytes;
+    bytesPerPixel = aBytesPerPixel;
+}
+
+void DirtyRectCoalescer::add(const DirtyRect &rect) {
+    if (rect.width <= 0 || rect.height <= 0) {
+        return;
+    }
+
+    merge(rect);
+}
+
+std::vector<DirtyRect> DirtyRectCoalescer::take(size_t budgetBytes) {
+    std::vector<DirtyRect> result;
+    if (budgetBytes == 0) {
+        result.swap(pending);
+        return result;
+    }
+
+    size_t usedBytes = 0;
+    size_t taken = 0;
+    for (; taken < pending.size(); ++taken) {
+        DirtyRect &rect = pending[taken];
+        size_t rectBytes = (size_t) rect.width * rect.height * bytesPerPixel;
+        if (usedBytes + rectBytes <= budgetBytes) {
+            result.push_back(rect);
+            usedBytes += rectBytes;
+            continue;
+        }
+
+        // Upload as many full rows as still fit, and leave the rest of the rect for the next frame.
+        size_t rowBytes = (size_t) rect.width * bytesPerPixel;
+        int rows = (int) ((budgetBytes - std::min(usedBytes, budgetBytes)) / rowBytes);
+        if (rows == 0 && result.empty()) {
+            // Always make progress, even when a single row exceeds the budget.
+            rows = 1;
+        }
+
+        if (rows > 0) {
+            result.push_back({rect.x, rect.y, rect.width, rows});
+            rect.y += rows;
+            rect.height -= rows;
+            if (rect.height == 0) {
+                ++taken;
+            }
+        }
+        break;
+    }
+
+    pending.erase(pending.begin(), pending.begin() + taken);
+    return result;
+}
+
+bool DirtyRectCoalescer::hasPending() const {
+    return !pending.empty();
+}
+
+size_t DirtyRectCoalescer::pendingBytes() const {
+    size_t bytes = 0;
+    for (const auto &rect : pending) {
+        bytes += (size_t) rect.width * rect.height * bytesPerPixel;
+    }
+
+    return bytes;
+}
+
+void DirtyRectCoalescer::clear() {
+    pending.clear();
+}
+
+size_t DirtyRectCoalescer::cost(const DirtyRect &rect) const {
+    return (size_t) rect.width * rect.height * bytesPerPixel + callOverheadBytes;
+}
+
+void DirtyRectCoalescer::merge(DirtyRect rect) {
+    bool didMerge = true;
+    while (didMerge) {
+        didMerge = false;
+        for (auto it = pending.begin(); it != pending.end(); ++it) {
+            if (contains(*it, rect)) {
+                return;
+            }
+
+            // Merging pays off when one bigger upload is cheaper than two separate calls.
+            DirtyRect united = unite(*it, rect);
+            if (cost(united) <= cost(*it) + cost(rect)) {
+                rect = united;
+                pending.erase(it);
+                didMerge = true;
+                break;
+            }
+        }
+    }
+
+    pending.push_back(rect);
+}
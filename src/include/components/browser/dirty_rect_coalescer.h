@@ -0,0 +1,32 @@
+#ifndef DIRTY_RECT_COALESCER_H
+#define DIRTY_RECT_COALESCER_H
+
+#include <cstddef>
+#include <vector>
+
+struct DirtyRect {
+        int x, y, width, height;
+};
+
+class DirtyRectCoalescer {
+    private:
+        std::vector<DirtyRect> pending;
+        size_t callOverheadBytes;
+        unsigned char bytesPerPixel;
+        size_t cost(const DirtyRect &rect) const;
+        void merge(DirtyRect rect);
+
+    public:
+        // Rough cost of one texture upload call, expressed in the bytes that could have been copied in the same time.
+        static constexpr size_t defaultCallOverheadBytes = 32 * 1024;
+
+        DirtyRectCoalescer(size_t callOverheadBytes = defaultCallOverheadBytes, unsigned char bytesPerPixel = 4);
+
+        void add(const DirtyRect &rect);
+        std::vector<DirtyRect> take(size_t budgetBytes);
+        bool hasPending() const;
+        size_t pendingBytes() const;
+        void clear();
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include "frame_rate_governor.h"
+
+#include <algorithm>
+#include <cmath>
+
+// All times are in seconds.
+static constexpr float inputActiveDuration = 2.0f;
+static constexpr float lowerRateDelay = 2.0f;
+static constexpr float paintWindowDuration = 1.0f;
+// A page painting (nearly) every frame probably wants more frames than it gets. It gets twice as many
+// per step, so a page that simply updates at the current rate settles there instead of jumping to the maximum.
+static constexpr float saturatedPaintRatio = 0.8f;
+static constexpr int saturatedRateStep = 2;
+// Below this, the sim is struggling and the browser gets at most half of its frame rate.
+static constexpr float lowSimFrameRate = 25.0f;
+
+FrameRateGovernor::FrameRateGovernor(int aMaximumRate, int aIdleRate) {
+    maximumRate = std::max(aMaximumRate, 1);
+    idleRate = std::clamp(aIdleRate, 1, maximumRate);
+    reset(0.0f);
+}
+
+void FrameRateGovernor::reset(float time) {
+    frameRate = maximumRate;
+    reason = "loading";
+    lastInputTime = time;
+    lowerTargetTime = -1.0f;
+    lowerTarget = 0;
+    lowerTargetReason = "";
+    windowStartTime = time;
+    windowPaintCount = 0;
+    paintsPerSecond = 0.0f;
+}
+
+void FrameRateGovernor::notifyInput(float time) {
+    lastInputTime = time;
+}
+
+void FrameRateGovernor::notifyPaint() {
+    windowPaintCount++;
+}
+
+bool FrameRateGovernor::update(float time, float simFrameRate) {
+    if (time - windowStartTime >= paintWindowDuration) {
+        paintsPerSecond = windowPaintCount / (time - windowStartTime);
+        windowStartTime = time;
+        windowPaintCount = 0;
+    }
+
+    int target;
+    const char *targetReason;
+    if (time - lastInputTime < inputActiveDuration) {
+        target = maximumRate;
+        targetReason = "input";
+    } else if (paintsPerSecond >= frameRate * saturatedPaintRatio) {
+        target = std::min(frameRate * saturatedRateStep, maximumRate);
+        targetReason = "animation";
+    } else if (paintsPerSecond > 0.0f) {
+        target = std::clamp((int) std::ceil(paintsPerSecond * 2.0f), idleRate, maximumRate);
+        targetReason = "page updates";
+    } else {
+        target = idleRate;
+        targetReason = "idle";
+    }
+
+    if (simFrameRate > 0.0f) {
+        // Frames beyond the sim frame rate are never shown.
+        int simLimit = std::max((int) (simFrameRate < lowSimFrameRate ? simFrameRate / 2.0f : simFrameRate), idleRate);
+        if (target > simLimit) {
+            target = simLimit;
+            targetReason = "sim frame rate";
+        }
+    }
+
+    if (target < frameRate) {
+        // Only lower once nothing has asked for the current rate during the whole delay, and then
+        // to the highest rate asked for in that time.
+        if (lowerTargetTime < 0.0f || target > lowerTarget) {
+            lowerTargetTime = lowerTargetTime < 0.0f ? time : lowerTargetTime;
+            lowerTarget = target;
+            lowerTargetReason = targetReason;
+        }
+        if (time - lowerTargetTime < lowerRateDelay) {
+            return false;
+        }
+
+        target = lowerTarget;
+        targetReason = lowerTargetReason;
+    }
+    lowerTargetTime = -1.0f;
+
+    bool changed = target != frameRate;
+    frameRate = target;
+    reason = targetReason;
+    return changed;
+}
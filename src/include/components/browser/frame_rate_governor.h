@@ -0,0 +1,32 @@
+#ifndef FRAME_RATE_GOVERNOR_H
+#define FRAME_RATE_GOVERNOR_H
+
+#include <string>
+
+// Picks the windowless frame rate from page and user activity, so static pages don't render at the full rate.
+// Raises the rate as soon as activity is seen, and only lowers it once a lower rate has been wanted for a while.
+class FrameRateGovernor {
+    private:
+        int maximumRate;
+        int idleRate;
+        float lastInputTime;
+        float lowerTargetTime;
+        int lowerTarget;
+        const char *lowerTargetReason;
+        float windowStartTime;
+        unsigned int windowPaintCount;
+        float paintsPerSecond;
+
+    public:
+        FrameRateGovernor(int maximumRate, int idleRate);
+
+        int frameRate;
+        std::string reason;
+
+        void reset(float time);
+        void notifyInput(float time);
+        void notifyPaint();
+        bool update(float time, float simFrameRate);
+};
+
+#endif
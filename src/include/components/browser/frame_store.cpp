@@ -0,0 +1,144 @@
+#include "frame_store.h"
+
+#include <algorithm>
+#include <cstring>
+
+static DirtyRect boundingRect(const std::vector<DirtyRect> &rects) {
+    int x1 = rects.front().x;
+    int y1 = rects.front().y;
+    int x2 = x1 + rects.front().width;
+    int y2 = y1 + rects.front().height;
+    for (const auto &rect : rects) {
+        x1 = std::min(x1, rect.x);
+        y1 = std::min(y1, rect.y);
+        x2 = std::max(x2, rect.x + rect.width);
+        y2 = std::max(y2, rect.y + rect.height);
+    }
+
+    return {x1, y1, x2 - x1, y2 - y1};
+}
+
+FrameStore::FrameStore(unsigned short aWidth, unsigned short aHeight, unsigned char aBytesPerPixel) {
+    width = aWidth;
+    height = aHeight;
+    bytesPerPixel = aBytesPerPixel;
+    for (unsigned char i = 0; i < bufferCount; ++i) {
+        buffers[i] = new unsigned char[(size_t) width * height * bytesPerPixel]();
+    }
+
+    front = 0;
+    middle = 1;
+    back = 2;
+    lastWritten = back;
+    hasWritten = false;
+}
+
+FrameStore::~FrameStore() {
+    for (unsigned char i = 0; i < bufferCount; ++i) {
+        delete[] buffers[i];
+        buffers[i] = nullptr;
+    }
+}
+
+void FrameStore::write(const void *buffer, int bufferWidth, int bufferHeight, const std::vector<TextureRegion> &regions) {
+    if (!buffer || regions.empty()) {
+        return;
+    }
+
+    // Bring the back buffer up to date with everything painted since it was last written.
+    if (hasWritten && lastWritten != back) {
+        for (const auto &rect : staleRects[back]) {
+            copyRect(buffers[back], buffers[lastWritten], rect);
+        }
+    }
+    staleRects[back].clear();
+
+    const unsigned char *pixels = static_cast<const unsigned char *>(buffer);
+    const size_t rowStride = (size_t) width * bytesPerPixel;
+    std::vector<DirtyRect> frameRects;
+    for (const auto &region : regions) {
+        int regionWidth = std::min({region.width, bufferWidth - region.x, width - region.destX});
+        int regionHeight = std::min({region.height, bufferHeight - region.y, height - region.destY});
+        if (region.x < 0 || region.y < 0 || region.destX < 0 || region.destY < 0 || regionWidth <= 0 || regionHeight <= 0) {
+            continue;
+        }
+
+        for (int row = 0; row < regionHeight; ++row) {
+            const unsigned char *source = pixels + ((size_t) (region.y + row) * bufferWidth + region.x) * bytesPerPixel;
+            memcpy(buffers[back] + (region.destY + row) * rowStride + region.destX * bytesPerPixel, source, (size_t) regionWidth * bytesPerPixel);
+        }
+        frameRects.push_back({region.destX, region.destY, regionWidth, regionHeight});
+    }
+
+    if (frameRects.empty()) {
+        return;
+    }
+
+    for (unsigned char i = 0; i < bufferCount; ++i) {
+        if (i != back) {
+            appendRects(staleRects[i], frameRects);
+        }
+    }
+
+    // The published frame carries every region the reader hasn't picked up yet, since
+    // the texture may still be showing a frame from before the last unconsumed one.
+    // Only the writer sets the fresh flag, so once it's gone the reader has taken the last frame.
+    if (!(middle.load(std::memory_order_acquire) & freshFlag)) {
+        unconsumedRects.clear();
+    }
+    uploadRects[back] = unconsumedRects;
+    appendRects(uploadRects[back], frameRects);
+
+    lastWritten = back;
+    hasWritten = true;
+    unsigned char previous = middle.exchange(back | freshFlag, std::memory_order_acq_rel);
+    back = previous & ~freshFlag;
+
+    if (previous & freshFlag) {
+        unconsumedRects = uploadRects[lastWritten];
+    } else {
+        unconsumedRects = frameRects;
+    }
+}
+
+bool FrameStore::acquire() {
+    if (!(middle.load(std::memory_order_acquire) & freshFlag)) {
+        return false;
+    }
+
+    front = middle.exchange(front, std::memory_order_acq_rel) & ~freshFlag;
+    return true;
+}
+
+const unsigned char *FrameStore::frontPixels() const {
+    return buffers[front];
+}
+
+const std::vector<DirtyRect> &FrameStore::frontRects() const {
+    return uploadRects[front];
+}
+
+unsigned short FrameStore::stride() const {
+    return width;
+}
+
+size_t FrameStore::memoryBytes() const {
+    return (size_t) bufferCount * width * height * bytesPerPixel;
+}
+
+void FrameStore::copyRect(unsigned char *destination, const unsigned char *source, const DirtyRect &rect) {
+    const size_t rowStride = (size_t) width * bytesPerPixel;
+    for (int row = 0; row < rect.height; ++row) {
+        size_t offset = (rect.y + row) * rowStride + rect.x * bytesPerPixel;
+        memcpy(destination + offset, source + offset, (size_t) rect.width * bytesPerPixel);
+    }
+}
+
+void FrameStore::appendRects(std::vector<DirtyRect> &target, const std::vector<DirtyRect> &rects) {
+    target.insert(target.end(), rects.begin(), rects.end());
+    if (target.size() > maxTrackedRects) {
+        // Long-running backlogs are cheaper to track as one bounding box.
+        DirtyRect bounds = boundingRect(target);
+        target.assign(1, bounds);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef FRAME_STORE_H
+#define FRAME_STORE_H
+
+#include "dirty_rect_coalescer.h"
+#include "texture_uploader.h"
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Triple-buffered CPU copy of the browser frame. CEF paints into the back buffer,
+// the draw callback reads the front buffer, and the middle slot hands frames over without locking.
+class FrameStore {
+    private:
+        static constexpr unsigned char bufferCount = 3;
+        static constexpr unsigned char freshFlag = 0x80;
+        static constexpr size_t maxTrackedRects = 32;
+        unsigned short width;
+        unsigned short height;
+        unsigned char bytesPerPixel;
+        unsigned char *buffers[bufferCount];
+        std::vector<DirtyRect> uploadRects[bufferCount];
+        std::atomic<unsigned char> middle;
+
+        // Writer side.
+        unsigned char back;
+        unsigned char lastWritten;
+        bool hasWritten;
+        std::vector<DirtyRect> staleRects[bufferCount];
+        std::vector<DirtyRect> unconsumedRects;
+
+        // Reader side.
+        unsigned char front;
+
+        void copyRect(unsigned char *destination, const unsigned char *source, const DirtyRect &rect);
+        void appendRects(std::vector<DirtyRect> &target, const std::vector<DirtyRect> &rects);
+
+    public:
+        FrameStore(unsigned short width, unsigned short height, unsigned char bytesPerPixel);
+        ~FrameStore();
+
+        // Called from the CEF paint callback.
+        void write(const void *buffer, int bufferWidth, int bufferHeight, const std::vector<TextureRegion> &regions);
+
+        // Called once per sim frame from the draw callback.
+        bool acquire();
+        const unsigned char *frontPixels() const;
+        const std::vector<DirtyRect> &frontRects() const;
+        unsigned short stride() const;
+        size_t memoryBytes() const;
+};
+
+#endif
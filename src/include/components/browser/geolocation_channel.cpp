@@ -0,0 +1,155 @@
+#include "geolocation_channel.h"
+
+#include <cstdio>
+#include <include/cef_stream.h>
+#include <include/wrapper/cef_stream_resource_handler.h>
+
+// Without a pull in this time the page can't reach the channel (e.g. blocked by its CSP).
+static constexpr long long pullTimeoutMilliseconds = 2000;
+
+static long long now() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+GeolocationChannel *GeolocationChannel::instance = nullptr;
+
+GeolocationChannel::GeolocationChannel() {
+    sample = {};
+    lastPullTime = 0;
+}
+
+GeolocationChannel::~GeolocationChannel() {
+    instance = nullptr;
+}
+
+GeolocationChannel *GeolocationChannel::getInstance() {
+    if (instance == nullptr) {
+        instance = new GeolocationChannel();
+    }
+
+    return instance;
+}
+
+void GeolocationChannel::publish(GeolocationSample newSample) {
+    std::lock_guard<std::mutex> lock(sampleMutex);
+    newSample.sequence = sample.sequence + 1;
+    sample = newSample;
+}
+
+bool GeolocationChannel::isPulled() {
+    return now() - lastPullTime < pullTimeoutMilliseconds;
+}
+
+std::string GeolocationChannel::fallbackScript() {
+    GeolocationSample current;
+    {
+        std::lock_guard<std::mutex> lock(sampleMutex);
+        current = sample;
+    }
+
+    const double *fields = reinterpret_cast<const double *>(&current);
+    std::string script = "window.avitab_receive && window.avitab_receive([";
+    char number[32];
+    for (unsigned char i = 0; i < fieldCount; ++i) {
+        snprintf(number, sizeof(number), i == 0 ? "%.6f" : ",%.6f", fields[i]);
+        script += number;
+    }
+    script += "]);";
+
+    return script;
+}
+
+std::string GeolocationChannel::receiverScript(float rate, bool interpolate) {
+    std::string interval = std::to_string((int) (1000.0f / rate));
+
+    std::string script = R"(
+        window.avitab_watchers = (window.avitab_watchers || {});
+        window.avitab_publish = (location) => {
+            window.avitab_location = location;
+            for (let key in window.avitab_watchers) { window.avitab_watchers[key](window.avitab_location); }
+        };
+        window.avitab_extrapolate = (sample, seconds) => {
+            const values = sample.values;
+            const distance = values[4] * seconds;
+            const track = values[9] * Math.PI / 180;
+            const metersPerDegree = 111320;
+            return {
+                coords: {
+                    latitude: values[0] + distance * Math.cos(track) / metersPerDegree,
+                    longitude: values[1] + distance * Math.sin(track) / (metersPerDegree * Math.max(Math.cos(values[0] * Math.PI / 180), 0.01)),
+                    accuracy: 10,
+                    altitude: values[2],
+                    altitudeAccuracy: 10,
+                    heading: (values[3] + sample.turnRate * seconds + 360) % 360,
+                    speed: values[4]
+                },
+                wind: { direction: values[5], speedKts: values[6] },
+                extra: { altitudeAgl: values[7], airspeedKts: values[8] },
+                timestamp: Date.now()
+            };
+        };
+        window.avitab_receive = (values) => {
+            if (values.length < 11 || !values[10] || values[10] === window.avitab_sequence) {
+                return;
+            }
+
+            window.avitab_sequence = values[10];
+            const now = performance.now();
+            const previous = window.avitab_sample;
+            let turnRate = 0;
+            if (previous && now > previous.receivedAt) {
+                const headingChange = ((values[3] - previous.values[3] + 540) % 360) - 180;
+                turnRate = Math.max(-10, Math.min(10, headingChange / ((now - previous.receivedAt) / 1000)));
+            }
+
+            window.avitab_sample = { values: values, receivedAt: now, turnRate: turnRate };
+            window.avitab_publish(window.avitab_extrapolate(window.avitab_sample, 0));
+        };
+        if (!window.avitab_poll) {
+            window.avitab_poll = () => {
+                const watching = Object.keys(window.avitab_watchers).length > 0;
+                fetch(')" + std::string(url) + R"(', { cache: 'no-store' })
+                    .then((response) => response.arrayBuffer())
+                    .then((buffer) => window.avitab_receive(new Float64Array(buffer)))
+                    .catch(() => {})
+                    .finally(() => setTimeout(window.avitab_poll, watching ? )" + interval + R"( : 1000));
+            };
+            window.avitab_poll();
+        }
+    )";
+
+    if (interpolate) {
+        // Move the position along the track between samples, so maps animate smoothly at low source rates.
+        script += R"(
+            if (!window.avitab_interpolator) {
+                window.avitab_interpolator = setInterval(() => {
+                    const sample = window.avitab_sample;
+                    if (!sample || Object.keys(window.avitab_watchers).length === 0) {
+                        return;
+                    }
+
+                    const seconds = Math.min((performance.now() - sample.receivedAt) / 1000, 2);
+                    window.avitab_publish(window.avitab_extrapolate(sample, seconds));
+                }, 50);
+            }
+        )";
+    }
+
+    return script;
+}
+
+CefRefPtr<CefResourceHandler> GeolocationChannel::createResourceHandler() {
+    GeolocationSample current;
+    {
+        std::lock_guard<std::mutex> lock(sampleMutex);
+        current = sample;
+    }
+    lastPullTime = now();
+
+    CefResponse::HeaderMap headers;
+    headers.insert(std::make_pair("Access-Control-Allow-Origin", "*"));
+    headers.insert(std::make_pair("Cache-Control", "no-store"));
+
+    CefRefPtr<CefStreamReader> stream = CefStreamReader::CreateForData(&current, sizeof(current));
+    return new CefStreamResourceHandler(200, "OK", "application/octet-stream", headers, stream);
+}
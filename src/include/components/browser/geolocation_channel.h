@@ -0,0 +1,49 @@
+#ifndef GEOLOCATION_CHANNEL_H
+#define GEOLOCATION_CHANNEL_H
+
+#include <atomic>
+#include <chrono>
+#include <include/cef_resource_handler.h>
+#include <mutex>
+#include <string>
+
+// Field order is the wire format, the page reads it as a Float64Array.
+struct GeolocationSample {
+        double latitude;
+        double longitude;
+        double altitude;
+        double heading;
+        double speed;
+        double windDirection;
+        double windSpeed;
+        double altitudeAgl;
+        double airspeed;
+        double track;
+        double sequence;
+};
+
+// Hands the latest position to the page without generating JavaScript for every update.
+// The injected shim polls a reserved URL, which is answered from memory with the packed sample.
+class GeolocationChannel {
+    private:
+        GeolocationChannel();
+        ~GeolocationChannel();
+        static GeolocationChannel *instance;
+        std::mutex sampleMutex;
+        GeolocationSample sample;
+        std::atomic<long long> lastPullTime;
+
+    public:
+        static constexpr const char *url = "https://avitab-browser.local/location";
+        static constexpr unsigned char fieldCount = sizeof(GeolocationSample) / sizeof(double);
+
+        static GeolocationChannel *getInstance();
+
+        void publish(GeolocationSample newSample);
+        bool isPulled();
+        std::string fallbackScript();
+        std::string receiverScript(float rate, bool interpolate);
+        CefRefPtr<CefResourceHandler> createResourceHandler();
+};
+
+#endif
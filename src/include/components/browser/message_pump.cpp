@@ -0,0 +1,212 @@
+#include "message_pump.h"
+
+#include "appstate.h"
+#include "config.h"
+#include "performance.h"
+
+#include <algorithm>
+
+// All times are in microseconds on the steady clock.
+static constexpr long long inputActiveDuration = 1000000;
+static constexpr long long paintActiveDuration = 500000;
+static constexpr long long estimatedIdlePumpInterval = 250000;
+static constexpr long long maximumPumpInterval = 1000000;
+static constexpr long long statsInterval = 1000000;
+static constexpr long long hiddenPumpInterval = 1000000;
+static constexpr long long hiddenIdlePumpInterval = 5000000;
+
+MessagePump *MessagePump::instance = nullptr;
+
+MessagePump::MessagePump() {
+    flightLoop = nullptr;
+    reset();
+}
+
+MessagePump::~MessagePump() {
+    instance = nullptr;
+}
+
+MessagePump *MessagePump::getInstance() {
+    if (instance == nullptr) {
+        instance = new MessagePump();
+    }
+
+    return instance;
+}
+
+void MessagePump::setFlightLoop(XPLMFlightLoop_f callback) {
+    flightLoop = callback;
+    simThread = std::this_thread::get_id();
+}
+
+void MessagePump::scheduleWork(long long delayMilliseconds) {
+    receivesScheduleCallbacks = true;
+
+    long long time = now() + std::max(delayMilliseconds, 0LL) * 1000;
+    long long current = scheduledPumpTime.load();
+    while ((current == 0 || time < current) && !scheduledPumpTime.compare_exchange_weak(current, time)) {
+    }
+
+    // XPLM can't be called from CEF's threads; work scheduled there waits for the parked loop's next tick.
+    if (std::this_thread::get_id() == simThread) {
+        wake();
+    }
+}
+
+void MessagePump::notifyInput() {
+    lastInputTime = now();
+    wake();
+}
+
+void MessagePump::notifyPaint() {
+    lastPaintTime = now();
+}
+
+bool MessagePump::pumpIfDue() {
+    long long startTime = now();
+    if (startTime - statsStartTime >= statsInterval) {
+        float seconds = (startTime - statsStartTime) / 1000000.0f;
+        pumpsPerSecond = statsPumpCount / seconds;
+        averagePumpMilliseconds = statsPumpCount > 0 ? (float) (statsPumpMilliseconds / statsPumpCount) : 0.0f;
+        statsStartTime = startTime;
+        statsPumpCount = 0;
+        statsPumpMilliseconds = 0.0;
+    }
+
+    if (!isDue(startTime)) {
+        return false;
+    }
+
+    // Without callbacks, each pump that finds the page idle doubles the wait before the next one.
+    long long scheduled = scheduledPumpTime.load();
+    bool idle = !isActive(startTime) && (scheduled == 0 || scheduled > startTime);
+    idlePumpInterval = idle ? std::min(idlePumpInterval * 2, maximumPumpInterval) : estimatedIdlePumpInterval;
+
+    // Clear the schedule first, CEF may request new work while it is being pumped.
+    scheduledPumpTime = 0;
+    {
+        PerformanceTimer timer(Performance::getInstance()->messagePump);
+        CefDoMessageLoopWork();
+    }
+
+    lastPumpTime = now();
+    statsPumpCount++;
+    statsPumpMilliseconds += (lastPumpTime - startTime) / 1000.0;
+    return true;
+}
+
+bool MessagePump::pumpInBackground() {
+    // Hidden browsers only get a maintenance pump, so timers and network callbacks don't pile up until the next show.
+    long long startTime = now();
+    if (startTime - lastPumpTime < backgroundPumpInterval()) {
+        return false;
+    }
+
+    scheduledPumpTime = 0;
+    {
+        PerformanceTimer timer(Performance::getInstance()->messagePump);
+        CefDoMessageLoopWork();
+    }
+    lastPumpTime = now();
+    return true;
+}
+
+float MessagePump::nextFlightLoopInterval(bool visible) {
+    long long time = now();
+    if (!visible) {
+        if (lastPumpTime == 0) {
+            // Nothing has been pumped yet; the maintenance pump runs on the next tablet poll.
+            return AppState::getInstance()->tabletPollInterval();
+        }
+
+        // Sleep until the next maintenance pump. When CEF tells us about its work and has none queued,
+        // that's only the safety net, and scheduleWork() or input wakes the loop up earlier.
+        float interval = (lastPumpTime + backgroundPumpInterval() - time) / 1000000.0f;
+        flightLoopParked = interval > REFRESH_INTERVAL_SECONDS_FAST;
+        return interval > 0.0f ? interval : -1.0f;
+    }
+
+    flightLoopParked = false;
+    if (isActive(time)) {
+        // Negative values are in flight loops, so this means: call again next frame.
+        return -1.0f;
+    }
+
+    // An idle page sleeps until its next due pump; input and scheduleWork() wake the loop earlier.
+    long long nextPumpTime = lastPumpTime + (receivesScheduleCallbacks ? maximumPumpInterval : idlePumpInterval);
+    long long scheduled = scheduledPumpTime.load();
+    if (scheduled > 0) {
+        nextPumpTime = std::min(nextPumpTime, scheduled);
+    }
+
+    if (nextPumpTime <= time) {
+        return -1.0f;
+    }
+
+    float interval = (nextPumpTime - time) / 1000000.0f;
+    flightLoopParked = interval > REFRESH_INTERVAL_SECONDS_FAST;
+    return interval;
+}
+
+void MessagePump::wake() {
+    if (!flightLoop || !flightLoopParked) {
+        return;
+    }
+
+    flightLoopParked = false;
+    XPLMSetFlightLoopCallbackInterval(flightLoop, -1.0f, 1, nullptr);
+}
+
+void MessagePump::reset() {
+    scheduledPumpTime = 0;
+    lastInputTime = 0;
+    lastPaintTime = 0;
+    receivesScheduleCallbacks = false;
+    lastPumpTime = 0;
+    idlePumpInterval = estimatedIdlePumpInterval;
+    flightLoopParked = false;
+    statsStartTime = now();
+    statsPumpCount = 0;
+    statsPumpMilliseconds = 0.0;
+    pumpsPerSecond = 0.0f;
+    averagePumpMilliseconds = 0.0f;
+}
+
+long long MessagePump::now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool MessagePump::isActive(long long time) {
+    return time - lastInputTime < inputActiveDuration || time - lastPaintTime < paintActiveDuration;
+}
+
+bool MessagePump::isDue(long long time) {
+    if (isActive(time)) {
+        return true;
+    }
+
+    long long scheduled = scheduledPumpTime.load();
+    if (scheduled > 0 && scheduled <= time) {
+        return true;
+    }
+
+    if (!receivesScheduleCallbacks) {
+        // Without callbacks we can't tell whether CEF has work queued, so keep it ticking slowly.
+        return time - lastPumpTime >= idlePumpInterval;
+    }
+
+    // Safety net in case a scheduling callback went missing.
+    return time - lastPumpTime >= maximumPumpInterval;
+}
+
+long long MessagePump::backgroundPumpInterval() {
+    if (receivesScheduleCallbacks && scheduledPumpTime.load() == 0) {
+        return hiddenIdlePumpInterval;
+    }
+
+    return hiddenPumpInterval;
+}
+
+void MessagePumpApp::OnScheduleMessagePumpWork(int64_t delay_ms) {
+    MessagePump::getInstance()->scheduleWork(delay_ms);
+}
@@ -0,0 +1,65 @@
+#ifndef MESSAGE_PUMP_H
+#define MESSAGE_PUMP_H
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <include/cef_app.h>
+#include <XPLMProcessing.h>
+
+// Decides when CefDoMessageLoopWork() needs to run, instead of pumping on every flight loop tick.
+// With X-Plane 11 we own CEF and get OnScheduleMessagePumpWork() callbacks; with X-Plane 12 the
+// schedule is estimated from input and paint activity.
+class MessagePump {
+    private:
+        MessagePump();
+        ~MessagePump();
+        static MessagePump *instance;
+        std::atomic<long long> scheduledPumpTime;
+        std::atomic<long long> lastInputTime;
+        std::atomic<long long> lastPaintTime;
+        std::atomic<bool> receivesScheduleCallbacks;
+        long long lastPumpTime;
+        long long idlePumpInterval;
+        XPLMFlightLoop_f flightLoop;
+        std::thread::id simThread;
+        bool flightLoopParked;
+        long long statsStartTime;
+        unsigned int statsPumpCount;
+        double statsPumpMilliseconds;
+        static long long now();
+        bool isActive(long long time);
+        bool isDue(long long time);
+        long long backgroundPumpInterval();
+
+    public:
+        static MessagePump *getInstance();
+
+        float pumpsPerSecond;
+        float averagePumpMilliseconds;
+
+        void setFlightLoop(XPLMFlightLoop_f callback);
+        void scheduleWork(long long delayMilliseconds);
+        void notifyInput();
+        void notifyPaint();
+        bool pumpIfDue();
+        bool pumpInBackground();
+        float nextFlightLoopInterval(bool visible);
+        void wake();
+        void reset();
+};
+
+// Minimal CefApp used when the plugin initializes CEF itself, to receive pump scheduling callbacks.
+class MessagePumpApp : public CefApp, public CefBrowserProcessHandler {
+    private:
+        IMPLEMENT_REFCOUNTING(MessagePumpApp);
+
+    public:
+        CefRefPtr<CefBrowserProcessHandler> GetBrowserProcessHandler() override {
+            return this;
+        }
+
+        void OnScheduleMessagePumpWork(int64_t delay_ms) override;
+};
+
+#endif
@@ -0,0 +1,388 @@
+#include "offline_cache.h"
+
+#include "appstate.h"
+#include "config.h"
+#include "hash.h"
+#include "json.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <include/base/cef_callback.h>
+#include <include/cef_stream.h>
+#include <include/cef_task.h>
+#include <include/wrapper/cef_closure_task.h>
+#include <XPLMUtilities.h>
+
+// Cached URLs are fetched again at most this often, in seconds.
+static constexpr long long revalidateInterval = 60;
+// Larger responses are passed through, but not cached.
+static constexpr size_t maximumBodySize = 16 * 1024 * 1024;
+// Response headers that are stored with the body and replayed when it is served from the cache.
+static const char *const storedHeaders[] = {
+    "Content-Type",
+    "Content-Language",
+    "Content-Disposition",
+    "Content-Security-Policy",
+    "Access-Control-Allow-Origin",
+    "Access-Control-Allow-Credentials",
+    "Access-Control-Expose-Headers",
+    "Last-Modified",
+    "ETag",
+};
+
+static OfflineCacheHeaders headersToStore(CefRefPtr<CefResponse> response) {
+    OfflineCacheHeaders headers;
+    for (const char *name : storedHeaders) {
+        std::string value = response->GetHeaderByName(name).ToString();
+        if (!value.empty()) {
+            headers[name] = value;
+        }
+    }
+
+    return headers;
+}
+
+static std::string charsetOf(const std::string &contentType) {
+    std::string lowercase = contentType;
+    std::transform(lowercase.begin(), lowercase.end(), lowercase.begin(), ::tolower);
+    size_t position = lowercase.find("charset=");
+    if (position == std::string::npos) {
+        return "";
+    }
+
+    std::string charset = contentType.substr(position + strlen("charset="));
+    charset = charset.substr(0, charset.find(';'));
+    charset.erase(std::remove(charset.begin(), charset.end(), '"'), charset.end());
+    charset.erase(charset.find_last_not_of(" \t") + 1);
+    return charset;
+}
+
+static bool wildcardMatch(const char *pattern, const char *text) {
+    const char *star = nullptr;
+    const char *retry = nullptr;
+    while (*text) {
+        if (*pattern == '*') {
+            star = pattern++;
+            retry = text;
+        } else if (*pattern == *text) {
+            pattern++;
+            text++;
+        } else if (star) {
+            pattern = star + 1;
+            text = ++retry;
+        } else {
+            return false;
+        }
+    }
+
+    while (*pattern == '*') {
+        pattern++;
+    }
+
+    return *pattern == '\0';
+}
+
+bool OfflineCacheFilter::InitFilter() {
+    return true;
+}
+
+CefResponseFilter::FilterStatus OfflineCacheFilter::Filter(void *data_in, size_t data_in_size, size_t &data_in_read, void *data_out, size_t data_out_size, size_t &data_out_written) {
+    data_in_read = std::min(data_in_size, data_out_size);
+    data_out_written = data_in_read;
+    if (data_in_read > 0) {
+        memcpy(data_out, data_in, data_in_read);
+        if (!overflow && body.size() + data_in_read <= maximumBodySize) {
+            body.append(static_cast<const char *>(data_in), data_in_read);
+        } else {
+            overflow = true;
+            body.clear();
+        }
+    }
+
+    return RESPONSE_FILTER_NEED_MORE_DATA;
+}
+
+OfflineCacheRevalidator::OfflineCacheRevalidator(std::string aUrl) {
+    url = aUrl;
+}
+
+void OfflineCacheRevalidator::OnDownloadData(CefRefPtr<CefURLRequest> request, const void *data, size_t data_length) {
+    if (body.size() + data_length <= maximumBodySize) {
+        body.append(static_cast<const char *>(data), data_length);
+    }
+}
+
+void OfflineCacheRevalidator::OnRequestComplete(CefRefPtr<CefURLRequest> request) {
+    bool success = request->GetRequestStatus() == UR_SUCCESS && body.size() < maximumBodySize;
+    OfflineCache::getInstance()->completeRevalidation(url, request->GetResponse(), success, std::move(body));
+}
+
+static CefResponse::HeaderMap headerMapOf(const OfflineCacheHeaders &headers) {
+    CefResponse::HeaderMap headerMap;
+    for (const auto &[name, value] : headers) {
+        headerMap.insert(std::make_pair(name, value));
+    }
+
+    return headerMap;
+}
+
+OfflineCacheResourceHandler::OfflineCacheResourceHandler(const OfflineCacheEntry &entry, CefRefPtr<CefStreamReader> stream) : CefStreamResourceHandler(200, "OK", entry.mimeType, headerMapOf(entry.headers), stream) {
+    auto contentType = entry.headers.find("Content-Type");
+    if (contentType != entry.headers.end()) {
+        charset = charsetOf(contentType->second);
+    }
+}
+
+void OfflineCacheResourceHandler::GetResponseHeaders(CefRefPtr<CefResponse> response, int64_t &response_length, CefString &redirectUrl) {
+    CefStreamResourceHandler::GetResponseHeaders(response, response_length, redirectUrl);
+    if (!charset.empty()) {
+        response->SetCharset(charset);
+    }
+}
+
+OfflineCache *OfflineCache::instance = nullptr;
+
+OfflineCache::OfflineCache() {
+}
+
+OfflineCache::~OfflineCache() {
+    instance = nullptr;
+}
+
+OfflineCache *OfflineCache::getInstance() {
+    if (instance == nullptr) {
+        instance = new OfflineCache();
+    }
+
+    return instance;
+}
+
+void OfflineCache::initialize(const std::string &aDirectory, const std::vector<std::string> &aPatterns) {
+    std::lock_guard<std::mutex> lock(mutex);
+    directory = aDirectory;
+    patterns = aPatterns;
+    entries.clear();
+    if (patterns.empty()) {
+        return;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory + "/objects", error);
+
+    std::ifstream file(directory + "/index.json");
+    if (!file.good()) {
+        return;
+    }
+
+    try {
+        nlohmann::json index = nlohmann::json::parse(file);
+        for (auto &[url, item] : index.items()) {
+            OfflineCacheEntry entry = {
+                item["hash"].get<std::string>(),
+                item["mime_type"].get<std::string>(),
+                item.value("headers", OfflineCacheHeaders()),
+                item["stored_at"].get<long long>(),
+                0,
+            };
+
+            // Indexes written before the headers were stored only kept the allowed origin.
+            std::string allowOrigin = item.value("allow_origin", "");
+            if (!allowOrigin.empty() && !entry.headers.contains("Access-Control-Allow-Origin")) {
+                entry.headers["Access-Control-Allow-Origin"] = allowOrigin;
+            }
+
+            if (std::filesystem::exists(objectPath(entry.hash))) {
+                entries[url] = entry;
+            }
+        }
+    } catch (const nlohmann::json::exception &e) {
+        debug("Offline cache index is malformed, starting with an empty cache: %s\n", e.what());
+        entries.clear();
+    }
+
+    debug("Offline cache loaded with %zu entries.\n", entries.size());
+}
+
+bool OfflineCache::matches(const std::string &url) {
+    for (const auto &pattern : patterns) {
+        if (wildcardMatch(pattern.c_str(), url.c_str())) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+CefRefPtr<CefResourceHandler> OfflineCache::createResourceHandler(CefRefPtr<CefBrowser> browser, CefRefPtr<CefRequest> request) {
+    if (request->GetMethod() != "GET") {
+        return nullptr;
+    }
+
+    std::string url = request->GetURL().ToString();
+    if (!matches(url)) {
+        return nullptr;
+    }
+
+    OfflineCacheEntry entry;
+    bool needsRevalidation = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(url);
+        if (it == entries.end()) {
+            return nullptr;
+        }
+
+        long long now = std::time(nullptr);
+        if (now - it->second.checkedAt >= revalidateInterval && !revalidating.contains(url)) {
+            it->second.checkedAt = now;
+            revalidating.insert(url);
+            needsRevalidation = true;
+        }
+        entry = it->second;
+    }
+
+    CefRefPtr<CefStreamReader> stream = CefStreamReader::CreateForFile(objectPath(entry.hash));
+    if (!stream) {
+        return nullptr;
+    }
+
+    if (needsRevalidation) {
+        CefRefPtr<CefRequest> revalidation = CefRequest::Create();
+        revalidation->SetURL(url);
+        revalidation->SetMethod("GET");
+        revalidation->SetFlags(UR_FLAG_SKIP_CACHE);
+        CefURLRequest::Create(revalidation, new OfflineCacheRevalidator(url), browser->GetHost()->GetRequestContext());
+    }
+
+    return new OfflineCacheResourceHandler(entry, stream);
+}
+
+CefRefPtr<CefResponseFilter> OfflineCache::createResponseFilter(CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response) {
+    if (request->GetMethod() != "GET" || response->GetStatus() != 200) {
+        return nullptr;
+    }
+
+    std::string url = request->GetURL().ToString();
+    if (!matches(url)) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (entries.contains(url)) {
+        // Served from the cache, which keeps itself up to date.
+        return nullptr;
+    }
+
+    CefRefPtr<OfflineCacheFilter> filter = new OfflineCacheFilter();
+    filters[request->GetIdentifier()] = filter;
+    return filter;
+}
+
+void OfflineCache::completeResponse(CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response, bool success) {
+    CefRefPtr<OfflineCacheFilter> filter;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = filters.find(request->GetIdentifier());
+        if (it == filters.end()) {
+            return;
+        }
+
+        filter = it->second;
+        filters.erase(it);
+    }
+
+    if (!success || filter->overflow) {
+        return;
+    }
+
+    CefPostTask(TID_FILE_BACKGROUND, base::BindOnce(&OfflineCache::store, base::Unretained(this), request->GetURL().ToString(), response->GetMimeType().ToString(), headersToStore(response), std::move(filter->body)));
+}
+
+void OfflineCache::completeRevalidation(const std::string &url, CefRefPtr<CefResponse> response, bool success, std::string body) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        revalidating.erase(url);
+    }
+
+    if (!success || !response || response->GetStatus() != 200) {
+        return;
+    }
+
+    CefPostTask(TID_FILE_BACKGROUND, base::BindOnce(&OfflineCache::store, base::Unretained(this), url, response->GetMimeType().ToString(), headersToStore(response), std::move(body)));
+}
+
+void OfflineCache::store(const std::string &url, const std::string &mimeType, const OfflineCacheHeaders &headers, const std::string &body) {
+    std::string hash = Hash::ToHex(Hash::Fnv1a(body));
+    std::string path = objectPath(hash);
+    if (!std::filesystem::exists(path)) {
+        std::string temporaryPath = path + ".tmp";
+        std::ofstream file(temporaryPath, std::ios::binary);
+        file.write(body.data(), body.size());
+        file.close();
+        if (!file) {
+            // This runs on the file thread, XPLM may only be called from the sim thread.
+            AppState::getInstance()->executeDelayed([url]() {
+                debug("Could not write offline cache entry for %s.\n", url.c_str());
+            }, 0);
+            return;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, path, error);
+    }
+
+    std::string previousHash;
+    bool headersChanged = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(url);
+        if (it != entries.end()) {
+            previousHash = it->second.hash;
+            headersChanged = it->second.mimeType != mimeType || it->second.headers != headers;
+        }
+        entries[url] = {hash, mimeType, headers, (long long) std::time(nullptr), (long long) std::time(nullptr)};
+
+        bool previousInUse = std::any_of(entries.begin(), entries.end(), [&previousHash](const auto &item) {
+            return item.second.hash == previousHash;
+        });
+        if (!previousHash.empty() && !previousInUse) {
+            std::error_code error;
+            std::filesystem::remove(objectPath(previousHash), error);
+        }
+    }
+
+    if (previousHash != hash || headersChanged) {
+        saveIndex();
+    }
+}
+
+std::string OfflineCache::objectPath(const std::string &hash) {
+    return directory + "/objects/" + hash;
+}
+
+void OfflineCache::saveIndex() {
+    nlohmann::json index = nlohmann::json::object();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto &[url, entry] : entries) {
+            index[url] = {
+                {"hash", entry.hash},
+                {"mime_type", entry.mimeType},
+                {"headers", entry.headers},
+                {"stored_at", entry.storedAt},
+            };
+        }
+    }
+
+    std::string temporaryPath = directory + "/index.json.tmp";
+    std::ofstream file(temporaryPath);
+    file << index.dump();
+    file.close();
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, directory + "/index.json", error);
+}
@@ -0,0 +1,100 @@
+#ifndef OFFLINE_CACHE_H
+#define OFFLINE_CACHE_H
+
+#include <include/cef_browser.h>
+#include <include/cef_request.h>
+#include <include/cef_resource_handler.h>
+#include <include/cef_response.h>
+#include <include/cef_response_filter.h>
+#include <include/cef_urlrequest.h>
+#include <include/wrapper/cef_stream_resource_handler.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+typedef std::map<std::string, std::string> OfflineCacheHeaders;
+
+struct OfflineCacheEntry {
+        std::string hash;
+        std::string mimeType;
+        OfflineCacheHeaders headers;
+        long long storedAt;
+        long long checkedAt;
+};
+
+// Serves a stored body with the headers of the original response, including the charset of its Content-Type.
+class OfflineCacheResourceHandler : public CefStreamResourceHandler {
+    private:
+        std::string charset;
+
+    public:
+        OfflineCacheResourceHandler(const OfflineCacheEntry &entry, CefRefPtr<CefStreamReader> stream);
+
+        void GetResponseHeaders(CefRefPtr<CefResponse> response, int64_t &response_length, CefString &redirectUrl) override;
+};
+
+// Copies a response body while passing it through unchanged, so it can be stored once the load completes.
+class OfflineCacheFilter : public CefResponseFilter {
+    private:
+        IMPLEMENT_REFCOUNTING(OfflineCacheFilter);
+
+    public:
+        std::string body;
+        bool overflow = false;
+
+        bool InitFilter() override;
+        FilterStatus Filter(void *data_in, size_t data_in_size, size_t &data_in_read, void *data_out, size_t data_out_size, size_t &data_out_written) override;
+};
+
+// Fetches a cached URL again in the background and stores the result when it has changed.
+class OfflineCacheRevalidator : public CefURLRequestClient {
+    private:
+        IMPLEMENT_REFCOUNTING(OfflineCacheRevalidator);
+        std::string url;
+        std::string body;
+
+    public:
+        OfflineCacheRevalidator(std::string url);
+
+        void OnRequestComplete(CefRefPtr<CefURLRequest> request) override;
+        void OnUploadProgress(CefRefPtr<CefURLRequest> request, int64_t current, int64_t total) override {}
+        void OnDownloadProgress(CefRefPtr<CefURLRequest> request, int64_t current, int64_t total) override {}
+        void OnDownloadData(CefRefPtr<CefURLRequest> request, const void *data, size_t data_length) override;
+        bool GetAuthCredentials(bool isProxy, const CefString &host, int port, const CefString &realm, const CefString &scheme, CefRefPtr<CefAuthCallback> callback) override {
+            return false;
+        }
+};
+
+// Keeps responses for the configured URL patterns on disk, so pages keep working without a connection.
+// Cached responses are served right away and revalidated in the background. Bodies are stored under
+// their content hash, so identical responses share one file; index.json maps URLs to hashes.
+class OfflineCache {
+    private:
+        OfflineCache();
+        ~OfflineCache();
+        static OfflineCache *instance;
+        std::mutex mutex;
+        std::string directory;
+        std::vector<std::string> patterns;
+        std::unordered_map<std::string, OfflineCacheEntry> entries;
+        std::unordered_set<std::string> revalidating;
+        std::unordered_map<uint64_t, CefRefPtr<OfflineCacheFilter>> filters;
+        std::string objectPath(const std::string &hash);
+        void saveIndex();
+
+    public:
+        static OfflineCache *getInstance();
+
+        void initialize(const std::string &directory, const std::vector<std::string> &patterns);
+        bool matches(const std::string &url);
+        CefRefPtr<CefResourceHandler> createResourceHandler(CefRefPtr<CefBrowser> browser, CefRefPtr<CefRequest> request);
+        CefRefPtr<CefResponseFilter> createResponseFilter(CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response);
+        void completeResponse(CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response, bool success);
+        void completeRevalidation(const std::string &url, CefRefPtr<CefResponse> response, bool success, std::string body);
+        void store(const std::string &url, const std::string &mimeType, const OfflineCacheHeaders &headers, const std::string &body);
+};
+
+#endif
@@ -0,0 +1,281 @@
+#include "request_filter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+
+// Patterns shorter than this would block far too much.
+static constexpr size_t minimumPatternLength = 3;
+static constexpr size_t maximumHostLength = 255;
+
+static inline char lowercase(char c) {
+    return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+}
+
+static bool isHostName(const std::string &text) {
+    return !text.empty() && text.find('.') != std::string::npos && std::all_of(text.begin(), text.end(), [](char c) {
+        return std::isalnum((unsigned char) c) || c == '.' || c == '-' || c == '_';
+    });
+}
+
+RequestFilter *RequestFilter::instance = nullptr;
+
+RequestFilter::RequestFilter() {
+    domainNodes.push_back({0, -1, -1, 0, -1});
+    patternNodes.push_back({0, -1, -1, 0, -1});
+    std::fill(std::begin(patternRoot), std::end(patternRoot), 0);
+}
+
+RequestFilter::~RequestFilter() {
+    instance = nullptr;
+}
+
+RequestFilter *RequestFilter::getInstance() {
+    if (instance == nullptr) {
+        instance = new RequestFilter();
+    }
+
+    return instance;
+}
+
+void RequestFilter::load(const std::string &directory) {
+    lists.clear();
+    domainNodes.resize(1);
+    domainNodes[0] = {0, -1, -1, 0, -1};
+    patternNodes.resize(1);
+    patternNodes[0] = {0, -1, -1, 0, -1};
+
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error)) {
+        return;
+    }
+
+    std::vector<std::filesystem::path> files;
+    for (const auto &entry : std::filesystem::directory_iterator(directory, error)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".txt") {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    for (const auto &path : files) {
+        auto list = std::make_unique<RequestFilterList>();
+        list->name = path.stem().string();
+        list->ruleCount = 0;
+        list->hits = 0;
+        lists.push_back(std::move(list));
+
+        int listIndex = (int) lists.size() - 1;
+        size_t nodeCount = domainNodes.size() + patternNodes.size();
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            addRule(line, listIndex);
+            if (domainNodes.size() + patternNodes.size() != nodeCount) {
+                lists[listIndex]->ruleCount++;
+                nodeCount = domainNodes.size() + patternNodes.size();
+            }
+        }
+    }
+
+    buildPatternLinks();
+}
+
+int RequestFilter::match(const std::string &url) {
+    if (lists.empty()) {
+        return -1;
+    }
+
+    size_t hostStart = url.find("://");
+    hostStart = hostStart == std::string::npos ? 0 : hostStart + 3;
+    size_t hostEnd = url.find_first_of("/?#", hostStart);
+    hostEnd = hostEnd == std::string::npos ? url.size() : hostEnd;
+    size_t credentials = url.rfind('@', hostEnd);
+    if (credentials != std::string::npos && credentials >= hostStart) {
+        hostStart = credentials + 1;
+    }
+    size_t port = url.find(':', hostStart);
+    if (port != std::string::npos && port < hostEnd) {
+        hostEnd = port;
+    }
+
+    char host[maximumHostLength];
+    size_t length = std::min(hostEnd - hostStart, maximumHostLength);
+    for (size_t i = 0; i < length; ++i) {
+        host[i] = lowercase(url[hostStart + i]);
+    }
+
+    int list = matchDomain(host, length);
+    if (list < 0) {
+        list = matchPattern(url);
+    }
+
+    if (list >= 0) {
+        lists[list]->hits++;
+    }
+
+    return list;
+}
+
+void RequestFilter::addRule(std::string line, int list) {
+    line.erase(std::remove_if(line.begin(), line.end(), [](char c) { return c == '\r'; }), line.end());
+    line.erase(0, line.find_first_not_of(" \t"));
+    line.erase(line.find_last_not_of(" \t") + 1);
+    if (line.empty() || line[0] == '!' || line[0] == '[' || line[0] == '#') {
+        return;
+    }
+
+    // Element hiding, exceptions and rules with options are not supported.
+    if (line.find('#') != std::string::npos || line.starts_with("@@") || line.find('$') != std::string::npos) {
+        return;
+    }
+
+    std::transform(line.begin(), line.end(), line.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    // Hosts file lines, e.g. "0.0.0.0 tracker.example.com".
+    size_t space = line.find_first_of(" \t");
+    if (space != std::string::npos) {
+        std::string domain = line.substr(line.find_last_of(" \t") + 1);
+        if (isHostName(domain) && domain != "localhost") {
+            addDomain(domain, list);
+        }
+        return;
+    }
+
+    bool domainAnchor = line.starts_with("||");
+    line.erase(0, line.find_first_not_of("|"));
+    while (!line.empty() && (line.back() == '^' || line.back() == '|' || line.back() == '*')) {
+        line.pop_back();
+    }
+    line.erase(0, line.find_first_not_of("*"));
+
+    // Bare host names (as in plain domain lists) are domain rules too, but "-analytics.js" is a pattern.
+    bool bareHostName = !line.empty() && std::isalnum((unsigned char) line.front()) && std::isalnum((unsigned char) line.back()) && line.find_first_not_of("0123456789.") != std::string::npos;
+    if (isHostName(line) && (domainAnchor || bareHostName)) {
+        addDomain(line, list);
+        return;
+    }
+
+    if (line.length() < minimumPatternLength || line.find_first_of("*^|") != std::string::npos) {
+        return;
+    }
+
+    addPattern(line, list);
+}
+
+int RequestFilter::findChild(const std::vector<TrieNode> &nodes, int node, char character) const {
+    for (int child = nodes[node].firstChild; child >= 0; child = nodes[child].nextSibling) {
+        if (nodes[child].character == character) {
+            return child;
+        }
+    }
+
+    return -1;
+}
+
+int RequestFilter::addChild(std::vector<TrieNode> &nodes, int node, char character) {
+    int child = findChild(nodes, node, character);
+    if (child >= 0) {
+        return child;
+    }
+
+    nodes.push_back({character, -1, nodes[node].firstChild, 0, -1});
+    nodes[node].firstChild = (int) nodes.size() - 1;
+    return nodes[node].firstChild;
+}
+
+void RequestFilter::addDomain(const std::string &domain, int list) {
+    int node = 0;
+    for (auto it = domain.rbegin(); it != domain.rend(); ++it) {
+        node = addChild(domainNodes, node, *it);
+    }
+
+    if (domainNodes[node].list < 0) {
+        domainNodes[node].list = list;
+    }
+}
+
+void RequestFilter::addPattern(const std::string &pattern, int list) {
+    int node = 0;
+    for (char character : pattern) {
+        node = addChild(patternNodes, node, character);
+    }
+
+    if (patternNodes[node].list < 0) {
+        patternNodes[node].list = list;
+    }
+}
+
+void RequestFilter::buildPatternLinks() {
+    // Most characters in a URL leave the automaton at the root, so its transitions get a direct lookup table.
+    for (int character = 0; character < 256; ++character) {
+        int child = findChild(patternNodes, 0, (char) character);
+        patternRoot[character] = child >= 0 ? child : 0;
+    }
+
+    // Breadth first, so every failure link points at a node that is already complete.
+    std::vector<int> queue;
+    for (int child = patternNodes[0].firstChild; child >= 0; child = patternNodes[child].nextSibling) {
+        patternNodes[child].failure = 0;
+        queue.push_back(child);
+    }
+
+    for (size_t i = 0; i < queue.size(); ++i) {
+        int node = queue[i];
+        for (int child = patternNodes[node].firstChild; child >= 0; child = patternNodes[child].nextSibling) {
+            int failure = patternNodes[node].failure;
+            int next = findChild(patternNodes, failure, patternNodes[child].character);
+            while (next < 0 && failure != 0) {
+                failure = patternNodes[failure].failure;
+                next = findChild(patternNodes, failure, patternNodes[child].character);
+            }
+
+            patternNodes[child].failure = next >= 0 ? next : 0;
+            if (patternNodes[child].list < 0) {
+                // A pattern ending inside this one matches here too.
+                patternNodes[child].list = patternNodes[patternNodes[child].failure].list;
+            }
+            queue.push_back(child);
+        }
+    }
+}
+
+int RequestFilter::matchDomain(const char *host, size_t length) const {
+    int node = 0;
+    for (size_t i = length; i > 0; --i) {
+        node = findChild(domainNodes, node, host[i - 1]);
+        if (node < 0) {
+            return -1;
+        }
+
+        // Only whole labels match, so "example.com" blocks "ads.example.com" but not "myexample.com".
+        if (domainNodes[node].list >= 0 && (i == 1 || host[i - 2] == '.')) {
+            return domainNodes[node].list;
+        }
+    }
+
+    return -1;
+}
+
+int RequestFilter::matchPattern(const std::string &url) const {
+    if (patternNodes[0].firstChild < 0) {
+        return -1;
+    }
+
+    int node = 0;
+    for (char c : url) {
+        char character = lowercase(c);
+        int next = -1;
+        while (node != 0 && (next = findChild(patternNodes, node, character)) < 0) {
+            node = patternNodes[node].failure;
+        }
+
+        node = node != 0 ? next : patternRoot[(unsigned char) character];
+        if (patternNodes[node].list >= 0) {
+            return patternNodes[node].list;
+        }
+    }
+
+    return -1;
+}
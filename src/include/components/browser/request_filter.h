@@ -0,0 +1,52 @@
+#ifndef REQUEST_FILTER_H
+#define REQUEST_FILTER_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct RequestFilterList {
+        std::string name;
+        unsigned int ruleCount;
+        std::atomic<unsigned long long> hits;
+};
+
+// Blocks requests matching host or pattern lists (hosts files and a subset of EasyList), loaded once at startup.
+// Domain rules live in a trie over the reversed host name, so a lookup only walks the host once.
+// Pattern rules are matched in a single pass over the URL with Aho-Corasick.
+class RequestFilter {
+    private:
+        struct TrieNode {
+                char character;
+                int firstChild;
+                int nextSibling;
+                int failure;
+                int list;
+        };
+
+        RequestFilter();
+        ~RequestFilter();
+        static RequestFilter *instance;
+        std::vector<TrieNode> domainNodes;
+        std::vector<TrieNode> patternNodes;
+        int patternRoot[256];
+        int findChild(const std::vector<TrieNode> &nodes, int node, char character) const;
+        int addChild(std::vector<TrieNode> &nodes, int node, char character);
+        void addDomain(const std::string &domain, int list);
+        void addPattern(const std::string &pattern, int list);
+        void addRule(std::string line, int list);
+        void buildPatternLinks();
+        int matchDomain(const char *host, size_t length) const;
+        int matchPattern(const std::string &url) const;
+
+    public:
+        static RequestFilter *getInstance();
+
+        std::vector<std::unique_ptr<RequestFilterList>> lists;
+
+        void load(const std::string &directory);
+        int match(const std::string &url);
+};
+
+#endif
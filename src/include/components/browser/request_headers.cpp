@@ -0,0 +1,110 @@
+#include "request_headers.h"
+
+#include <algorithm>
+#include <cctype>
+
+static std::string trim(const std::string &text) {
+    size_t start = text.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        return "";
+    }
+
+    size_t end = text.find_last_not_of(" \t");
+    return text.substr(start, end - start + 1);
+}
+
+RequestHeaders *RequestHeaders::instance = nullptr;
+
+RequestHeaders::RequestHeaders() {
+    hasDomainRules = false;
+}
+
+RequestHeaders::~RequestHeaders() {
+    instance = nullptr;
+}
+
+RequestHeaders *RequestHeaders::getInstance() {
+    if (instance == nullptr) {
+        instance = new RequestHeaders();
+    }
+
+    return instance;
+}
+
+void RequestHeaders::configure(const std::string &userAgent, const std::vector<std::string> &headers) {
+    rules.clear();
+    hasDomainRules = false;
+    if (!userAgent.empty()) {
+        rules.push_back({"", "User-Agent", userAgent});
+    }
+
+    // Headers are written as "Name: value", or "domain Name: value" to only send them to that domain.
+    // Rules for all domains go first, so a domain specific rule overrides them.
+    std::vector<RequestHeaderRule> domainRules;
+    for (const auto &header : headers) {
+        size_t separator = header.find(':');
+        if (separator == std::string::npos) {
+            continue;
+        }
+
+        std::string name = trim(header.substr(0, separator));
+        std::string value = trim(header.substr(separator + 1));
+        std::string domain;
+        size_t space = name.find_last_of(" \t");
+        if (space != std::string::npos) {
+            domain = trim(name.substr(0, space));
+            name = name.substr(space + 1);
+        }
+
+        if (name.empty()) {
+            continue;
+        }
+
+        std::transform(domain.begin(), domain.end(), domain.begin(), [](unsigned char c) {
+            return std::tolower(c);
+        });
+        if (domain.empty()) {
+            rules.push_back({"", name, value});
+        } else {
+            domainRules.push_back({domain, name, value});
+        }
+    }
+
+    hasDomainRules = !domainRules.empty();
+    rules.insert(rules.end(), domainRules.begin(), domainRules.end());
+}
+
+bool RequestHeaders::needsUrl() const {
+    return hasDomainRules;
+}
+
+void RequestHeaders::apply(CefRefPtr<CefRequest> request, const std::string &url) const {
+    for (const auto &rule : rules) {
+        if (!rule.domain.empty() && !hostMatches(url, rule.domain)) {
+            continue;
+        }
+
+        request->SetHeaderByName(rule.name, rule.value, true);
+    }
+}
+
+bool RequestHeaders::hostMatches(const std::string &url, const std::string &domain) {
+    size_t start = url.find("://");
+    if (start == std::string::npos) {
+        return false;
+    }
+
+    start += 3;
+    size_t end = url.find_first_of(":/?#", start);
+    if (end == std::string::npos) {
+        end = url.size();
+    }
+
+    size_t length = end - start;
+    if (length < domain.size() || url.compare(end - domain.size(), domain.size(), domain) != 0) {
+        return false;
+    }
+
+    // Subdomains match too, but only on a label boundary.
+    return length == domain.size() || url[end - domain.size() - 1] == '.';
+}
@@ -0,0 +1,33 @@
+#ifndef REQUEST_HEADERS_H
+#define REQUEST_HEADERS_H
+
+#include <include/cef_request.h>
+#include <string>
+#include <vector>
+
+struct RequestHeaderRule {
+        std::string domain;
+        CefString name;
+        CefString value;
+};
+
+// Sets the configured headers on outgoing requests. Names and values are converted to CefString once,
+// when the configuration is loaded, and only the headers that change are touched on the request.
+class RequestHeaders {
+    private:
+        RequestHeaders();
+        ~RequestHeaders();
+        static RequestHeaders *instance;
+        std::vector<RequestHeaderRule> rules;
+        bool hasDomainRules;
+        static bool hostMatches(const std::string &url, const std::string &domain);
+
+    public:
+        static RequestHeaders *getInstance();
+
+        void configure(const std::string &userAgent, const std::vector<std::string> &headers);
+        bool needsUrl() const;
+        void apply(CefRefPtr<CefRequest> request, const std::string &url) const;
+};
+
+#endif
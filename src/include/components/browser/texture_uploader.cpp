@@ -0,0 +1,259 @@
+#include "texture_uploader.h"
+
+#include "config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <XPLMGraphics.h>
+#include <XPLMUtilities.h>
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+
+#ifndef GL_WRITE_ONLY
+#define GL_WRITE_ONLY 0x88B9
+#endif
+
+#if LIN
+extern "C" void (*glXGetProcAddressARB(const GLubyte *procName))(void);
+#endif
+
+typedef void(APIENTRY *GenBuffersFunc)(GLsizei n, GLuint *buffers);
+typedef void(APIENTRY *DeleteBuffersFunc)(GLsizei n, const GLuint *buffers);
+typedef void(APIENTRY *BindBufferFunc)(GLenum target, GLuint buffer);
+typedef void(APIENTRY *BufferDataFunc)(GLenum target, ptrdiff_t size, const void *data, GLenum usage);
+typedef void *(APIENTRY *MapBufferFunc)(GLenum target, GLenum access);
+typedef GLboolean(APIENTRY *UnmapBufferFunc)(GLenum target);
+
+struct PixelBufferFunctions {
+        GenBuffersFunc genBuffers;
+        DeleteBuffersFunc deleteBuffers;
+        BindBufferFunc bindBuffer;
+        BufferDataFunc bufferData;
+        MapBufferFunc mapBuffer;
+        UnmapBufferFunc unmapBuffer;
+};
+
+static PixelBufferFunctions gl = {};
+
+static void *getProcAddress(const char *name) {
+#if IBM
+    return (void *) wglGetProcAddress(name);
+#elif LIN
+    return (void *) glXGetProcAddressARB((const GLubyte *) name);
+#else
+    return nullptr;
+#endif
+}
+
+static bool loadPixelBufferFunctions() {
+    if (gl.genBuffers) {
+        return true;
+    }
+
+#if APL
+    gl.genBuffers = glGenBuffers;
+    gl.deleteBuffers = glDeleteBuffers;
+    gl.bindBuffer = glBindBuffer;
+    gl.bufferData = (BufferDataFunc) glBufferData;
+    gl.mapBuffer = glMapBuffer;
+    gl.unmapBuffer = glUnmapBuffer;
+#else
+    gl.genBuffers = (GenBuffersFunc) getProcAddress("glGenBuffers");
+    gl.deleteBuffers = (DeleteBuffersFunc) getProcAddress("glDeleteBuffers");
+    gl.bindBuffer = (BindBufferFunc) getProcAddress("glBindBuffer");
+    gl.bufferData = (BufferDataFunc) getProcAddress("glBufferData");
+    gl.mapBuffer = (MapBufferFunc) getProcAddress("glMapBuffer");
+    gl.unmapBuffer = (UnmapBufferFunc) getProcAddress("glUnmapBuffer");
+#endif
+
+    if (!gl.genBuffers || !gl.deleteBuffers || !gl.bindBuffer || !gl.bufferData || !gl.mapBuffer || !gl.unmapBuffer) {
+        gl = {};
+        return false;
+    }
+
+    return true;
+}
+
+TextureUploader::TextureUploader(int aTextureId, unsigned short aTextureWidth, unsigned short aTextureHeight, unsigned char bytesPerPixel) : coalescer(DirtyRectCoalescer::defaultCallOverheadBytes, bytesPerPixel) {
+    textureId = aTextureId;
+    textureWidth = aTextureWidth;
+    textureHeight = aTextureHeight;
+    pixelBufferSize = (size_t) textureWidth * textureHeight * bytesPerPixel;
+    frameBudgetBytes = 0;
+    frameBudgetRemaining = 0;
+    nextPixelBuffer = 0;
+    frameBytes = 0;
+    frameCalls = 0;
+    frameMilliseconds = 0.0;
+    lastFrameBytes = 0;
+    lastFrameCalls = 0;
+    lastFrameMilliseconds = 0.0f;
+    std::fill(std::begin(pixelBuffers), std::end(pixelBuffers), 0);
+
+    pixelBuffersAvailable = loadPixelBufferFunctions();
+    if (pixelBuffersAvailable) {
+        gl.genBuffers(pixelBufferCount, pixelBuffers);
+        for (unsigned char i = 0; i < pixelBufferCount; ++i) {
+            gl.bindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[i]);
+            gl.bufferData(GL_PIXEL_UNPACK_BUFFER, pixelBufferSize, nullptr, GL_STREAM_DRAW);
+        }
+        gl.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    } else {
+        debug("Pixel buffer objects are not available, uploading browser frames from client memory.\n");
+    }
+}
+
+void TextureUploader::destroy() {
+    if (pixelBuffersAvailable) {
+        gl.deleteBuffers(pixelBufferCount, pixelBuffers);
+        std::fill(std::begin(pixelBuffers), std::end(pixelBuffers), 0);
+        pixelBuffersAvailable = false;
+    }
+
+    coalescer.clear();
+    textureId = 0;
+}
+
+void TextureUploader::setFrameBudget(size_t budgetBytes) {
+    frameBudgetBytes = budgetBytes;
+    frameBudgetRemaining = budgetBytes;
+}
+
+void TextureUploader::queue(const std::vector<DirtyRect> &rects) {
+    for (const auto &rect : rects) {
+        coalescer.add(rect);
+    }
+}
+
+void TextureUploader::flush(const unsigned char *pixels, int stride) {
+    if (!textureId || !pixels || !coalescer.hasPending()) {
+        return;
+    }
+
+    if (frameBudgetBytes > 0 && frameBudgetRemaining == 0) {
+        return;
+    }
+
+    upload(pixels, stride, coalescer.take(frameBudgetBytes > 0 ? frameBudgetRemaining : 0));
+}
+
+bool TextureUploader::hasPendingRegions() {
+    return coalescer.hasPending();
+}
+
+void TextureUploader::endFrame() {
+    lastFrameBytes = frameBytes;
+    lastFrameCalls = frameCalls;
+    lastFrameMilliseconds = (float) frameMilliseconds;
+    frameBytes = 0;
+    frameCalls = 0;
+    frameMilliseconds = 0.0;
+    frameBudgetRemaining = frameBudgetBytes;
+}
+
+bool TextureUploader::usesPixelBuffers() {
+    return pixelBuffersAvailable;
+}
+
+void TextureUploader::upload(const unsigned char *pixels, int stride, const std::vector<DirtyRect> &rects) {
+    if (rects.empty()) {
+        return;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    XPLMBindTexture2d(textureId, 0);
+
+    std::vector<TextureRegion> regions;
+    regions.reserve(rects.size());
+    size_t bytes = 0;
+    for (const auto &rect : rects) {
+        regions.push_back({rect.x, rect.y, rect.width, rect.height, rect.x, rect.y});
+        bytes += (size_t) rect.width * rect.height * 4;
+    }
+
+    // Regions are copied at their source offsets, so the buffer must cover every row they touch.
+    size_t sourceBytes = 0;
+    for (const auto &region : regions) {
+        sourceBytes = std::max(sourceBytes, ((size_t) (region.y + region.height - 1) * stride + region.x + region.width) * 4);
+    }
+
+    if (pixelBuffersAvailable && stride <= textureWidth && sourceBytes <= pixelBufferSize) {
+        uploadFromPixelBuffer(pixels, stride, regions);
+    } else {
+        uploadFromClientMemory(pixels, stride, regions);
+    }
+
+    frameBytes += bytes;
+    frameCalls += regions.size();
+    frameBudgetRemaining -= std::min(bytes, frameBudgetRemaining);
+    frameMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void TextureUploader::uploadFromPixelBuffer(const unsigned char *buffer, int bufferWidth, const std::vector<TextureRegion> &regions) {
+    // Rotating through the ring means a buffer is only mapped again after the two uploads behind it,
+    // so the driver rarely has to wait for its previous transfer. The copy into it still runs here,
+    // on the sim thread.
+    gl.bindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[nextPixelBuffer]);
+    nextPixelBuffer = (nextPixelBuffer + 1) % pixelBufferCount;
+
+    unsigned char *mapped = static_cast<unsigned char *>(gl.mapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+    if (!mapped) {
+        gl.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        uploadFromClientMemory(buffer, bufferWidth, regions);
+        return;
+    }
+
+    // Regions keep the layout of the source buffer, so one row length works for every sub-image.
+    const size_t stride = (size_t) bufferWidth * 4;
+    for (const auto &region : regions) {
+        size_t offset = region.y * stride + region.x * 4;
+        size_t rowBytes = (size_t) region.width * 4;
+        for (int row = 0; row < region.height; ++row) {
+            memcpy(mapped + offset + row * stride, buffer + offset + row * stride, rowBytes);
+        }
+    }
+    gl.unmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, bufferWidth);
+    for (const auto &region : regions) {
+        size_t offset = region.y * stride + region.x * 4;
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            region.destX, region.destY,
+            region.width, region.height,
+            GL_BGRA,
+            GL_UNSIGNED_BYTE,
+            reinterpret_cast<const void *>(offset));
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    gl.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void TextureUploader::uploadFromClientMemory(const unsigned char *buffer, int bufferWidth, const std::vector<TextureRegion> &regions) {
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, bufferWidth);
+    for (const auto &region : regions) {
+        const unsigned char *regionBuffer = buffer + ((size_t) region.y * bufferWidth + region.x) * 4;
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            region.destX, region.destY,
+            region.width, region.height,
+            GL_BGRA,
+            GL_UNSIGNED_BYTE,
+            regionBuffer);
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
@@ -0,0 +1,50 @@
+#ifndef TEXTURE_UPLOADER_H
+#define TEXTURE_UPLOADER_H
+
+#include "dirty_rect_coalescer.h"
+
+#include <cstddef>
+#include <vector>
+
+struct TextureRegion {
+        int x, y, width, height;
+        int destX, destY;
+};
+
+class TextureUploader {
+    private:
+        static constexpr unsigned char pixelBufferCount = 3;
+        int textureId;
+        unsigned short textureWidth;
+        unsigned short textureHeight;
+        DirtyRectCoalescer coalescer;
+        size_t frameBudgetBytes;
+        size_t frameBudgetRemaining;
+        size_t pixelBufferSize;
+        unsigned int pixelBuffers[pixelBufferCount];
+        unsigned char nextPixelBuffer;
+        bool pixelBuffersAvailable;
+        size_t frameBytes;
+        size_t frameCalls;
+        double frameMilliseconds;
+        void upload(const unsigned char *pixels, int stride, const std::vector<DirtyRect> &rects);
+        void uploadFromPixelBuffer(const unsigned char *buffer, int bufferWidth, const std::vector<TextureRegion> &regions);
+        void uploadFromClientMemory(const unsigned char *buffer, int bufferWidth, const std::vector<TextureRegion> &regions);
+
+    public:
+        TextureUploader(int textureId, unsigned short textureWidth, unsigned short textureHeight, unsigned char bytesPerPixel);
+
+        size_t lastFrameBytes;
+        size_t lastFrameCalls;
+        float lastFrameMilliseconds;
+
+        void destroy();
+        void setFrameBudget(size_t budgetBytes);
+        void queue(const std::vector<DirtyRect> &rects);
+        void flush(const unsigned char *pixels, int stride);
+        bool hasPendingRegions();
+        void endFrame();
+        bool usesPixelBuffers();
+};
+
+#endif
@@ -1,80 +1,59 @@
 #include "image.h"
 #include "config.h"
 #include "appstate.h"
-#include <fstream>
+#include "asset_cache.h"
+#include <algorithm>
+#include <cmath>
 #include <XPLMGraphics.h>
-#include <XPLMUtilities.h>
-#include "lodepng.h"
-#define NANOSVG_IMPLEMENTATION
-#define NANOSVGRAST_IMPLEMENTATION
-#include "nanosvgrast.h"
 
 Image::Image(std::string filename) {
     x = 0;
     y = 0;
     rotationDegrees = 0;
     visible = true;
-    textureId = 0;
+    assetId = 0;
+    texture = {0, {0.0f, 0.0f, 1.0f, 1.0f}};
     
     if (filename.empty()) {
         return;
     }
     
-    unsigned char *data = nullptr;
-    unsigned int error = 1;
-    std::ifstream fileExistsHandle(filename);
-    if (fileExistsHandle.good()) {
-        if (filename.ends_with(".png") || filename.ends_with(".PNG")) {
-            error = lodepng_decode32_file(&data, &pixelsWidth, &pixelsHeight, filename.c_str());
-        }
-        else if (filename.ends_with(".svg") || filename.ends_with(".svg")) {
-            NSVGimage *image = nsvgParseFromFile(filename.c_str(), "px", 96);
-            struct NSVGrasterizer *rast = nsvgCreateRasterizer();
-            pixelsWidth = 16;
-            pixelsHeight = 16;
-            data = (unsigned char *)malloc(pixelsWidth * pixelsHeight * 4);
-            nsvgRasterize(rast, image, 0, 0, (float)pixelsWidth / image->width, data, pixelsWidth, pixelsHeight, pixelsWidth * 4);
-            for (int i = 0; i < pixelsWidth * pixelsHeight * 4; i++) {
-                if (data[i] != 0) {
-                    error = 0;
-                    break;
-                }
-            }
-        }
-    }
+    // Icons are designed as 16x16 vectors; bitmaps keep their own size.
+    bool isVector = filename.ends_with(".svg") || filename.ends_with(".SVG");
+    float drawScale = 1.0f;
+#if SCALE_IMAGES
+    // Images have been designed for 800px width resolution. Scale to size.
+    drawScale = (float)AppState::getInstance()->tabletDimensions.width / 800.0f;
+#endif
     
-    if (error) {
-        debug("Could not load image (code %i): %s\n", error, filename.c_str());
+    // Vectors are rasterized at the pixel size they end up drawn at, instead of stretching a 16x16 bitmap.
+    unsigned int drawnVectorSize = std::max(1.0f, std::round(16.0f * drawScale));
+    unsigned int rasterSize = isVector ? std::max(1.0f, std::round(drawnVectorSize * AppState::getInstance()->pixelScale)) : 0;
+    CachedAsset asset;
+    if (!AssetCache::getInstance()->acquire(filename, rasterSize, rasterSize, &asset)) {
         return;
     }
-
-    if (data) {
-        XPLMGenerateTextureNumbers(&textureId, 1);
-        XPLMBindTexture2d(textureId, 0);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, pixelsWidth, pixelsHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        free(data);
-    }
     
-#if SCALE_IMAGES
-    // Images have been designed for 800px width resolution. Scale to size.
-    float aspectRatio = (float)pixelsWidth / pixelsHeight;
-    pixelsWidth = (pixelsWidth * (float)AppState::getInstance()->tabletDimensions.width) / 800.0f;
-    pixelsHeight = pixelsWidth / aspectRatio;
-#endif
+    // The texture is created once the asset has been decoded; draw() picks it up from there.
+    assetId = asset.id;
+    if (isVector) {
+        pixelsWidth = drawnVectorSize;
+        pixelsHeight = drawnVectorSize;
+    } else {
+        float aspectRatio = (float)asset.width / asset.height;
+        pixelsWidth = asset.width * drawScale;
+        pixelsHeight = pixelsWidth / aspectRatio;
+    }
     
     relativeWidth = pixelsWidth / (float)AppState::getInstance()->tabletDimensions.width;
     relativeHeight = pixelsHeight / (float)AppState::getInstance()->tabletDimensions.height;
 }
 
 void Image::destroy() {
-    if (textureId) {
-        XPLMBindTexture2d(textureId, 0);
-        glDeleteTextures(1, (GLuint *)&textureId);
-        textureId = 0;
+    if (assetId) {
+        AssetCache::getInstance()->release(assetId);
+        assetId = 0;
+        texture.textureId = 0;
     }
 }
 
@@ -85,7 +64,15 @@ void Image::draw(unsigned short aRotationDegrees) {
 }
 
 void Image::draw() {
-    if (!textureId || !visible) {
+    if (!assetId || !visible) {
+        return;
+    }
+    
+    bool isPending = false;
+    if (!resolveTexture(&isPending)) {
+        if (isPending) {
+            drawPlaceholder(AppState::getInstance()->tabletDimensions.x + x - pixelsWidth / 2.0f, AppState::getInstance()->tabletDimensions.y + y - pixelsHeight / 2.0f);
+        }
         return;
     }
     
@@ -99,7 +86,7 @@ void Image::draw() {
                          0 // No depth write, e.g. glDepthMask(GL_FALSE);
     );
     
-    XPLMBindTexture2d(textureId, 0);
+    XPLMBindTexture2d(texture.textureId, 0);
     
     unsigned short x1 = AppState::getInstance()->tabletDimensions.x + x;
     unsigned short y1 = AppState::getInstance()->tabletDimensions.y + y;
@@ -118,16 +105,16 @@ void Image::draw() {
     glBegin(GL_QUADS);
     set_brightness(AppState::getInstance()->brightness);
     
-    glTexCoord2f(0, 1);
+    glTexCoord2f(texture.region.u1, texture.region.v2);
     glVertex2f(x1, y1);
     
-    glTexCoord2f(0, 0);
+    glTexCoord2f(texture.region.u1, texture.region.v1);
     glVertex2f(x1, y1 + pixelsHeight);
     
-    glTexCoord2f(1, 0);
+    glTexCoord2f(texture.region.u2, texture.region.v1);
     glVertex2f(x1 + pixelsWidth, y1 + pixelsHeight);
     
-    glTexCoord2f(1, 1);
+    glTexCoord2f(texture.region.u2, texture.region.v2);
     glVertex2f(x1 + pixelsWidth, y1);
     
     glEnd();
@@ -137,6 +124,60 @@ void Image::draw() {
     }
 }
 
+void Image::addToBatch(SpriteBatch &batch, unsigned short aRotationDegrees) {
+    rotationDegrees = aRotationDegrees;
+    addToBatch(batch);
+}
+
+void Image::addToBatch(SpriteBatch &batch) {
+    if (!assetId || !visible) {
+        return;
+    }
+    
+    // Placeholders and images outside the atlas become runs of their own, so the batch keeps the draw order.
+    unsigned short x1 = AppState::getInstance()->tabletDimensions.x + x;
+    unsigned short y1 = AppState::getInstance()->tabletDimensions.y + y;
+    bool isPending = false;
+    if (!resolveTexture(&isPending)) {
+        if (isPending) {
+            batch.addPlaceholder(x1, y1, pixelsWidth, pixelsHeight);
+        }
+        return;
+    }
+    
+    batch.add(texture.textureId, x1, y1, pixelsWidth, pixelsHeight, rotationDegrees, texture.region.u1, texture.region.v1, texture.region.u2, texture.region.v2);
+}
+
+bool Image::resolveTexture(bool *isPending) {
+    if (texture.textureId) {
+        return true;
+    }
+    
+    return AssetCache::getInstance()->texture(assetId, &texture, isPending);
+}
+
+void Image::drawPlaceholder(unsigned short x1, unsigned short y1) {
+    XPLMSetGraphicsState(
+                         0, // No fog, equivalent to glDisable(GL_FOG);
+                         0, // No texture, equivalent to glDisable(GL_TEXTURE_2D);
+                         0, // No lighting, equivalent to glDisable(GL_LIGHT0);
+                         0, // No alpha testing, e.g glDisable(GL_ALPHA_TEST);
+                         1, // Use alpha blending, e.g. glEnable(GL_BLEND);
+                         0, // No depth read, e.g. glDisable(GL_DEPTH_TEST);
+                         0 // No depth write, e.g. glDepthMask(GL_FALSE);
+    );
+    
+    // A faint box where the image will appear, until it has been decoded.
+    float brightness = AppState::getInstance()->brightness;
+    glColor4f(brightness, brightness, brightness, 0.15f);
+    glBegin(GL_QUADS);
+    glVertex2f(x1, y1);
+    glVertex2f(x1, y1 + pixelsHeight);
+    glVertex2f(x1 + pixelsWidth, y1 + pixelsHeight);
+    glVertex2f(x1 + pixelsWidth, y1);
+    glEnd();
+}
+
 void Image::setPosition(float normalizedX, float normalizedY, unsigned short aRotationDegrees) {
     x = AppState::getInstance()->tabletDimensions.width * normalizedX;
     y = AppState::getInstance()->tabletDimensions.height * normalizedY;
@@ -1,11 +1,16 @@
 #ifndef IMAGE_H
 #define IMAGE_H
 
+#include "asset_cache.h"
+#include "sprite_batch.h"
 #include <string>
 
 class Image {
 private:
-    int textureId;
+    unsigned int assetId;
+    AssetTexture texture;
+    bool resolveTexture(bool *isPending);
+    void drawPlaceholder(unsigned short x1, unsigned short y1);
     
 protected:
     short x;
@@ -23,6 +28,8 @@ public:
     void destroy();
     void draw(unsigned short rotationDegrees);
     virtual void draw();
+    void addToBatch(SpriteBatch &batch, unsigned short rotationDegrees);
+    void addToBatch(SpriteBatch &batch);
     virtual void setPosition(float normalizedX, float normalizedY, unsigned short rotationDegrees = 0);
 };
 
@@ -21,7 +21,11 @@
 #define PRODUCT_NAME "avitab-browser"
 #define FRIENDLY_NAME "AviTab Browser"
 #define VERSION "1.0.7"
+#ifndef VERSION_CHECK_URL
 #define VERSION_CHECK_URL "https://api.github.com/repos/rswilem/avitab-browser/releases?per_page=1&page=1"
+#endif
+#define VERSION_CHECK_TIMEOUT_SECONDS 5
+#define VERSION_CHECK_CACHE_SECONDS (24 * 60 * 60)
 #define ALL_PLUGINS_DIRECTORY "/Resources/plugins/"
 #define PLUGIN_DIRECTORY (ALL_PLUGINS_DIRECTORY PRODUCT_NAME)
 #define BUNDLE_ID "com.ramonster." PRODUCT_NAME
@@ -33,3 +37,4 @@
 
 #define REFRESH_INTERVAL_SECONDS_FAST 0.1
 #define REFRESH_INTERVAL_SECONDS_SLOW 2.0
+#define REFRESH_INTERVAL_SECONDS_TABLET 0.25
@@ -0,0 +1,367 @@
+#include "asset_cache.h"
+#include "config.h"
+#include "hash.h"
+#include "path.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <XPLMGraphics.h>
+#include <XPLMUtilities.h>
+#include "lodepng.h"
+#define NANOSVG_IMPLEMENTATION
+#define NANOSVGRAST_IMPLEMENTATION
+#include "nanosvgrast.h"
+
+// Raster cache files are named after the hash of the SVG source and the raster size. They start with
+// this, followed by the width and height, so an edited file simply gets a new cache entry.
+static constexpr char rasterCacheMagic[4] = {'A', 'B', 'R', '2'};
+
+static bool isVectorFile(const std::string &filename) {
+    return filename.ends_with(".svg") || filename.ends_with(".SVG");
+}
+
+AssetCache* AssetCache::instance = nullptr;
+
+AssetCache::AssetCache() : atlas(512) {
+    nextId = 1;
+    stopping = false;
+    texturesPending = false;
+}
+
+AssetCache::~AssetCache() {
+    instance = nullptr;
+}
+
+AssetCache* AssetCache::getInstance() {
+    if (instance == nullptr) {
+        instance = new AssetCache();
+    }
+
+    return instance;
+}
+
+bool AssetCache::acquire(const std::string &filename, unsigned int rasterWidth, unsigned int rasterHeight, CachedAsset *asset) {
+    std::error_code error;
+    std::filesystem::file_time_type modifiedTime = std::filesystem::last_write_time(filename, error);
+    if (error) {
+        debug("Could not load image: %s\n", filename.c_str());
+        return false;
+    }
+
+    std::string key = filename + "@" + std::to_string(rasterWidth) + "x" + std::to_string(rasterHeight);
+    auto keyIt = keyIds.find(key);
+    if (keyIt != keyIds.end()) {
+        Entry &existing = entries[keyIt->second];
+        if (existing.refCount == 0 && existing.state != EntryDecoding && existing.modifiedTime != modifiedTime) {
+            // The file changed on disk since it was decoded, and nobody uses the old version anymore.
+            entries.erase(keyIt->second);
+            keyIds.erase(keyIt);
+            keyIt = keyIds.end();
+        }
+    }
+
+    if (keyIt == keyIds.end()) {
+        // The size is known up front, so layout doesn't have to wait for the decode.
+        unsigned int width = rasterWidth;
+        unsigned int height = rasterHeight;
+        if (!isVectorFile(filename) && !readSize(filename, &width, &height)) {
+            debug("Could not load image: %s\n", filename.c_str());
+            return false;
+        }
+
+        unsigned int id = nextId++;
+        entries[id] = {key, modifiedTime, EntryDecoding, width, height, {}, 0, false, {0.0f, 0.0f, 1.0f, 1.0f}, 0};
+        keyIt = keyIds.emplace(key, id).first;
+
+        {
+            std::lock_guard<std::mutex> lock(jobsMutex);
+            std::string rasterCacheDirectory;
+            if (isVectorFile(filename)) {
+                rasterCacheDirectory = Path::getInstance()->pluginDirectory + "/raster_cache";
+            }
+            pendingJobs.push_back({id, filename, rasterWidth, rasterHeight, rasterCacheDirectory, "", {}, 0});
+            if (workers.empty()) {
+                for (unsigned char i = 0; i < workerCount; ++i) {
+                    workers.emplace_back(&AssetCache::workerLoop, this);
+                }
+            }
+        }
+        jobsCondition.notify_one();
+    }
+
+    Entry &entry = entries[keyIt->second];
+    if (entry.state == EntryFailed) {
+        return false;
+    }
+
+    entry.refCount++;
+    if (entry.state == EntryReady && !entry.textureId && !entry.inAtlas) {
+        texturesPending = true;
+    }
+    *asset = {keyIt->second, entry.width, entry.height};
+    return true;
+}
+
+bool AssetCache::texture(unsigned int id, AssetTexture *texture, bool *isPending) {
+    auto it = entries.find(id);
+    if (it == entries.end()) {
+        *isPending = false;
+        return false;
+    }
+
+    Entry &entry = it->second;
+    int textureId = entry.inAtlas ? atlas.textureId : entry.textureId;
+    *isPending = entry.state == EntryDecoding || (entry.state == EntryReady && !textureId);
+    if (!textureId) {
+        return false;
+    }
+
+    *texture = {textureId, entry.region};
+    return true;
+}
+
+void AssetCache::release(unsigned int id) {
+    auto it = entries.find(id);
+    if (it == entries.end() || it->second.refCount == 0) {
+        return;
+    }
+
+    Entry &entry = it->second;
+    if (--entry.refCount > 0) {
+        return;
+    }
+
+    deleteTexture(entry);
+    if (entry.inAtlas) {
+        // Hand the slot back right away; update() packs the image again if it comes back.
+        atlas.remove(entry.region);
+        entry.inAtlas = false;
+        entry.region = {0.0f, 0.0f, 1.0f, 1.0f};
+    }
+}
+
+void AssetCache::update() {
+    std::vector<DecodeJob> jobs;
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        jobs.swap(finishedJobs);
+    }
+
+    // Decoded entries that were released and acquired again need their texture back too.
+    if (jobs.empty() && !texturesPending) {
+        return;
+    }
+    texturesPending = false;
+
+    for (auto &job : jobs) {
+        auto it = entries.find(job.id);
+        if (it == entries.end()) {
+            continue;
+        }
+
+        Entry &entry = it->second;
+        if (job.error) {
+            debug("Could not load image (code %i): %s\n", job.error, job.filename.c_str());
+            entry.state = EntryFailed;
+            continue;
+        }
+
+        entry.pixels = std::move(job.pixels);
+        entry.state = EntryReady;
+    }
+
+    for (auto &[id, entry] : entries) {
+        if (entry.state != EntryReady || entry.refCount == 0 || entry.textureId || entry.inAtlas) {
+            continue;
+        }
+
+        bool fitsAtlas = entry.width <= maximumAtlasImageSize && entry.height <= maximumAtlasImageSize;
+        if (fitsAtlas && atlas.add(entry.pixels.data(), entry.width, entry.height, &entry.region)) {
+            entry.inAtlas = true;
+        } else {
+            createTexture(entry);
+        }
+    }
+}
+
+void AssetCache::destroy() {
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        stopping = true;
+        pendingJobs.clear();
+    }
+    jobsCondition.notify_all();
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    for (auto &[id, entry] : entries) {
+        deleteTexture(entry);
+    }
+    atlas.destroy();
+
+    entries.clear();
+    keyIds.clear();
+    finishedJobs.clear();
+    stopping = false;
+    texturesPending = false;
+}
+
+void AssetCache::workerLoop() {
+    while (true) {
+        DecodeJob job;
+        {
+            std::unique_lock<std::mutex> lock(jobsMutex);
+            jobsCondition.wait(lock, [this]() {
+                return stopping || !pendingJobs.empty();
+            });
+
+            if (stopping) {
+                return;
+            }
+
+            job = std::move(pendingJobs.front());
+            pendingJobs.pop_front();
+        }
+
+        decode(job);
+
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        finishedJobs.push_back(std::move(job));
+    }
+}
+
+void AssetCache::decode(DecodeJob &job) {
+    // Runs on a worker thread: no XPLM or GL calls in here.
+    unsigned char *data = nullptr;
+    unsigned int width = 0;
+    unsigned int height = 0;
+    job.error = 1;
+    if (isVectorFile(job.filename)) {
+        // Reading the source is cheap next to parsing and rasterizing it, and its hash names the cached raster.
+        std::ifstream file(job.filename, std::ios::binary);
+        std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (!job.rasterCacheDirectory.empty()) {
+            job.rasterCacheFilename = job.rasterCacheDirectory + "/" + Hash::ToHex(Hash::Fnv1a(source)) + "_" + std::to_string(job.rasterWidth) + "x" + std::to_string(job.rasterHeight) + ".raw";
+            if (readRasterCache(job)) {
+                job.error = 0;
+                return;
+            }
+        }
+
+        // nanosvg parses in place.
+        NSVGimage *image = source.empty() ? nullptr : nsvgParse(source.data(), "px", 96);
+        if (image) {
+            struct NSVGrasterizer *rast = nsvgCreateRasterizer();
+            width = job.rasterWidth;
+            height = job.rasterHeight;
+            data = (unsigned char *)calloc(width * height, 4);
+            nsvgRasterize(rast, image, 0, 0, (float)width / image->width, data, width, height, width * 4);
+            nsvgDeleteRasterizer(rast);
+            nsvgDelete(image);
+            for (unsigned int i = 0; i < width * height * 4; i++) {
+                if (data[i] != 0) {
+                    job.error = 0;
+                    break;
+                }
+            }
+        }
+    }
+    else {
+        job.error = lodepng_decode32_file(&data, &width, &height, job.filename.c_str());
+    }
+
+    if (!job.error) {
+        job.pixels.assign(data, data + width * height * 4);
+        if (!job.rasterCacheFilename.empty()) {
+            writeRasterCache(job);
+        }
+    }
+    free(data);
+}
+
+bool AssetCache::readRasterCache(DecodeJob &job) {
+    std::ifstream file(job.rasterCacheFilename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    char magic[4];
+    unsigned int width = 0;
+    unsigned int height = 0;
+    file.read(magic, sizeof(magic));
+    file.read((char *)&width, sizeof(width));
+    file.read((char *)&height, sizeof(height));
+    if (!file || memcmp(magic, rasterCacheMagic, sizeof(magic)) != 0 || width != job.rasterWidth || height != job.rasterHeight) {
+        // Truncated or from another version; it is overwritten after rasterizing.
+        return false;
+    }
+
+    job.pixels.resize((size_t)width * height * 4);
+    file.read((char *)job.pixels.data(), job.pixels.size());
+    if (!file) {
+        job.pixels.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void AssetCache::writeRasterCache(const DecodeJob &job) {
+    std::error_code error;
+    std::filesystem::path path(job.rasterCacheFilename);
+    std::filesystem::create_directories(path.parent_path(), error);
+
+    // Write to a temporary file first, so a crash never leaves a truncated raster behind.
+    std::string temporaryPath = job.rasterCacheFilename + ".tmp" + std::to_string(job.id);
+    {
+        std::ofstream file(temporaryPath, std::ios::binary);
+        file.write(rasterCacheMagic, sizeof(rasterCacheMagic));
+        file.write((const char *)&job.rasterWidth, sizeof(job.rasterWidth));
+        file.write((const char *)&job.rasterHeight, sizeof(job.rasterHeight));
+        file.write((const char *)job.pixels.data(), job.pixels.size());
+        if (!file) {
+            file.close();
+            std::filesystem::remove(temporaryPath, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, path, error);
+}
+
+bool AssetCache::readSize(const std::string &filename, unsigned int *width, unsigned int *height) {
+    // The PNG signature is followed by the IHDR chunk, which starts with the big endian width and height.
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    unsigned char header[24];
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.read((char *)header, sizeof(header)) || memcmp(header, signature, sizeof(signature)) != 0 || memcmp(header + 12, "IHDR", 4) != 0) {
+        return false;
+    }
+
+    *width = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+    *height = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+    return *width > 0 && *height > 0;
+}
+
+void AssetCache::createTexture(Entry &entry) {
+    XPLMGenerateTextureNumbers(&entry.textureId, 1);
+    XPLMBindTexture2d(entry.textureId, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, entry.width, entry.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, entry.pixels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+void AssetCache::deleteTexture(Entry &entry) {
+    if (!entry.textureId) {
+        return;
+    }
+
+    XPLMBindTexture2d(entry.textureId, 0);
+    glDeleteTextures(1, (GLuint *)&entry.textureId);
+    entry.textureId = 0;
+}
@@ -0,0 +1,98 @@
+#ifndef ASSET_CACHE_H
+#define ASSET_CACHE_H
+
+#include <condition_variable>
+#include <deque>
+#include "texture_atlas.h"
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct CachedAsset {
+    unsigned int id;
+    unsigned int width;
+    unsigned int height;
+};
+
+struct AssetTexture {
+    int textureId;
+    AtlasRegion region;
+};
+
+// Shares decoded images and their textures between all Image instances, keyed by path and raster size.
+// Files are decoded on worker threads; the sim thread only creates the textures, in update().
+// Rasterized SVGs are also kept on disk, so later sessions skip parsing and rasterizing them.
+// Small images share one atlas texture, so they can be drawn together in a SpriteBatch.
+// A texture is deleted when its last user releases it, but the decoded pixels are kept, so reloading
+// the configuration or the aircraft doesn't decode the same files again.
+class AssetCache {
+private:
+    enum EntryState : unsigned char {
+        EntryDecoding = 0,
+        EntryReady,
+        EntryFailed,
+    };
+
+    struct Entry {
+        std::string key;
+        std::filesystem::file_time_type modifiedTime;
+        EntryState state;
+        unsigned int width;
+        unsigned int height;
+        std::vector<unsigned char> pixels;
+        int textureId;
+        bool inAtlas;
+        AtlasRegion region;
+        unsigned int refCount;
+    };
+
+    struct DecodeJob {
+        unsigned int id;
+        std::string filename;
+        unsigned int rasterWidth;
+        unsigned int rasterHeight;
+        std::string rasterCacheDirectory;
+        std::string rasterCacheFilename;
+        std::vector<unsigned char> pixels;
+        unsigned int error;
+    };
+
+    static constexpr unsigned char workerCount = 2;
+    static constexpr unsigned int maximumAtlasImageSize = 64;
+
+    AssetCache();
+    ~AssetCache();
+    static AssetCache* instance;
+    std::unordered_map<unsigned int, Entry> entries;
+    std::unordered_map<std::string, unsigned int> keyIds;
+    unsigned int nextId;
+    std::vector<std::thread> workers;
+    std::mutex jobsMutex;
+    std::condition_variable jobsCondition;
+    std::deque<DecodeJob> pendingJobs;
+    std::vector<DecodeJob> finishedJobs;
+    bool stopping;
+    bool texturesPending;
+    TextureAtlas atlas;
+    void workerLoop();
+    static void decode(DecodeJob &job);
+    static bool readRasterCache(DecodeJob &job);
+    static void writeRasterCache(const DecodeJob &job);
+    static bool readSize(const std::string &filename, unsigned int *width, unsigned int *height);
+    void createTexture(Entry &entry);
+    void deleteTexture(Entry &entry);
+
+public:
+    static AssetCache* getInstance();
+
+    bool acquire(const std::string &filename, unsigned int rasterWidth, unsigned int rasterHeight, CachedAsset *asset);
+    bool texture(unsigned int id, AssetTexture *texture, bool *isPending);
+    void release(unsigned int id);
+    void update();
+    void destroy();
+};
+
+#endif
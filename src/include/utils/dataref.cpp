@@ -1,13 +1,134 @@
 #include "dataref.h"
 #include "config.h"
 #include "appstate.h"
+#include "trace.h"
 #include <XPLMUtilities.h>
 #include <XPLMDisplay.h>
+#include <algorithm>
+#include <bit>
+#include <deque>
+#include <string_view>
 
 using namespace std;
 
 Dataref *Dataref::instance = nullptr;
 
+struct DatarefKeyRegistry {
+    // The deque never moves its strings, so the ids can be keyed by views into it
+    // and looking up a known name doesn't allocate.
+    std::deque<std::string> names;
+    std::unordered_map<std::string_view, unsigned int> ids;
+};
+
+static DatarefKeyRegistry& keyRegistry() {
+    // Function-local, so keys can safely be created during static initialization.
+    static DatarefKeyRegistry registry;
+    return registry;
+}
+
+DatarefKey::DatarefKey(const char *name) {
+    DatarefKeyRegistry& registry = keyRegistry();
+    auto it = registry.ids.find(std::string_view(name));
+    if (it != registry.ids.end()) {
+        id = it->second;
+        return;
+    }
+    
+    id = (unsigned int)registry.names.size();
+    registry.ids[registry.names.emplace_back(name)] = id;
+}
+
+const char *DatarefKey::name() const {
+    return keyRegistry().names[id].c_str();
+}
+
+bool DatarefKey::find(const char *name, unsigned int *id) {
+    DatarefKeyRegistry& registry = keyRegistry();
+    auto it = registry.ids.find(std::string_view(name));
+    if (it == registry.ids.end()) {
+        return false;
+    }
+    
+    *id = it->second;
+    return true;
+}
+
+template <typename T> using SnapshotValueType = std::conditional_t<std::is_same_v<T, bool>, int, T>;
+
+template <typename T> constexpr DatarefSnapshotType SnapshotTypeOf = SnapshotInt;
+template <> constexpr DatarefSnapshotType SnapshotTypeOf<float> = SnapshotFloat;
+template <> constexpr DatarefSnapshotType SnapshotTypeOf<double> = SnapshotDouble;
+template <> constexpr DatarefSnapshotType SnapshotTypeOf<std::string> = SnapshotString;
+template <> constexpr DatarefSnapshotType SnapshotTypeOf<std::vector<int>> = SnapshotIntArray;
+
+template <typename T>
+static T defaultValue() {
+    if constexpr (std::is_same<T, std::string>::value) {
+        return "";
+    }
+    else if constexpr (std::is_same<T, std::vector<int>>::value) {
+        return {};
+    }
+    else {
+        return 0;
+    }
+}
+
+template <typename T>
+static T readValue(XPLMDataRef handle) {
+    if constexpr (std::is_same<T, int>::value) {
+        return XPLMGetDatai(handle);
+    }
+    else if constexpr (std::is_same<T, bool>::value) {
+        return XPLMGetDatai(handle) > 0;
+    }
+    else if constexpr (std::is_same<T, float>::value) {
+        return XPLMGetDataf(handle);
+    }
+    else if constexpr (std::is_same<T, double>::value) {
+        return XPLMGetDatad(handle);
+    }
+    else if constexpr (std::is_same<T, std::vector<int>>::value) {
+        int size = XPLMGetDatavi(handle, nullptr, 0, 0);
+        std::vector<int> outValues(size);
+        XPLMGetDatavi(handle, outValues.data(), 0, size);
+        return outValues;
+    }
+    else if constexpr (std::is_same<T, std::string>::value) {
+        int size = XPLMGetDatab(handle, nullptr, 0, 0);
+        std::string value(size, '\0');
+        XPLMGetDatab(handle, value.data(), 0, size);
+        return std::string(value.c_str());
+    }
+    
+    return defaultValue<T>();
+}
+
+template <>
+DatarefSnapshotColumn<int>& Dataref::column<int>() {
+    return intColumn;
+}
+
+template <>
+DatarefSnapshotColumn<float>& Dataref::column<float>() {
+    return floatColumn;
+}
+
+template <>
+DatarefSnapshotColumn<double>& Dataref::column<double>() {
+    return doubleColumn;
+}
+
+template <>
+DatarefSnapshotColumn<std::string>& Dataref::column<std::string>() {
+    return stringColumn;
+}
+
+template <>
+DatarefSnapshotColumn<std::vector<int>>& Dataref::column<std::vector<int>>() {
+    return intArrayColumn;
+}
+
 int handleCommandCallback(XPLMCommandRef inCommand, XPLMCommandPhase inPhase, void *inRefcon) {
     return Dataref::getInstance()->_commandCallback(inCommand, inPhase, inRefcon);
 }
@@ -18,6 +139,7 @@ Dataref::Dataref() {
     lastWindowX = 0;
     lastWindowY = 0;
     lastViewHeading = 0;
+    lastResolveTime = std::chrono::steady_clock::now();
 }
 
 Dataref::~Dataref() {
@@ -193,37 +315,19 @@ template void Dataref::monitorExistingDataref<double>(const char* ref, DatarefMo
 template void Dataref::monitorExistingDataref<std::string>(const char* ref, DatarefMonitorChangedCallback<std::string> changeCallback);
 template <typename T>
 void Dataref::monitorExistingDataref(const char* ref, DatarefMonitorChangedCallback<T> changeCallback) {
-    if constexpr (std::is_same<T, std::string>::value) {
-        set<T>(ref, "", true);
-    }
-    else {
-        set<T>(ref, 0, true);
+    using ValueType = SnapshotValueType<T>;
+    
+    DatarefKey key(ref);
+    DatarefSnapshotSlot slot;
+    if (!findSlot<ValueType>(key, &slot)) {
+        slot = createSlot<ValueType>(key, false);
     }
     
-    boundRefs[ref] = {
-        0,
-        nullptr,
-        [changeCallback](DataRefValueType newValue) -> bool {
-            if constexpr (std::is_same_v<T, std::string>) {
-                if (std::holds_alternative<std::string>(newValue)) {
-                    changeCallback(std::get<std::string>(newValue));
-                }
-            } else if constexpr (std::is_same_v<T, int> || std::is_same_v<T, bool>) {
-                if (std::holds_alternative<int>(newValue)) {
-                    changeCallback(std::get<int>(newValue));
-                }
-            } else if constexpr (std::is_same_v<T, float>) {
-                if (std::holds_alternative<float>(newValue)) {
-                    changeCallback(std::get<float>(newValue));
-                }
-            } else if constexpr (std::is_same_v<T, double>) {
-                if (std::holds_alternative<double>(newValue)) {
-                    changeCallback(std::get<double>(newValue));
-                }
-            }
-            
-            return false;
-        }
+    // Start from the default value, so the first update() reports the current value to the callback.
+    DatarefSnapshotColumn<ValueType>& snapshotColumn = column<ValueType>();
+    snapshotColumn.values[slot.index] = defaultValue<ValueType>();
+    snapshotColumn.callbacks[slot.index] = [changeCallback](ValueType newValue) {
+        changeCallback(newValue);
     };
 }
 
@@ -233,6 +337,12 @@ void Dataref::destroyAllBindings(){
     }
     boundRefs.clear();
     
+    std::fill(intColumn.callbacks.begin(), intColumn.callbacks.end(), nullptr);
+    std::fill(floatColumn.callbacks.begin(), floatColumn.callbacks.end(), nullptr);
+    std::fill(doubleColumn.callbacks.begin(), doubleColumn.callbacks.end(), nullptr);
+    std::fill(stringColumn.callbacks.begin(), stringColumn.callbacks.end(), nullptr);
+    std::fill(intArrayColumn.callbacks.begin(), intArrayColumn.callbacks.end(), nullptr);
+    
     for (auto& [key, ref] : boundCommands) {
         XPLMUnregisterCommandHandler(ref.handle, handleCommandCallback, 1, nullptr);
     }
@@ -248,6 +358,19 @@ void Dataref::unbind(const char *ref) {
         boundRefs.erase(it);
     }
     
+    unsigned int id;
+    if (DatarefKey::find(ref, &id) && id < snapshotSlots.size()) {
+        unsigned int index = snapshotSlots[id].index;
+        switch (snapshotSlots[id].type) {
+            case SnapshotInt: intColumn.callbacks[index] = nullptr; break;
+            case SnapshotFloat: floatColumn.callbacks[index] = nullptr; break;
+            case SnapshotDouble: doubleColumn.callbacks[index] = nullptr; break;
+            case SnapshotString: stringColumn.callbacks[index] = nullptr; break;
+            case SnapshotIntArray: intArrayColumn.callbacks[index] = nullptr; break;
+            default: break;
+        }
+    }
+    
     auto it2 = boundCommands.find(ref);
     if (it2 != boundCommands.end()) {
         XPLMUnregisterCommandHandler(it2->second.handle, handleCommandCallback, 1, nullptr);
@@ -256,21 +379,110 @@ void Dataref::unbind(const char *ref) {
 }
 
 void Dataref::update() {
-    for (auto& [key, data] : cachedValues) {
-        std::visit([&](auto&& value) {
-            using T = std::decay_t<decltype(value)>;
-            T newValue = get<T>(key.c_str());
-            bool didChange = value != newValue;
-            cachedValues[key] = newValue;
+    TRACE_SCOPE("Dataref::update");
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastResolveTime > std::chrono::seconds(1)) {
+        // Refs created by other plugins may show up later, retry the unresolved ones once per second.
+        lastResolveTime = now;
+        resolveColumn(intColumn);
+        resolveColumn(floatColumn);
+        resolveColumn(doubleColumn);
+        resolveColumn(stringColumn);
+        resolveColumn(intArrayColumn);
+    }
+    
+    readColumn(intColumn);
+    readColumn(floatColumn);
+    readColumn(doubleColumn);
+    readColumn(stringColumn);
+    readColumn(intArrayColumn);
+    
+    dispatchChanges(intColumn);
+    dispatchChanges(floatColumn);
+    dispatchChanges(doubleColumn);
+    dispatchChanges(stringColumn);
+    dispatchChanges(intArrayColumn);
+}
+
+template <typename T>
+void Dataref::readColumn(DatarefSnapshotColumn<T>& snapshotColumn) {
+    std::fill(snapshotColumn.changed.begin(), snapshotColumn.changed.end(), 0);
+    
+    size_t count = snapshotColumn.handles.size();
+    for (size_t i = 0; i < count; ++i) {
+        XPLMDataRef handle = snapshotColumn.handles[i];
+        if (!handle) {
+            continue;
+        }
+        
+        T newValue = readValue<T>(handle);
+        if (newValue != snapshotColumn.values[i]) {
+            snapshotColumn.values[i] = std::move(newValue);
+            snapshotColumn.changed[i / 64] |= 1ULL << (i % 64);
+        }
+    }
+}
+
+template <typename T>
+void Dataref::dispatchChanges(DatarefSnapshotColumn<T>& snapshotColumn) {
+    for (size_t word = 0; word < snapshotColumn.changed.size(); ++word) {
+        uint64_t bits = snapshotColumn.changed[word];
+        while (bits) {
+            size_t i = word * 64 + std::countr_zero(bits);
+            bits &= bits - 1;
             
-            if (didChange) {
-                auto it = boundRefs.find(key);
-                if (it != boundRefs.end()) {
-                    boundRefs[key].changeCallback(cachedValues[key]);
-                }
+            if (!snapshotColumn.callbacks[i]) {
+                continue;
             }
-        }, data);
+            
+            // Callbacks may add refs to this column, so don't hold references into it.
+            auto callback = snapshotColumn.callbacks[i];
+            T value = snapshotColumn.values[i];
+            callback(value);
+        }
+    }
+}
+
+template <typename T>
+void Dataref::resolveColumn(DatarefSnapshotColumn<T>& snapshotColumn) {
+    for (size_t i = 0; i < snapshotColumn.handles.size(); ++i) {
+        if (!snapshotColumn.handles[i]) {
+            snapshotColumn.handles[i] = XPLMFindDataRef(snapshotColumn.names[i].c_str());
+        }
+    }
+}
+
+template <typename T>
+bool Dataref::findSlot(const DatarefKey& key, DatarefSnapshotSlot* slot) {
+    if (key.id >= snapshotSlots.size() || snapshotSlots[key.id].type != SnapshotTypeOf<T>) {
+        return false;
+    }
+    
+    *slot = snapshotSlots[key.id];
+    return true;
+}
+
+template <typename T>
+DatarefSnapshotSlot Dataref::createSlot(const DatarefKey& key, bool readInitialValue) {
+    const char *ref = key.name();
+    DatarefSnapshotColumn<T>& snapshotColumn = column<T>();
+    XPLMDataRef handle = XPLMFindDataRef(ref);
+    if (!handle) {
+        debug("Dataref not found: '%s'\n", ref);
     }
+    
+    DatarefSnapshotSlot slot = {SnapshotTypeOf<T>, (unsigned int)snapshotColumn.handles.size()};
+    snapshotColumn.names.push_back(ref);
+    snapshotColumn.handles.push_back(handle);
+    snapshotColumn.values.push_back(readInitialValue && handle ? readValue<T>(handle) : defaultValue<T>());
+    snapshotColumn.callbacks.push_back(nullptr);
+    snapshotColumn.changed.resize((snapshotColumn.handles.size() + 63) / 64, 0);
+    if (key.id >= snapshotSlots.size()) {
+        snapshotSlots.resize(key.id + 1, {SnapshotUnused, 0});
+    }
+    snapshotSlots[key.id] = slot;
+    
+    return slot;
 }
 
 bool Dataref::getMouse(float *normalizedX, float *normalizedY, float windowX, float windowY) {
@@ -333,26 +545,26 @@ template float Dataref::getCached<float>(const char* ref);
 template std::string Dataref::getCached<std::string>(const char* ref);
 template <typename T>
 T Dataref::getCached(const char *ref) {
-    auto it = cachedValues.find(ref);
-    if (it == cachedValues.end()) {
-        auto val = get<T>(ref);
-        cachedValues[ref] = val;
-        return val;
-    }
-    
-    if (!std::holds_alternative<T>(it->second)) {
-        if constexpr (std::is_same<T, std::string>::value) {
-            return "";
-        }
-        else if constexpr (std::is_same<T, std::vector<int>>::value) {
-            return {};
-        }
-        else {
-            return 0;
+    return getCached<T>(DatarefKey(ref));
+}
+
+template int Dataref::getCached<int>(const DatarefKey& key);
+template std::vector<int> Dataref::getCached<std::vector<int>>(const DatarefKey& key);
+template float Dataref::getCached<float>(const DatarefKey& key);
+template std::string Dataref::getCached<std::string>(const DatarefKey& key);
+template <typename T>
+T Dataref::getCached(const DatarefKey& key) {
+    DatarefSnapshotSlot slot;
+    if (!findSlot<T>(key, &slot)) {
+        if (key.id < snapshotSlots.size() && snapshotSlots[key.id].type != SnapshotUnused) {
+            // Already cached as a different type.
+            return defaultValue<T>();
         }
+        
+        slot = createSlot<T>(key, true);
     }
     
-    return std::get<T>(it->second);
+    return column<T>().values[slot.index];
 }
 
 template float Dataref::get<float>(const char* ref);
@@ -362,50 +574,30 @@ template std::vector<int> Dataref::get<std::vector<int>>(const char* ref);
 template std::string Dataref::get<std::string>(const char* ref);
 template <typename T>
 T Dataref::get(const char *ref) {
-    XPLMDataRef handle = findRef(ref);
+    return get<T>(DatarefKey(ref));
+}
+
+template float Dataref::get<float>(const DatarefKey& key);
+template int Dataref::get<int>(const DatarefKey& key);
+template bool Dataref::get<bool>(const DatarefKey& key);
+template std::vector<int> Dataref::get<std::vector<int>>(const DatarefKey& key);
+template std::string Dataref::get<std::string>(const DatarefKey& key);
+template <typename T>
+T Dataref::get(const DatarefKey& key) {
+    XPLMDataRef handle = key.id < keyRefs.size() ? keyRefs[key.id] : nullptr;
     if (!handle) {
-        if constexpr (std::is_same<T, std::string>::value) {
-            return "";
+        handle = findRef(key.name());
+        if (!handle) {
+            return defaultValue<T>();
         }
-        else if constexpr (std::is_same<T, std::vector<int>>::value) {
-            return {};
-        }
-        else {
-            return 0;
+        
+        if (key.id >= keyRefs.size()) {
+            keyRefs.resize(key.id + 1, nullptr);
         }
+        keyRefs[key.id] = handle;
     }
     
-    if constexpr (std::is_same<T, int>::value) {
-        return XPLMGetDatai(handle);
-    }
-    else if constexpr (std::is_same<T, bool>::value) {
-        return XPLMGetDatai(handle) > 0;
-    }
-    else if constexpr (std::is_same<T, float>::value) {
-        return XPLMGetDataf(handle);
-    }
-    else if constexpr (std::is_same<T, std::vector<int>>::value) {
-        int size = XPLMGetDatavi(handle, nullptr, 0, 0);
-        std::vector<int> outValues(size);
-        XPLMGetDatavi(handle, outValues.data(), 0, size);
-        return outValues;
-    }
-    else if constexpr (std::is_same<T, std::string>::value) {
-        int size = XPLMGetDatab(handle, nullptr, 0, 0);
-        char str[size];
-        XPLMGetDatab(handle, &str, 0, size);
-        return std::string(str);
-    }
-    
-    if constexpr (std::is_same<T, std::string>::value) {
-        return "";
-    }
-    else if constexpr (std::is_same<T, std::vector<int>>::value) {
-        return {};
-    }
-    else {
-        return 0;
-    }
+    return readValue<T>(handle);
 }
 
 template void Dataref::set<float>(const char* ref, float value, bool setCacheOnly);
@@ -413,14 +605,23 @@ template void Dataref::set<int>(const char* ref, int value, bool setCacheOnly);
 template void Dataref::set<std::string>(const char* ref, std::string value, bool setCacheOnly);
 template <typename T>
 void Dataref::set(const char* ref, T value, bool setCacheOnly) {
-    XPLMDataRef handle = findRef(ref);
-    if (!handle) {
-        return;
+    set<T>(DatarefKey(ref), value, setCacheOnly);
+}
+
+template void Dataref::set<float>(const DatarefKey& key, float value, bool setCacheOnly);
+template void Dataref::set<int>(const DatarefKey& key, int value, bool setCacheOnly);
+template void Dataref::set<std::string>(const DatarefKey& key, std::string value, bool setCacheOnly);
+template <typename T>
+void Dataref::set(const DatarefKey& key, T value, bool setCacheOnly) {
+    DatarefSnapshotSlot slot;
+    if (!findSlot<T>(key, &slot)) {
+        slot = createSlot<T>(key, false);
     }
+    DatarefSnapshotColumn<T>& snapshotColumn = column<T>();
+    snapshotColumn.values[slot.index] = value;
     
-    cachedValues[ref] = value;
-    
-    if (setCacheOnly) {
+    XPLMDataRef handle = snapshotColumn.handles[slot.index];
+    if (setCacheOnly || !handle) {
         return;
     }
     
@@ -430,6 +631,9 @@ void Dataref::set(const char* ref, T value, bool setCacheOnly) {
     else if constexpr (std::is_same<T, float>::value) {
         XPLMSetDataf(handle, value);
     }
+    else if constexpr (std::is_same<T, double>::value) {
+        XPLMSetDatad(handle, value);
+    }
     else if constexpr (std::is_same<T, std::string>::value) {
         XPLMSetDatab(handle, (char *)value.c_str(), 0, (unsigned int)value.length());
     }
@@ -1,6 +1,8 @@
 #ifndef DATAREF_H
 #define DATAREF_H
 
+#include <chrono>
+#include <cstdint>
 #include <unordered_map>
 #include <variant>
 #include <string>
@@ -18,6 +20,40 @@ struct BoundRef {
     DatarefShouldChangeCallback<DataRefValueType> changeCallback;
 };
 
+enum DatarefSnapshotType : unsigned char {
+    SnapshotInt = 0,
+    SnapshotFloat,
+    SnapshotDouble,
+    SnapshotString,
+    SnapshotIntArray,
+    SnapshotUnused,
+};
+
+struct DatarefSnapshotSlot {
+    DatarefSnapshotType type;
+    unsigned int index;
+};
+
+// One dense column per value type. Refs are resolved once, read in a single pass per update()
+// and compared against the previous values, marking differences in the changed bitmask.
+template <typename T> struct DatarefSnapshotColumn {
+    std::vector<std::string> names;
+    std::vector<XPLMDataRef> handles;
+    std::vector<T> values;
+    std::vector<uint64_t> changed;
+    std::vector<DatarefMonitorChangedCallback<T>> callbacks;
+};
+
+// Interned dataref name. Create keys once, e.g. as file-scope statics, and use them on hot paths:
+// lookups through a key are an array index instead of hashing the name on every call.
+class DatarefKey {
+public:
+    DatarefKey(const char *name);
+    unsigned int id;
+    const char *name() const;
+    static bool find(const char *name, unsigned int *id);
+};
+
 typedef std::function<void(XPLMCommandPhase inPhase)> CommandExecutedCallback;
 struct BoundCommand {
     XPLMCommandRef handle;
@@ -32,8 +68,21 @@ private:
     std::unordered_map<std::string, BoundRef> boundRefs;
     std::unordered_map<std::string, BoundCommand> boundCommands;
     std::unordered_map<std::string, XPLMDataRef> refs;
-    std::unordered_map<std::string, DataRefValueType> cachedValues;
+    std::vector<DatarefSnapshotSlot> snapshotSlots;
+    std::vector<XPLMDataRef> keyRefs;
+    DatarefSnapshotColumn<int> intColumn;
+    DatarefSnapshotColumn<float> floatColumn;
+    DatarefSnapshotColumn<double> doubleColumn;
+    DatarefSnapshotColumn<std::string> stringColumn;
+    DatarefSnapshotColumn<std::vector<int>> intArrayColumn;
+    std::chrono::steady_clock::time_point lastResolveTime;
     XPLMDataRef findRef(const char* ref);
+    template <typename T> DatarefSnapshotColumn<T>& column();
+    template <typename T> bool findSlot(const DatarefKey& key, DatarefSnapshotSlot* slot);
+    template <typename T> DatarefSnapshotSlot createSlot(const DatarefKey& key, bool readInitialValue);
+    template <typename T> void readColumn(DatarefSnapshotColumn<T>& column);
+    template <typename T> void dispatchChanges(DatarefSnapshotColumn<T>& column);
+    template <typename T> void resolveColumn(DatarefSnapshotColumn<T>& column);
     float lastMouseX;
     float lastMouseY;
     int lastWindowX;
@@ -56,8 +105,11 @@ public:
     bool getMouse(float *normalizedX, float *normalizedY, float windowX = 0, float windowY = 0);
     bool exists(const char *ref);
     template <typename T> T getCached(const char *ref);
+    template <typename T> T getCached(const DatarefKey& key);
     template <typename T> T get(const char *ref);
+    template <typename T> T get(const DatarefKey& key);
     template <typename T> void set(const char* ref, T value, bool setCacheOnly = false);
+    template <typename T> void set(const DatarefKey& key, T value, bool setCacheOnly = false);
     
     void executeCommand(const char *command, XPLMCommandPhase phase = -1);
 };
@@ -2,6 +2,7 @@
 
 #include "appstate.h"
 #include "config.h"
+#include "lru_cache.h"
 
 #include <algorithm>
 #include <cmath>
@@ -33,63 +34,89 @@ void Drawing::DrawRect(float x1, float y1, float x2, float y2) {
 }
 
 void Drawing::DrawRoundedRect(float x1, float y1, float x2, float y2, float radius) {
-    constexpr int cornerSegments = 16;
-    glBegin(GL_QUADS);
-    glVertex2f(AbsoluteX(x1) + radius, AbsoluteY(y1));
-    glVertex2f(AbsoluteX(x1) + radius, AbsoluteY(y2));
-    glVertex2f(AbsoluteX(x2) - radius, AbsoluteY(y2));
-    glVertex2f(AbsoluteX(x2) - radius, AbsoluteY(y1));
-    glEnd();
+    const std::vector<float> &vertices = RoundedRectVertices(AbsoluteX(x1), AbsoluteY(y1), AbsoluteX(x2), AbsoluteY(y2), radius);
 
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(AbsoluteX(x1) + radius, AbsoluteY(y2) - radius);
-    for (int i = 0; i <= cornerSegments; ++i) {
-        float angle = (M_PI_2 * 2.0f) + i * (M_PI_2 / cornerSegments);
-        glVertex2f(AbsoluteX(x1) + radius + cos(angle) * radius, AbsoluteY(y2) - radius - sin(angle) * radius);
-    }
-    glEnd();
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, vertices.data());
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei) (vertices.size() / 2));
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
 
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(AbsoluteX(x2) - radius, AbsoluteY(y2) - radius);
-    for (int i = 0; i <= cornerSegments; ++i) {
-        float angle = (M_PI_2 * 3.0f) + i * (M_PI_2 / cornerSegments);
-        glVertex2f(AbsoluteX(x2) - radius + cos(angle) * radius, AbsoluteY(y2) - radius - sin(angle) * radius);
-    }
-    glEnd();
+const std::vector<float> &Drawing::RoundedRectVertices(float left, float bottom, float right, float top, float radius) {
+    static std::vector<RoundedRectGeometry> cache;
+    static unsigned int useCounter = 0;
+    useCounter++;
 
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(AbsoluteX(x1) + radius, AbsoluteY(y1) + radius);
-    for (int i = 0; i <= cornerSegments; ++i) {
-        float angle = (M_PI_2 * 1.0f) + i * (M_PI_2 / cornerSegments);
-        glVertex2f(AbsoluteX(x1) + radius + cos(angle) * radius, AbsoluteY(y1) + radius - sin(angle) * radius);
-    }
-    glEnd();
+    RoundedRectGeometry *leastRecentlyUsed = nullptr;
+    for (auto &geometry : cache) {
+        if (geometry.left == left && geometry.bottom == bottom && geometry.right == right && geometry.top == top && geometry.radius == radius) {
+            geometry.lastUsed = useCounter;
+            return geometry.vertices;
+        }
 
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(AbsoluteX(x2) - radius, AbsoluteY(y1) + radius);
-    for (int i = 0; i <= cornerSegments; ++i) {
-        float angle = (M_PI_2 * 0.0f) + i * (M_PI_2 / cornerSegments);
-        glVertex2f(AbsoluteX(x2) - radius + cos(angle) * radius, AbsoluteY(y1) + radius - sin(angle) * radius);
+        if (!leastRecentlyUsed || geometry.lastUsed < leastRecentlyUsed->lastUsed) {
+            leastRecentlyUsed = &geometry;
+        }
     }
-    glEnd();
 
-    glLineWidth(2);
-    int numPasses = ceil(radius / 2.0f);
-    for (int i = 0; i < numPasses; ++i) {
-        float offset = i * 2.0f + 1.0f;
-
-        // Draw lines on the left
-        glBegin(GL_LINES);
-        glVertex2f(roundf(AbsoluteX(x1) + offset), AbsoluteY(y1) + radius);
-        glVertex2f(roundf(AbsoluteX(x1) + offset), AbsoluteY(y2) - radius);
-        glEnd();
-
-        // Draw lines on the right
-        glBegin(GL_LINES);
-        glVertex2f(roundf(AbsoluteX(x2) - offset), AbsoluteY(y2) - radius);
-        glVertex2f(roundf(AbsoluteX(x2) - offset), AbsoluteY(y1) + radius);
-        glEnd();
+    // Shapes are only tessellated when they appear or change size.
+    RoundedRectGeometry *geometry = leastRecentlyUsed;
+    if (cache.size() < maximumCachedShapes) {
+        geometry = &cache.emplace_back();
     }
+
+    // Reuse the evicted shape's vertex storage; every rounded rect has the same vertex count.
+    geometry->left = left;
+    geometry->bottom = bottom;
+    geometry->right = right;
+    geometry->top = top;
+    geometry->radius = radius;
+    geometry->lastUsed = useCounter;
+    TessellateRoundedRect(geometry->vertices, left, bottom, right, top, radius);
+    return geometry->vertices;
+}
+
+void Drawing::TessellateRoundedRect(std::vector<float> &vertices, float left, float bottom, float right, float top, float radius) {
+    // Unit quarter circle, shared by all corners.
+    static const auto quarterCircle = []() {
+        std::array<std::array<float, 2>, cornerSegments + 1> points;
+        for (int i = 0; i <= cornerSegments; ++i) {
+            float angle = i * (M_PI_2 / cornerSegments);
+            points[i] = {cosf(angle), sinf(angle)};
+        }
+        return points;
+    }();
+
+    // Every shape has the same vertex count, so the storage is sized once and filled in place.
+    vertices.resize((3 * 2 + 4 * cornerSegments) * 3 * 2);
+    float *vertex = vertices.data();
+
+    auto addRect = [&vertex](float rectLeft, float rectBottom, float rectRight, float rectTop) {
+        const float rect[12] = {rectLeft, rectBottom, rectLeft, rectTop, rectRight, rectTop, rectLeft, rectBottom, rectRight, rectTop, rectRight, rectBottom};
+        for (float value : rect) {
+            *vertex++ = value;
+        }
+    };
+
+    auto addCorner = [&vertex](float centerX, float centerY, float directionX, float directionY, float radius) {
+        for (int i = 0; i < cornerSegments; ++i) {
+            *vertex++ = centerX;
+            *vertex++ = centerY;
+            *vertex++ = centerX + directionX * quarterCircle[i][0] * radius;
+            *vertex++ = centerY + directionY * quarterCircle[i][1] * radius;
+            *vertex++ = centerX + directionX * quarterCircle[i + 1][0] * radius;
+            *vertex++ = centerY + directionY * quarterCircle[i + 1][1] * radius;
+        }
+    };
+
+    // Full height middle, the sides between the corners, and a quarter circle in every corner.
+    addRect(left + radius, bottom, right - radius, top);
+    addRect(left, bottom + radius, left + radius, top - radius);
+    addRect(right - radius, bottom + radius, right, top - radius);
+    addCorner(left + radius, top - radius, -1.0f, 1.0f, radius);
+    addCorner(right - radius, top - radius, 1.0f, 1.0f, radius);
+    addCorner(left + radius, bottom + radius, -1.0f, -1.0f, radius);
+    addCorner(right - radius, bottom + radius, 1.0f, -1.0f, radius);
 }
 
 std::vector<std::string> Drawing::SplitTextToWords(const std::string &text) {
@@ -123,42 +150,62 @@ std::vector<std::string> Drawing::SplitTextToWords(const std::string &text) {
 }
 
 std::vector<std::string> Drawing::WrapWordsToLines(XPLMFontID font, const std::string &text, float normalizedWidth) {
+    // Line breaks only depend on the font, the text and the width in pixels, so repeated layouts are a lookup.
+    static LruCache<std::vector<std::string>> cache(maximumCachedTexts);
+    float widthPixels = AppState::getInstance()->tabletDimensions.width * normalizedWidth;
+    std::string key = std::to_string(font) + "|" + std::to_string(widthPixels) + "|" + text;
+    if (const auto *cachedLines = cache.find(key)) {
+        return *cachedLines;
+    }
+
     std::vector<std::string> words = SplitTextToWords(text);
-    float spaceWidth = XPLMMeasureString(font, " ", 1);
+    float spaceWidth = MeasureString(font, " ");
     float spaceLeft = 0;
+    // Whether words still go onto the last line; a word that fills it exactly leaves no space but keeps it open.
+    bool lineOpen = false;
     std::vector<std::string> lines;
     for (const std::string &word : words) {
         if (word == "\n") {
-            if (spaceLeft == 0) {
+            if (!lineOpen) {
                 lines.push_back("");
-            } else {
-                spaceLeft = 0;
             }
+            lineOpen = false;
             continue;
         }
 
-        float wordWidth = XPLMMeasureString(font, word.c_str(), (int) word.size());
+        float wordWidth = MeasureString(font, word);
 
-        if (wordWidth + spaceWidth <= spaceLeft) {
+        if (lineOpen && wordWidth + spaceWidth <= spaceLeft) {
             lines.back() += " ";
             lines.back() += word;
 
             spaceLeft -= wordWidth + spaceWidth;
         } else {
             lines.push_back(word);
-            float widthPixels = AppState::getInstance()->tabletDimensions.width * normalizedWidth;
             spaceLeft = widthPixels - wordWidth;
+            lineOpen = true;
         }
     }
 
-    return lines;
+    return cache.insert(key, std::move(lines));
 }
 
 float Drawing::TextWidth(std::string text, float scale) {
-    float textWidth = XPLMMeasureString(xplmFont_Proportional, text.c_str(), (int) text.length()) * scale;
+    float textWidth = MeasureString(xplmFont_Proportional, text) * scale;
     return textWidth / AppState::getInstance()->tabletDimensions.width;
 }
 
+float Drawing::MeasureString(XPLMFontID font, const std::string &text) {
+    // DrawText measures its text on every frame; titles and labels rarely change.
+    static LruCache<float> cache(maximumCachedTexts);
+    std::string key = std::to_string(font) + "|" + text;
+    if (const float *width = cache.find(key)) {
+        return *width;
+    }
+
+    return cache.insert(key, XPLMMeasureString(font, text.c_str(), (int) text.length()));
+}
+
 float Drawing::DrawText(std::string text, float x, float y, float scale, std::array<float, 3> color) {
     float textWidth = TextWidth(text, scale);
 
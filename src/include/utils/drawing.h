@@ -6,10 +6,26 @@
 #include <string>
 #include <array>
 
+struct RoundedRectGeometry {
+    float left;
+    float bottom;
+    float right;
+    float top;
+    float radius;
+    unsigned int lastUsed;
+    std::vector<float> vertices;
+};
+
 class Drawing {
 private:
+    static constexpr int cornerSegments = 16;
+    static constexpr size_t maximumCachedShapes = 128;
+    static constexpr size_t maximumCachedTexts = 256;
     static float AbsoluteX(float normalizedX);
     static float AbsoluteY(float normalizedY);
+    static const std::vector<float> &RoundedRectVertices(float left, float bottom, float right, float top, float radius);
+    static void TessellateRoundedRect(std::vector<float> &vertices, float left, float bottom, float right, float top, float radius);
+    static float MeasureString(XPLMFontID font, const std::string &text);
 public:
     static void DrawLine(float x1, float y1, float x2, float y2, float thickness);
     static void DrawRect(float x1, float y1, float x2, float y2);
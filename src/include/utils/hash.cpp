@@ -0,0 +1,23 @@
+#include "hash.h"
+
+#include <cstdio>
+
+uint64_t Hash::Fnv1a(const void *data, size_t length, uint64_t hash) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+uint64_t Hash::Fnv1a(const std::string &text, uint64_t hash) {
+    return Fnv1a(text.data(), text.size(), hash);
+}
+
+std::string Hash::ToHex(uint64_t hash) {
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long) hash);
+    return std::string(hex);
+}
@@ -0,0 +1,18 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// FNV-1a (64 bit). Fast and well spread, meant for naming cache entries; not for anything security related.
+class Hash {
+public:
+    static constexpr uint64_t Fnv1aOffsetBasis = 0xcbf29ce484222325ULL;
+
+    static uint64_t Fnv1a(const void *data, size_t length, uint64_t hash = Fnv1aOffsetBasis);
+    static uint64_t Fnv1a(const std::string &text, uint64_t hash = Fnv1aOffsetBasis);
+    static std::string ToHex(uint64_t hash);
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// String keyed cache that drops the least recently used entry once it holds more than its capacity.
+template <typename Value> class LruCache {
+private:
+    typedef std::pair<std::string, Value> Item;
+    size_t capacity;
+    std::list<Item> items;
+    std::unordered_map<std::string, typename std::list<Item>::iterator> index;
+
+public:
+    LruCache(size_t aCapacity) : capacity(aCapacity) {}
+
+    const Value *find(const std::string &key) {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            return nullptr;
+        }
+
+        items.splice(items.begin(), items, it->second);
+        return &it->second->second;
+    }
+
+    const Value &insert(const std::string &key, Value value) {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            it->second->second = std::move(value);
+            items.splice(items.begin(), items, it->second);
+            return it->second->second;
+        }
+
+        items.emplace_front(key, std::move(value));
+        index[key] = items.begin();
+        if (items.size() > capacity) {
+            index.erase(items.back().first);
+            items.pop_back();
+        }
+
+        return items.front().second;
+    }
+
+    void clear() {
+        items.clear();
+        index.clear();
+    }
+};
+
+#endif
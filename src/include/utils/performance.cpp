@@ -0,0 +1,138 @@
+#include "performance.h"
+
+#include "config.h"
+#include "dataref.h"
+#include "path.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <ctime>
+#include <string>
+
+static constexpr float publishInterval = 1.0f;
+
+PerformanceMetric::PerformanceMetric() {
+    reset();
+}
+
+void PerformanceMetric::add(float value) {
+    samples[next] = value;
+    next = (next + 1) % windowSize;
+    count = std::min<unsigned short>(count + 1, windowSize);
+}
+
+void PerformanceMetric::publish() {
+    if (count == 0) {
+        average = 0.0f;
+        p99 = 0.0f;
+        return;
+    }
+
+    float sorted[windowSize];
+    std::copy(samples, samples + count, sorted);
+
+    float sum = 0.0f;
+    for (unsigned short i = 0; i < count; ++i) {
+        sum += sorted[i];
+    }
+    average = sum / count;
+
+    unsigned short index = (unsigned short)((count - 1) * 0.99f);
+    std::nth_element(sorted, sorted + index, sorted + count);
+    p99 = sorted[index];
+}
+
+void PerformanceMetric::reset() {
+    count = 0;
+    next = 0;
+    average = 0.0f;
+    p99 = 0.0f;
+}
+
+PerformanceTimer::PerformanceTimer(PerformanceMetric &aMetric) : metric(aMetric) {
+    startTime = std::chrono::steady_clock::now();
+}
+
+PerformanceTimer::~PerformanceTimer() {
+    metric.add(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+}
+
+Performance* Performance::instance = nullptr;
+
+Performance::Performance() {
+    lastPublishTime = std::chrono::steady_clock::now();
+    publishBytes = 0;
+    uploadBytesPerSecond = 0.0f;
+}
+
+Performance::~Performance() {
+    instance = nullptr;
+}
+
+Performance* Performance::getInstance() {
+    if (instance == nullptr) {
+        instance = new Performance();
+    }
+
+    return instance;
+}
+
+void Performance::initialize() {
+    struct {
+        const char *name;
+        PerformanceMetric *metric;
+    } metrics[] = {
+        {"browser_update_ms", &browserUpdate},
+        {"message_pump_ms", &messagePump},
+        {"paint_ms", &paint},
+        {"upload_ms", &upload},
+        {"draw_ms", &draw},
+        {"dirty_rects", &dirtyRects},
+        {"upload_calls", &uploadCalls},
+        {"page_load_ms", &pageLoad},
+    };
+
+    for (const auto &entry : metrics) {
+        std::string name = std::string("avitab_browser/perf/") + entry.name;
+        Dataref::getInstance()->createDataref<float>(name.c_str(), &entry.metric->average);
+        Dataref::getInstance()->createDataref<float>((name + "_p99").c_str(), &entry.metric->p99);
+    }
+
+    Dataref::getInstance()->createDataref<float>("avitab_browser/perf/upload_bytes_per_second", &uploadBytesPerSecond);
+
+    Dataref::getInstance()->createCommand("avitab_browser/perf/dump_trace", "Write the recent plugin trace events to the Output folder", [](XPLMCommandPhase inPhase) {
+        if (inPhase != xplm_CommandBegin) {
+            return;
+        }
+
+        char timestamp[32];
+        time_t now = time(nullptr);
+        strftime(timestamp, sizeof(timestamp), "%Y%m%d_%H%M%S", localtime(&now));
+        std::string filename = Path::getInstance()->rootDirectory + "/Output/avitab_browser_trace_" + timestamp + ".json";
+        if (Trace::getInstance()->dump(filename)) {
+            debug("Trace written to %s\n", filename.c_str());
+        } else {
+            debug("Could not write trace to %s\n", filename.c_str());
+        }
+    });
+}
+
+void Performance::addUploadedBytes(size_t bytes) {
+    publishBytes += bytes;
+}
+
+void Performance::update() {
+    auto now = std::chrono::steady_clock::now();
+    float seconds = std::chrono::duration<float>(now - lastPublishTime).count();
+    if (seconds < publishInterval) {
+        return;
+    }
+
+    for (PerformanceMetric *metric : {&browserUpdate, &messagePump, &paint, &upload, &draw, &dirtyRects, &uploadCalls, &pageLoad}) {
+        metric->publish();
+    }
+
+    uploadBytesPerSecond = publishBytes / seconds;
+    publishBytes = 0;
+    lastPublishTime = now;
+}
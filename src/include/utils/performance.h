@@ -0,0 +1,66 @@
+#ifndef PERFORMANCE_H
+#define PERFORMANCE_H
+
+#include <chrono>
+#include <cstddef>
+
+// Rolling window over the most recent samples. Adding a sample is cheap; the average and
+// 99th percentile are only computed when the metric is published.
+class PerformanceMetric {
+private:
+    static constexpr unsigned short windowSize = 256;
+    float samples[windowSize];
+    unsigned short count;
+    unsigned short next;
+
+public:
+    PerformanceMetric();
+
+    float average;
+    float p99;
+
+    void add(float value);
+    void publish();
+    void reset();
+};
+
+// Adds the time between construction and destruction, in milliseconds, to a metric.
+class PerformanceTimer {
+private:
+    PerformanceMetric &metric;
+    std::chrono::steady_clock::time_point startTime;
+
+public:
+    PerformanceTimer(PerformanceMetric &metric);
+    ~PerformanceTimer();
+};
+
+// What the plugin costs per sim frame, readable as avitab_browser/perf/* datarefs (e.g. with DataRefTool).
+// All metrics are fed from the sim thread.
+class Performance {
+private:
+    Performance();
+    ~Performance();
+    static Performance* instance;
+    std::chrono::steady_clock::time_point lastPublishTime;
+    unsigned long long publishBytes;
+
+public:
+    static Performance* getInstance();
+
+    PerformanceMetric browserUpdate;
+    PerformanceMetric messagePump;
+    PerformanceMetric paint;
+    PerformanceMetric upload;
+    PerformanceMetric draw;
+    PerformanceMetric dirtyRects;
+    PerformanceMetric uploadCalls;
+    PerformanceMetric pageLoad;
+    float uploadBytesPerSecond;
+
+    void initialize();
+    void addUploadedBytes(size_t bytes);
+    void update();
+};
+
+#endif
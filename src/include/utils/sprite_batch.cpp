@@ -0,0 +1,97 @@
+#include "sprite_batch.h"
+#include "config.h"
+#include <cmath>
+#include <XPLMGraphics.h>
+
+// Every vertex is x, y, u, v; every quad is two triangles.
+static constexpr unsigned char floatsPerVertex = 4;
+
+bool SpriteBatch::add(int textureId, float centerX, float centerY, float width, float height, unsigned short rotationDegrees, float u1, float v1, float u2, float v2) {
+    if (!textureId) {
+        return false;
+    }
+
+    addQuad(textureId, centerX, centerY, width, height, rotationDegrees, u1, v1, u2, v2);
+    return true;
+}
+
+void SpriteBatch::addPlaceholder(float centerX, float centerY, float width, float height) {
+    addQuad(0, centerX, centerY, width, height, 0, 0.0f, 0.0f, 0.0f, 0.0f);
+}
+
+void SpriteBatch::draw(float brightness) {
+    if (vertices.empty()) {
+        return;
+    }
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(2, GL_FLOAT, floatsPerVertex * sizeof(float), vertices.data());
+    glTexCoordPointer(2, GL_FLOAT, floatsPerVertex * sizeof(float), vertices.data() + 2);
+
+    int texturedState = -1;
+    for (const auto &run : runs) {
+        bool textured = run.textureId != 0;
+        if (textured != texturedState) {
+            texturedState = textured;
+            XPLMSetGraphicsState(
+                                 0, // No fog, equivalent to glDisable(GL_FOG);
+                                 textured, // One texture for images, none for placeholders
+                                 0, // No lighting, equivalent to glDisable(GL_LIGHT0);
+                                 0, // No alpha testing, e.g glDisable(GL_ALPHA_TEST);
+                                 1, // Use alpha blending, e.g. glEnable(GL_BLEND);
+                                 0, // No depth read, e.g. glDisable(GL_DEPTH_TEST);
+                                 0 // No depth write, e.g. glDepthMask(GL_FALSE);
+            );
+        }
+
+        if (textured) {
+            XPLMBindTexture2d(run.textureId, 0);
+            set_brightness(brightness);
+        } else {
+            glColor4f(brightness, brightness, brightness, 0.15f);
+        }
+        glDrawArrays(GL_TRIANGLES, run.firstVertex, run.vertexCount);
+    }
+
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    clear();
+}
+
+void SpriteBatch::clear() {
+    vertices.clear();
+    runs.clear();
+}
+
+void SpriteBatch::addQuad(int textureId, float centerX, float centerY, float width, float height, unsigned short rotationDegrees, float u1, float v1, float u2, float v2) {
+    unsigned int firstVertex = (unsigned int)(vertices.size() / floatsPerVertex);
+    if (runs.empty() || runs.back().textureId != textureId) {
+        runs.push_back({textureId, firstVertex, 0});
+    }
+    runs.back().vertexCount += 6;
+
+    // Clockwise around the center, like glRotatef(degrees, 0, 0, -1).
+    float radians = rotationDegrees * (float)M_PI / 180.0f;
+    float cosine = rotationDegrees > 0 ? cosf(radians) : 1.0f;
+    float sine = rotationDegrees > 0 ? sinf(radians) : 0.0f;
+    float halfWidth = width / 2.0f;
+    float halfHeight = height / 2.0f;
+
+    // The top of the image is its first row, at v1.
+    const float corners[4][4] = {
+        {-halfWidth, -halfHeight, u1, v2},
+        {-halfWidth, halfHeight, u1, v1},
+        {halfWidth, halfHeight, u2, v1},
+        {halfWidth, -halfHeight, u2, v2},
+    };
+
+    for (unsigned char index : {0, 1, 2, 0, 2, 3}) {
+        const float *corner = corners[index];
+        vertices.push_back(centerX + corner[0] * cosine + corner[1] * sine);
+        vertices.push_back(centerY - corner[0] * sine + corner[1] * cosine);
+        vertices.push_back(corner[2]);
+        vertices.push_back(corner[3]);
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <vector>
+
+// Collects textured quads and draws them in runs of consecutive quads that share a texture, with
+// one texture bind and one glDrawArrays call per run. Atlas icons therefore go out in a single run,
+// while larger images and placeholders get runs of their own without breaking the draw order.
+// The vertex storage is reused between frames.
+class SpriteBatch {
+private:
+    struct Run {
+        // 0 for untextured placeholder quads.
+        int textureId;
+        unsigned int firstVertex;
+        unsigned int vertexCount;
+    };
+
+    std::vector<float> vertices;
+    std::vector<Run> runs;
+    void addQuad(int textureId, float centerX, float centerY, float width, float height, unsigned short rotationDegrees, float u1, float v1, float u2, float v2);
+
+public:
+    bool add(int textureId, float centerX, float centerY, float width, float height, unsigned short rotationDegrees, float u1, float v1, float u2, float v2);
+    // A faint box where an image will appear, until it has been decoded.
+    void addPlaceholder(float centerX, float centerY, float width, float height);
+    void draw(float brightness);
+    void clear();
+};
+
+#endif
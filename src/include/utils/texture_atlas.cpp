@@ -0,0 +1,176 @@
+#include "texture_atlas.h"
+#include "config.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <XPLMGraphics.h>
+
+TextureAtlas::TextureAtlas(unsigned short aSize) {
+    size = aSize;
+    textureId = 0;
+    clear();
+}
+
+bool TextureAtlas::add(const unsigned char *pixels, unsigned int width, unsigned int height, AtlasRegion *region) {
+    // Keep a transparent border around every image, so linear filtering doesn't bleed into its neighbours.
+    unsigned int paddedWidth = width + padding * 2;
+    unsigned int paddedHeight = height + padding * 2;
+    if (paddedWidth > size || paddedHeight > size) {
+        return false;
+    }
+
+    unsigned short slotX;
+    unsigned short slotY;
+    if (!takeFreeRect(paddedWidth, paddedHeight, &slotX, &slotY)) {
+        if (shelfX + paddedWidth > size) {
+            shelfY += shelfHeight;
+            shelfX = 0;
+            shelfHeight = 0;
+        }
+
+        if (shelfY + paddedHeight > size) {
+            return false;
+        }
+
+        slotX = shelfX;
+        slotY = shelfY;
+        shelfX += paddedWidth;
+        shelfHeight = std::max<unsigned short>(shelfHeight, paddedHeight);
+    }
+
+    if (!textureId) {
+        createTexture();
+    }
+
+    unsigned short x = slotX + padding;
+    unsigned short y = slotY + padding;
+    XPLMBindTexture2d(textureId, 0);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    regionCount++;
+
+    *region = {
+        (float)x / size,
+        (float)y / size,
+        (float)(x + width) / size,
+        (float)(y + height) / size,
+    };
+    return true;
+}
+
+void TextureAtlas::remove(const AtlasRegion &region) {
+    if (regionCount == 0) {
+        return;
+    }
+
+    if (--regionCount == 0) {
+        clear();
+        return;
+    }
+
+    // The region's coordinates are whole texels, so they convert back exactly.
+    unsigned short x = (unsigned short)lroundf(region.u1 * size) - padding;
+    unsigned short y = (unsigned short)lroundf(region.v1 * size) - padding;
+    unsigned short width = (unsigned short)lroundf((region.u2 - region.u1) * size) + padding * 2;
+    unsigned short height = (unsigned short)lroundf((region.v2 - region.v1) * size) + padding * 2;
+
+    // Wipe the slot, so a smaller image placed in it later still gets a transparent border.
+    if (textureId) {
+        std::vector<unsigned char> empty((size_t)width * height * 4, 0);
+        XPLMBindTexture2d(textureId, 0);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, empty.data());
+    }
+
+    addFreeRect({x, y, width, height});
+}
+
+void TextureAtlas::clear() {
+    shelfX = 0;
+    shelfY = 0;
+    shelfHeight = 0;
+    regionCount = 0;
+    freeRects.clear();
+
+    if (textureId) {
+        // Wipe the old images, so the padding of new regions is transparent again.
+        std::vector<unsigned char> empty((size_t)size * size * 4, 0);
+        XPLMBindTexture2d(textureId, 0);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, empty.data());
+    }
+}
+
+void TextureAtlas::destroy() {
+    if (textureId) {
+        XPLMBindTexture2d(textureId, 0);
+        glDeleteTextures(1, (GLuint *)&textureId);
+        textureId = 0;
+    }
+
+    clear();
+}
+
+bool TextureAtlas::takeFreeRect(unsigned short width, unsigned short height, unsigned short *x, unsigned short *y) {
+    // Best fit: the smallest free rectangle the image fits in.
+    auto best = freeRects.end();
+    for (auto it = freeRects.begin(); it != freeRects.end(); ++it) {
+        if (it->width >= width && it->height >= height && (best == freeRects.end() || it->width * it->height < best->width * best->height)) {
+            best = it;
+        }
+    }
+
+    if (best == freeRects.end()) {
+        return false;
+    }
+
+    FreeRect rect = *best;
+    freeRects.erase(best);
+    *x = rect.x;
+    *y = rect.y;
+
+    // Whatever is left to the right of and below the image stays free.
+    if (rect.width > width) {
+        addFreeRect({(unsigned short)(rect.x + width), rect.y, (unsigned short)(rect.width - width), height});
+    }
+    if (rect.height > height) {
+        addFreeRect({rect.x, (unsigned short)(rect.y + height), rect.width, (unsigned short)(rect.height - height)});
+    }
+
+    return true;
+}
+
+void TextureAtlas::addFreeRect(FreeRect rect) {
+    // Merge with neighbours that share a whole edge, so freed slots next to each other fit larger images.
+    bool didMerge = true;
+    while (didMerge) {
+        didMerge = false;
+        for (auto it = freeRects.begin(); it != freeRects.end(); ++it) {
+            bool sameRow = it->y == rect.y && it->height == rect.height;
+            bool sameColumn = it->x == rect.x && it->width == rect.width;
+            if (sameRow && (it->x + it->width == rect.x || rect.x + rect.width == it->x)) {
+                rect.x = std::min(rect.x, it->x);
+                rect.width += it->width;
+            } else if (sameColumn && (it->y + it->height == rect.y || rect.y + rect.height == it->y)) {
+                rect.y = std::min(rect.y, it->y);
+                rect.height += it->height;
+            } else {
+                continue;
+            }
+
+            freeRects.erase(it);
+            didMerge = true;
+            break;
+        }
+    }
+
+    freeRects.push_back(rect);
+}
+
+void TextureAtlas::createTexture() {
+    std::vector<unsigned char> empty((size_t)size * size * 4, 0);
+    XPLMGenerateTextureNumbers(&textureId, 1);
+    XPLMBindTexture2d(textureId, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, empty.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
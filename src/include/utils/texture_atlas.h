@@ -0,0 +1,47 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <vector>
+
+struct AtlasRegion {
+    float u1;
+    float v1;
+    float u2;
+    float v2;
+};
+
+// One texture holding many small images, packed in shelves (rows) from the top left.
+// Removed regions are wiped and kept as free rectangles, which new images fill before the shelves grow.
+// Once the last region is removed, the atlas starts over from the top left.
+class TextureAtlas {
+private:
+    struct FreeRect {
+        unsigned short x;
+        unsigned short y;
+        unsigned short width;
+        unsigned short height;
+    };
+
+    static constexpr unsigned char padding = 1;
+    unsigned short size;
+    unsigned short shelfX;
+    unsigned short shelfY;
+    unsigned short shelfHeight;
+    unsigned int regionCount;
+    std::vector<FreeRect> freeRects;
+    void createTexture();
+    bool takeFreeRect(unsigned short width, unsigned short height, unsigned short *x, unsigned short *y);
+    void addFreeRect(FreeRect rect);
+
+public:
+    TextureAtlas(unsigned short size);
+
+    int textureId;
+
+    bool add(const unsigned char *pixels, unsigned int width, unsigned int height, AtlasRegion *region);
+    void remove(const AtlasRegion &region);
+    void clear();
+    void destroy();
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "trace.h"
+
+#include <algorithm>
+#include <fstream>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#if __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+
+static unsigned long long currentThreadId() {
+#if defined(_WIN32) || defined(_WIN64)
+    return GetCurrentThreadId();
+#elif __linux__
+    return (unsigned long long)syscall(SYS_gettid);
+#else
+    uint64_t id = 0;
+    pthread_threadid_np(nullptr, &id);
+    return id;
+#endif
+}
+
+static unsigned long long currentProcessId() {
+#if defined(_WIN32) || defined(_WIN64)
+    return GetCurrentProcessId();
+#else
+    return (unsigned long long)getpid();
+#endif
+}
+
+static std::string escape(const std::string &text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+
+    return escaped;
+}
+
+Trace* Trace::instance = nullptr;
+
+Trace::Trace() {
+}
+
+Trace::~Trace() {
+    for (TraceBuffer *buffer : buffers) {
+        delete buffer;
+    }
+    buffers.clear();
+    instance = nullptr;
+}
+
+Trace* Trace::getInstance() {
+    if (instance == nullptr) {
+        instance = new Trace();
+    }
+
+    return instance;
+}
+
+long long Trace::now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TraceBuffer *Trace::threadBuffer() {
+    thread_local TraceBuffer *buffer = nullptr;
+    if (!buffer) {
+        buffer = new TraceBuffer();
+        buffer->head = 0;
+        buffer->threadId = currentThreadId();
+
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffers.push_back(buffer);
+    }
+
+    return buffer;
+}
+
+void Trace::record(const char *name, long long start, long long duration) {
+    TraceBuffer *buffer = threadBuffer();
+    unsigned int head = buffer->head.load(std::memory_order_relaxed);
+    TraceEvent &event = buffer->events[head % TraceBuffer::capacity];
+    event.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(start, std::memory_order_relaxed);
+    event.duration.store(duration, std::memory_order_relaxed);
+    event.sequence.store(head + 1, std::memory_order_release);
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void Trace::setThreadName(const std::string &name) {
+    TraceBuffer *buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    buffer->threadName = name;
+}
+
+bool Trace::dump(const std::string &filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    unsigned long long processId = currentProcessId();
+    bool first = true;
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (TraceBuffer *buffer : buffers) {
+        if (!buffer->threadName.empty()) {
+            file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << processId << ",\"tid\":" << buffer->threadId << ",\"args\":{\"name\":\"" << escape(buffer->threadName) << "\"}}";
+            first = false;
+        }
+
+        unsigned int head = buffer->head.load(std::memory_order_acquire);
+        unsigned int count = std::min(head, TraceBuffer::capacity);
+        for (unsigned int i = head - count; i != head; ++i) {
+            // Copy the slot, then check the owner didn't start rewriting it meanwhile.
+            const TraceEvent &event = buffer->events[i % TraceBuffer::capacity];
+            if (event.sequence.load(std::memory_order_acquire) != i + 1) {
+                continue;
+            }
+            const char *name = event.name.load(std::memory_order_relaxed);
+            long long start = event.start.load(std::memory_order_relaxed);
+            long long duration = event.duration.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (event.sequence.load(std::memory_order_relaxed) != i + 1) {
+                continue;
+            }
+
+            file << (first ? "" : ",") << "\n{\"name\":\"" << escape(name) << "\",\"cat\":\"avitab_browser\",\"ph\":\"X\",\"ts\":" << start << ",\"dur\":" << duration << ",\"pid\":" << processId << ",\"tid\":" << buffer->threadId << "}";
+            first = false;
+        }
+    }
+
+    file << "\n]}\n";
+    return file.good();
+}
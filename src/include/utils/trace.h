@@ -0,0 +1,67 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+// Records the enclosing scope as a trace event. The name must be a string literal.
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+// One ring slot. The fields are relaxed atomics so dump can read a slot the owner is rewriting;
+// sequence is one past the position the slot holds, or 0 while it is being written.
+struct TraceEvent {
+    std::atomic<unsigned int> sequence;
+    std::atomic<const char *> name;
+    std::atomic<long long> start;
+    std::atomic<long long> duration;
+};
+
+// Events of one thread. Only the owning thread writes, so recording needs no lock;
+// the newest events overwrite the oldest once the ring is full, and dump drops any
+// slot whose sequence changed while it was being copied.
+struct TraceBuffer {
+    static constexpr unsigned int capacity = 8192;
+    TraceEvent events[capacity];
+    std::atomic<unsigned int> head;
+    unsigned long long threadId;
+    std::string threadName;
+};
+
+// Keeps the most recent scoped events of every thread that records them, and writes them as
+// Chrome trace JSON, to be opened in Perfetto or chrome://tracing next to a CEF trace.
+class Trace {
+private:
+    Trace();
+    ~Trace();
+    static Trace* instance;
+    std::mutex buffersMutex;
+    std::vector<TraceBuffer *> buffers;
+    TraceBuffer *threadBuffer();
+
+public:
+    static Trace* getInstance();
+    static long long now();
+
+    void record(const char *name, long long start, long long duration);
+    void setThreadName(const std::string &name);
+    bool dump(const std::string &filename);
+};
+
+class TraceScope {
+private:
+    const char *name;
+    long long start;
+
+public:
+    TraceScope(const char *aName) : name(aName), start(Trace::now()) {}
+    ~TraceScope() {
+        Trace::getInstance()->record(name, start, Trace::now() - start);
+    }
+};
+
+#endif
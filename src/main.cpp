@@ -4,8 +4,12 @@
 
 #include "config.h"
 #include "appstate.h"
+#include "asset_cache.h"
 #include "dataref.h"
+#include "message_pump.h"
 #include "path.h"
+#include "performance.h"
+#include "trace.h"
 #include <algorithm>
 #include <XPLMDisplay.h>
 #include <XPLMPlugin.h>
@@ -44,6 +48,8 @@ void captureClickEvents(bool enable);
 unsigned char pressedKeyCode = 0;
 unsigned char pressedVirtualKeyCode = 0;
 double pressedKeyTime = 0;
+int lastCursorX = -1;
+int lastCursorY = -1;
 
 PLUGIN_API int XPluginStart(char * name, char * sig, char * desc)
 {
@@ -59,12 +65,14 @@ PLUGIN_API int XPluginStart(char * name, char * sig, char * desc)
     XPLMAppendMenuItem(id, "About", (void *)"ActionAbout", 0);
 
     XPLMRegisterFlightLoopCallback(update, REFRESH_INTERVAL_SECONDS_SLOW, nullptr);
+    MessagePump::getInstance()->setFlightLoop(update);
     XPLMRegisterDrawCallback(draw, xplm_Phase_Gauges, 0, nullptr);
     
     XPluginReceiveMessage(0, XPLM_MSG_PLANE_LOADED, nullptr);
     
     captureVrChanges();
     initializeCursor();
+    Trace::getInstance()->setThreadName("X-Plane main");
     
     debug("Plugin started (version %s)\n", VERSION);
     
@@ -95,6 +103,7 @@ PLUGIN_API void XPluginStop(void) {
     captureClickEvents(false);
     
     AppState::getInstance()->deinitialize();
+    AssetCache::getInstance()->destroy();
     debug("Plugin stopped\n");
 }
 
@@ -282,6 +291,13 @@ int mouseWheel(XPLMWindowID inWindowID, int x, int y, int wheel, int clicks, voi
 }
 
 int mouseCursor(XPLMWindowID inWindowID, int x, int y, void* inRefcon) {
+    // Hovering is only forwarded to the browser from update(), which may be parked on an idle page.
+    if (x != lastCursorX || y != lastCursorY) {
+        lastCursorX = x;
+        lastCursorY = y;
+        MessagePump::getInstance()->wake();
+    }
+    
     bool isVREnabled = Dataref::getInstance()->getCached<int>("sim/graphics/VR/enabled");
     if (isVREnabled) {
         return xplm_CursorDefault;
@@ -320,6 +336,7 @@ int mouseCursor(XPLMWindowID inWindowID, int x, int y, void* inRefcon) {
 }
 
 float update(float inElapsedSinceLastCall, float inElapsedTimeSinceLastFlightLoop, int inCounter, void *inRefcon) {
+    TRACE_SCOPE("update");
     if (!AppState::getInstance()->pluginInitialized) {
         return REFRESH_INTERVAL_SECONDS_SLOW;
     }
@@ -329,8 +346,16 @@ float update(float inElapsedSinceLastCall, float inElapsedTimeSinceLastFlightLoo
     AppState::getInstance()->statusbar->update();
 
     AppState::getInstance()->browser->update();
+    Performance::getInstance()->update();
     if (!AppState::getInstance()->browserVisible) {
-        return REFRESH_INTERVAL_SECONDS_FAST;
+        // Without a page there is nothing to pump, only the tablet to poll.
+        float tabletInterval = AppState::getInstance()->tabletPollInterval();
+        if (!AppState::getInstance()->browser->hasPage()) {
+            return tabletInterval;
+        }
+        
+        float interval = MessagePump::getInstance()->nextFlightLoopInterval(AppState::getInstance()->browser->isPrewarming());
+        return interval < 0.0f || tabletInterval < 0.0f ? -1.0f : std::min(interval, tabletInterval);
     }
     
 #ifndef DEBUG
@@ -356,10 +381,13 @@ float update(float inElapsedSinceLastCall, float inElapsedTimeSinceLastFlightLoo
         AppState::getInstance()->browser->mouseMove(mouseX, mouseY);
     }
     
-    return REFRESH_INTERVAL_SECONDS_FAST;
+    float interval = MessagePump::getInstance()->nextFlightLoopInterval(true);
+    float tabletInterval = AppState::getInstance()->tabletPollInterval();
+    return interval < 0.0f || tabletInterval < 0.0f ? -1.0f : std::min(interval, tabletInterval);
 }
 
 int draw(XPLMDrawingPhase inPhase, int inIsBefore, void * inRefcon) {
+    TRACE_SCOPE("draw");
     AppState::getInstance()->draw();
     return 1;
 }
@@ -95,15 +95,20 @@ void Statusbar::draw() {
         return;
     }
     
-    set_brightness(AppState::getInstance()->brightness * 0.2f);
+    // Atlas icons share one draw call; placeholders and larger images get runs of their own in the same batch.
     if (loading && AppState::getInstance()->browserVisible) {
-        spinnerImage->draw(fmod(XPLMGetElapsedTime() * 360, 360));
+        spinnerImage->addToBatch(spriteBatch, fmod(XPLMGetElapsedTime() * 360, 360));
     }
     
     for (const auto& button : statusbarButtons) {
-        button->draw();
+        button->addToBatch(spriteBatch);
     }
     
+    if (homeButton) {
+        homeButton->addToBatch(spriteBatch);
+    }
+    spriteBatch.draw(AppState::getInstance()->brightness);
+    
     XPLMSetGraphicsState(
                          0, // No fog, equivalent to glDisable(GL_FOG);
                          0, // No texture, equivalent to glDisable(GL_TEXTURE_2D);
@@ -131,10 +136,6 @@ void Statusbar::draw() {
         Drawing::DrawRoundedRect(x - activeTabButton->relativeWidth - 0.005f, y - 0.015f, x - 0.005f, y + 0.015f, 4.0f);
         Drawing::DrawText(activeTabTitle, x - 0.005f - activeTabButton->relativeWidth / 2.0f, y, 1.0f, {AppState::getInstance()->brightness + 0.1f, AppState::getInstance()->brightness + 0.1f, AppState::getInstance()->brightness + 0.1f});
     }
-    
-    if (homeButton) {
-        homeButton->draw();
-    }
 }
 
 void Statusbar::setActiveTab(std::string title) {
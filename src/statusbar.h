@@ -3,6 +3,7 @@
 
 #include "button.h"
 #include "image.h"
+#include "sprite_batch.h"
 #include <vector>
 #include <string>
 
@@ -14,6 +15,7 @@ private:
     Image *spinnerImage;
     Button *homeButton;
     std::vector<Button *> statusbarButtons;
+    SpriteBatch spriteBatch;
 public:
     Statusbar();
     
@@ -0,0 +1,112 @@
+#include "asset_cache.h"
+#include "fake_gl.h"
+#include "fake_xplm.h"
+#include "hash.h"
+#include "lodepng.h"
+#include "path.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class AssetCacheTest : public ::testing::Test {
+protected:
+    std::string filename;
+
+    void SetUp() override {
+        FakeXPLM::reset();
+        FakeGL::reset();
+        filename = testing::TempDir() + "asset_cache_test_" + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".png";
+        std::vector<unsigned char> pixels(12 * 12 * 4, 255);
+        ASSERT_EQ(lodepng_encode32_file(filename.c_str(), pixels.data(), 12, 12), 0u);
+    }
+
+    void TearDown() override {
+        AssetCache::getInstance()->destroy();
+    }
+
+    // Calls update() like the draw callback does, until the decode has finished.
+    static bool waitForTexture(unsigned int id, AssetTexture *texture) {
+        for (int i = 0; i < 500; ++i) {
+            AssetCache::getInstance()->update();
+            bool isPending = false;
+            if (AssetCache::getInstance()->texture(id, texture, &isPending)) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        return false;
+    }
+};
+
+TEST_F(AssetCacheTest, DecodedAssetGetsATexture) {
+    CachedAsset asset;
+    ASSERT_TRUE(AssetCache::getInstance()->acquire(filename, 0, 0, &asset));
+    EXPECT_EQ(asset.width, 12u);
+    EXPECT_EQ(asset.height, 12u);
+
+    AssetTexture texture;
+    ASSERT_TRUE(waitForTexture(asset.id, &texture));
+    EXPECT_NE(texture.textureId, 0);
+    AssetCache::getInstance()->release(asset.id);
+}
+
+TEST_F(AssetCacheTest, ReacquiredAssetGetsItsTextureBackWithoutAnotherDecode) {
+    AssetCache *cache = AssetCache::getInstance();
+    CachedAsset asset;
+    ASSERT_TRUE(cache->acquire(filename, 0, 0, &asset));
+    AssetTexture texture;
+    ASSERT_TRUE(waitForTexture(asset.id, &texture));
+
+    // Like Statusbar::destroy() and initialize() on a configuration reload.
+    cache->release(asset.id);
+    bool isPending = false;
+    EXPECT_FALSE(cache->texture(asset.id, &texture, &isPending));
+
+    CachedAsset again;
+    ASSERT_TRUE(cache->acquire(filename, 0, 0, &again));
+    EXPECT_EQ(again.id, asset.id);
+    cache->update();
+    ASSERT_TRUE(cache->texture(again.id, &texture, &isPending));
+    EXPECT_NE(texture.textureId, 0);
+    cache->release(again.id);
+}
+
+TEST_F(AssetCacheTest, RasterCacheIsKeyedByTheSourceContents) {
+    AssetCache *cache = AssetCache::getInstance();
+    std::string directory = testing::TempDir() + "asset_cache_test_" + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    std::filesystem::remove_all(directory);
+    Path::getInstance()->pluginDirectory = directory;
+    std::string svgFilename = directory + "/icon.svg";
+    std::filesystem::create_directories(directory);
+
+    const std::string sources[] = {
+        "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"16\" height=\"16\"><rect width=\"16\" height=\"16\" fill=\"#fff\"/></svg>",
+        "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"16\" height=\"16\"><rect width=\"8\" height=\"16\" fill=\"#000\"/></svg>",
+    };
+    std::filesystem::file_time_type modifiedTime;
+    for (const std::string &source : sources) {
+        std::ofstream(svgFilename, std::ios::binary) << source;
+        if (&source == &sources[0]) {
+            modifiedTime = std::filesystem::last_write_time(svgFilename);
+        } else {
+            // An edit that keeps the modification time still gets its own raster.
+            std::filesystem::last_write_time(svgFilename, modifiedTime);
+        }
+
+        CachedAsset asset;
+        ASSERT_TRUE(cache->acquire(svgFilename, 24, 24, &asset));
+        AssetTexture texture;
+        ASSERT_TRUE(waitForTexture(asset.id, &texture));
+        cache->release(asset.id);
+        cache->destroy();
+
+        EXPECT_TRUE(std::filesystem::exists(directory + "/raster_cache/" + Hash::ToHex(Hash::Fnv1a(source)) + "_24x24.raw"));
+    }
+
+    std::filesystem::remove_all(directory);
+}
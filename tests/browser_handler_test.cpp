@@ -0,0 +1,84 @@
+#include "browser_handler.h"
+#include "fake_cef.h"
+#include "fake_xplm.h"
+#include "frame_store.h"
+#include "performance.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+class BrowserHandlerTest : public ::testing::Test {
+protected:
+    static constexpr unsigned short width = 64;
+    static constexpr unsigned short height = 32;
+    FrameStore *frameStore;
+    std::string currentUrl;
+    CefRefPtr<BrowserHandler> handler;
+    std::vector<unsigned char> pixels;
+
+    void SetUp() override {
+        FakeXPLM::reset();
+        FakeCef::reset();
+        frameStore = new FrameStore(width, height, 4);
+        handler = new BrowserHandler(frameStore, &currentUrl, width, height);
+        pixels.assign((size_t)width * height * 4, 0x7f);
+
+        CefWindowInfo windowInfo;
+        windowInfo.SetAsWindowless(0);
+        CefBrowserHost::CreateBrowser(windowInfo, handler, "https://example.com", CefBrowserSettings(), nullptr, nullptr);
+        CefDoMessageLoopWork();
+    }
+
+    void TearDown() override {
+        handler->destroy();
+        handler = nullptr;
+        delete frameStore;
+    }
+};
+
+TEST_F(BrowserHandlerTest, BrowserIsKnownAfterCreation) {
+    ASSERT_TRUE(handler->browserInstance);
+    EXPECT_EQ(handler->browserInstance, FakeCef::lastBrowser());
+}
+
+TEST_F(BrowserHandlerTest, PaintHandsDirtyRectsToTheFrameStore) {
+    handler->OnPaint(handler->browserInstance, PET_VIEW, {CefRect(2, 3, 10, 4)}, pixels.data(), width, height);
+
+    ASSERT_TRUE(frameStore->acquire());
+    ASSERT_EQ(frameStore->frontRects().size(), 1u);
+    EXPECT_EQ(frameStore->frontRects()[0].x, 2);
+    EXPECT_EQ(frameStore->frontRects()[0].y, 3);
+    EXPECT_EQ(frameStore->frontRects()[0].width, 10);
+    EXPECT_EQ(frameStore->frontRects()[0].height, 4);
+    EXPECT_EQ(frameStore->frontPixels()[(3 * width + 2) * 4], 0x7f);
+}
+
+TEST_F(BrowserHandlerTest, PaintCountsTheDirtyRectsItReceives) {
+    Performance::getInstance()->dirtyRects.reset();
+    handler->OnPaint(handler->browserInstance, PET_VIEW, {CefRect(0, 0, 4, 4), CefRect(8, 0, 4, 4), CefRect(16, 0, 4, 4)}, pixels.data(), width, height);
+
+    Performance::getInstance()->dirtyRects.publish();
+    EXPECT_EQ(Performance::getInstance()->dirtyRects.average, 3.0f);
+}
+
+TEST_F(BrowserHandlerTest, PopupRectsAreOffsetByThePopupPosition) {
+    handler->OnPopupShow(handler->browserInstance, true);
+    handler->OnPopupSize(handler->browserInstance, CefRect(20, 10, 16, 8));
+    EXPECT_EQ(handler->browserInstance->GetHost()->invalidateCount, 1u);
+
+    handler->OnPaint(handler->browserInstance, PET_VIEW, {CefRect(0, 0, width, height)}, pixels.data(), width, height);
+    handler->OnPaint(handler->browserInstance, PET_POPUP, {CefRect(0, 0, 16, 8)}, pixels.data(), 16, 8);
+
+    ASSERT_TRUE(frameStore->acquire());
+    ASSERT_EQ(frameStore->frontRects().size(), 1u);
+    EXPECT_EQ(frameStore->frontRects()[0].x, 20);
+    EXPECT_EQ(frameStore->frontRects()[0].y, 10);
+}
+
+TEST_F(BrowserHandlerTest, ClosingReleasesTheBrowser) {
+    handler->isForeground = false;
+    handler->browserInstance->GetHost()->CloseBrowser(true);
+    CefDoMessageLoopWork();
+
+    EXPECT_TRUE(handler->isClosed);
+    EXPECT_FALSE(handler->browserInstance);
+}
@@ -0,0 +1,53 @@
+#include "appstate.h"
+#include "browser.h"
+#include "fake_cef.h"
+#include "fake_gl.h"
+#include "fake_xplm.h"
+#include "statusbar.h"
+#include <gtest/gtest.h>
+
+class BrowserTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        FakeXPLM::reset();
+        FakeCef::reset();
+        FakeGL::reset();
+        AppState::getInstance()->tabletDimensions = {0, 0, 64, 64, 64, 64, 64, 64};
+    }
+};
+
+TEST_F(BrowserTest, DestroyUnregistersTheFrameRateDatarefs) {
+    Browser browser;
+    browser.initialize();
+    ASSERT_TRUE(FakeXPLM::hasDataref("avitab_browser/framerate/current"));
+    ASSERT_TRUE(FakeXPLM::hasDataref("avitab_browser/framerate/reason"));
+    ASSERT_TRUE(FakeXPLM::hasDataref("avitab_browser/perf/framerate"));
+
+    browser.destroy();
+    EXPECT_FALSE(FakeXPLM::hasDataref("avitab_browser/framerate/current"));
+    EXPECT_FALSE(FakeXPLM::hasDataref("avitab_browser/framerate/reason"));
+    EXPECT_FALSE(FakeXPLM::hasDataref("avitab_browser/perf/framerate"));
+}
+
+TEST_F(BrowserTest, DiscardedTabWithoutAHeapReportIsClosedBeforeDestroyReturns) {
+    AppState::getInstance()->config.tab_memory_budget = 32;
+    AppState::getInstance()->statusbar = new Statusbar();
+    Browser browser;
+    browser.initialize();
+    browser.visibilityWillChange(true);
+    CefDoMessageLoopWork();
+    CefRefPtr<CefBrowser> home = FakeCef::lastBrowser();
+    ASSERT_TRUE(home);
+    CefRefPtr<BrowserHandler> homeHandler = static_cast<BrowserHandler *>(home->GetHost()->GetClient().get());
+
+    // The home page never reported its heap, so it is counted at the estimate, which is over the budget.
+    browser.openTab("https://example.com/other");
+    EXPECT_TRUE(home->GetHost()->closed);
+    EXPECT_FALSE(homeHandler->isClosed);
+
+    browser.destroy();
+    EXPECT_TRUE(homeHandler->isClosed);
+    delete AppState::getInstance()->statusbar;
+    AppState::getInstance()->statusbar = nullptr;
+    AppState::getInstance()->config.tab_memory_budget = 512;
+}
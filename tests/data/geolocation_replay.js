@@ -0,0 +1,51 @@
+// Replays a track through the injected geolocation receiver and reports how far the extrapolated
+// positions are from the track between samples.
+// Usage: node geolocation_replay.js <receiver script> <track csv> <source rate>
+const fs = require('fs');
+
+let clock = 0;
+globalThis.window = globalThis;
+Object.defineProperty(globalThis, 'performance', { value: { now: () => clock }, configurable: true });
+globalThis.fetch = () => new Promise(() => {});
+globalThis.setTimeout = () => 0;
+globalThis.setInterval = () => 0;
+eval(fs.readFileSync(process.argv[2], 'utf8'));
+
+const rows = fs.readFileSync(process.argv[3], 'utf8').split('\n')
+    .filter((line) => line && !line.startsWith('#') && !line.startsWith('time'))
+    .map((line) => line.split(',').map(Number));
+const period = 1 / Number(process.argv[4]);
+
+const distance = (latitude1, longitude1, latitude2, longitude2) => {
+    const toRadians = Math.PI / 180;
+    const a = Math.sin((latitude2 - latitude1) * toRadians / 2) ** 2 +
+        Math.cos(latitude1 * toRadians) * Math.cos(latitude2 * toRadians) * Math.sin((longitude2 - longitude1) * toRadians / 2) ** 2;
+    return 2 * 6371000 * Math.asin(Math.sqrt(a));
+};
+
+let sequence = 0;
+let sampleTime = -Infinity;
+let sampleRow = null;
+const result = { extrapolatedError: 0, heldError: 0, headingError: 0, checked: 0 };
+for (const [time, latitude, longitude, altitude, heading, speed] of rows) {
+    clock = time * 1000;
+    if (time - sampleTime >= period - 1e-6) {
+        sequence++;
+        window.avitab_receive([latitude, longitude, altitude, heading, speed, 0, 0, 0, 0, heading, sequence]);
+        sampleTime = time;
+        sampleRow = [latitude, longitude];
+        continue;
+    }
+
+    // The turn rate is measured between samples, so it lags one sample at turn entry and exit.
+    const location = window.avitab_extrapolate(window.avitab_sample, time - sampleTime);
+    result.extrapolatedError = Math.max(result.extrapolatedError, distance(latitude, longitude, location.coords.latitude, location.coords.longitude));
+    result.heldError = Math.max(result.heldError, distance(latitude, longitude, sampleRow[0], sampleRow[1]));
+    if (sequence > 1) {
+        const headingError = Math.abs(((location.coords.heading - heading + 540) % 360) - 180);
+        result.headingError = Math.max(result.headingError, headingError);
+    }
+    result.checked++;
+}
+
+console.log(JSON.stringify(result));
@@ -0,0 +1,65 @@
+#include "dataref.h"
+#include "fake_xplm.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+class DatarefTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        FakeXPLM::reset();
+    }
+
+    void TearDown() override {
+        Dataref::getInstance()->destroyAllBindings();
+    }
+};
+
+TEST_F(DatarefTest, MonitoredDatarefReportsChangesOnUpdate) {
+    FakeXPLM::setInt("test/monitor/int", 3);
+    std::vector<int> reported;
+    Dataref::getInstance()->monitorExistingDataref<int>("test/monitor/int", [&reported](int value) {
+        reported.push_back(value);
+    });
+
+    Dataref::getInstance()->update();
+    Dataref::getInstance()->update();
+    FakeXPLM::setInt("test/monitor/int", 5);
+    Dataref::getInstance()->update();
+
+    EXPECT_EQ(reported, (std::vector<int>{3, 5}));
+    EXPECT_EQ(Dataref::getInstance()->getCached<int>("test/monitor/int"), 5);
+}
+
+TEST_F(DatarefTest, CreatedDatarefIsVisibleToOtherPlugins) {
+    int value = 7;
+    Dataref::getInstance()->createDataref<int>("test/created/int", &value, true, [](int newValue) {
+        return newValue >= 0;
+    });
+
+    EXPECT_EQ(FakeXPLM::getInt("test/created/int"), 7);
+    XPLMSetDatai(XPLMFindDataRef("test/created/int"), 9);
+    EXPECT_EQ(value, 9);
+    XPLMSetDatai(XPLMFindDataRef("test/created/int"), -1);
+    EXPECT_EQ(value, 9);
+
+    Dataref::getInstance()->unbind("test/created/int");
+    EXPECT_FALSE(FakeXPLM::hasDataref("test/created/int"));
+}
+
+TEST_F(DatarefTest, CreatedCommandRunsCallbackForEachPhase) {
+    std::vector<XPLMCommandPhase> phases;
+    Dataref::getInstance()->createCommand("test/command", "Test command", [&phases](XPLMCommandPhase phase) {
+        phases.push_back(phase);
+    });
+
+    Dataref::getInstance()->executeCommand("test/command");
+
+    EXPECT_EQ(phases, (std::vector<XPLMCommandPhase>{xplm_CommandBegin, xplm_CommandEnd}));
+    EXPECT_EQ(FakeXPLM::commandCount("test/command"), 1u);
+}
+
+TEST_F(DatarefTest, MissingDatarefReadsAsDefault) {
+    EXPECT_EQ(Dataref::getInstance()->get<int>("test/missing/int"), 0);
+    EXPECT_EQ(Dataref::getInstance()->get<std::string>("test/missing/string"), "");
+    EXPECT_NE(FakeXPLM::debugLog().find("test/missing/int"), std::string::npos);
+}
@@ -0,0 +1,104 @@
+#include "dirty_rect_coalescer.h"
+#include <gtest/gtest.h>
+
+TEST(DirtyRectCoalescerTest, OverlappingRectsMergeIntoTheirBounds) {
+    DirtyRectCoalescer coalescer;
+    coalescer.add({0, 0, 100, 100});
+    coalescer.add({50, 50, 100, 100});
+
+    auto rects = coalescer.take(0);
+    ASSERT_EQ(rects.size(), 1u);
+    EXPECT_EQ(rects[0].x, 0);
+    EXPECT_EQ(rects[0].y, 0);
+    EXPECT_EQ(rects[0].width, 150);
+    EXPECT_EQ(rects[0].height, 150);
+    EXPECT_FALSE(coalescer.hasPending());
+}
+
+TEST(DirtyRectCoalescerTest, ContainedAndEmptyRectsAreDropped) {
+    DirtyRectCoalescer coalescer;
+    coalescer.add({0, 0, 100, 100});
+    coalescer.add({10, 10, 20, 20});
+    coalescer.add({5, 5, 0, 10});
+
+    EXPECT_EQ(coalescer.pendingBytes(), 100u * 100 * 4);
+}
+
+TEST(DirtyRectCoalescerTest, DistantRectsStaySeparate) {
+    DirtyRectCoalescer coalescer(0);
+    coalescer.add({0, 0, 10, 10});
+    coalescer.add({500, 500, 10, 10});
+
+    EXPECT_EQ(coalescer.take(0).size(), 2u);
+}
+
+TEST(DirtyRectCoalescerTest, BudgetSplitsARectByRows) {
+    DirtyRectCoalescer coalescer;
+    coalescer.add({0, 0, 100, 50});
+    const size_t rowBytes = 100 * 4;
+
+    auto first = coalescer.take(rowBytes * 20 + rowBytes / 2);
+    ASSERT_EQ(first.size(), 1u);
+    EXPECT_EQ(first[0].y, 0);
+    EXPECT_EQ(first[0].height, 20);
+    EXPECT_EQ(coalescer.pendingBytes(), rowBytes * 30);
+
+    auto second = coalescer.take(rowBytes * 20);
+    ASSERT_EQ(second.size(), 1u);
+    EXPECT_EQ(second[0].y, 20);
+    EXPECT_EQ(second[0].height, 20);
+
+    auto last = coalescer.take(rowBytes * 20);
+    ASSERT_EQ(last.size(), 1u);
+    EXPECT_EQ(last[0].y, 40);
+    EXPECT_EQ(last[0].height, 10);
+    EXPECT_FALSE(coalescer.hasPending());
+}
+
+TEST(DirtyRectCoalescerTest, BudgetKeepsLaterRectsForTheNextFrame) {
+    DirtyRectCoalescer coalescer(0);
+    coalescer.add({0, 0, 10, 10});
+    coalescer.add({500, 500, 10, 10});
+
+    auto first = coalescer.take(10 * 10 * 4);
+    ASSERT_EQ(first.size(), 1u);
+    EXPECT_EQ(first[0].x, 0);
+    EXPECT_TRUE(coalescer.hasPending());
+
+    auto second = coalescer.take(10 * 10 * 4);
+    ASSERT_EQ(second.size(), 1u);
+    EXPECT_EQ(second[0].x, 500);
+    EXPECT_FALSE(coalescer.hasPending());
+}
+
+TEST(DirtyRectCoalescerTest, RowWiderThanTheBudgetStillMakesProgress) {
+    DirtyRectCoalescer coalescer;
+    coalescer.add({0, 0, 1000, 3});
+
+    for (int row = 0; row < 3; ++row) {
+        auto rects = coalescer.take(16);
+        ASSERT_EQ(rects.size(), 1u);
+        EXPECT_EQ(rects[0].y, row);
+        EXPECT_EQ(rects[0].height, 1);
+    }
+    EXPECT_FALSE(coalescer.hasPending());
+}
+
+TEST(DirtyRectCoalescerTest, ManySmallRectsCoverEveryDirtyPixel) {
+    DirtyRectCoalescer coalescer;
+    for (int i = 0; i < 256; ++i) {
+        coalescer.add({(i * 37) % 1800, (i * 53) % 1000, 16, 16});
+    }
+
+    auto rects = coalescer.take(0);
+    EXPECT_LT(rects.size(), 256u);
+    for (int i = 0; i < 256; ++i) {
+        int x = (i * 37) % 1800 + 8;
+        int y = (i * 53) % 1000 + 8;
+        bool covered = false;
+        for (const auto &rect : rects) {
+            covered |= x >= rect.x && y >= rect.y && x < rect.x + rect.width && y < rect.y + rect.height;
+        }
+        EXPECT_TRUE(covered) << "rect " << i;
+    }
+}
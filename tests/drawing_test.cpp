@@ -0,0 +1,62 @@
+#include "drawing.h"
+#include "appstate.h"
+#include "fake_xplm.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+typedef std::vector<std::string> Lines;
+
+// The fake font is 8 pixels per byte, so at a 0.1 width on an 800 pixel tablet a line holds 10 bytes.
+class DrawingTest : public ::testing::Test {
+protected:
+    static constexpr float lineWidth = 0.1f;
+
+    void SetUp() override {
+        FakeXPLM::reset();
+        AppState::getInstance()->tabletDimensions = {0, 0, 800, 480, 800, 480, 800, 450};
+    }
+
+    static Lines wrap(const std::string &text, float width = lineWidth) {
+        return Drawing::WrapWordsToLines(xplmFont_Proportional, text, width);
+    }
+};
+
+TEST_F(DrawingTest, WrapsWordsThatNoLongerFit) {
+    EXPECT_EQ(wrap("aa bb cc dd"), (Lines{"aa bb cc", "dd"}));
+    EXPECT_EQ(wrap("aa bb cc dd", 0.2f), (Lines{"aa bb cc dd"}));
+}
+
+TEST_F(DrawingTest, LongWordsGetALineOfTheirOwnWithoutBeingSplit) {
+    EXPECT_EQ(wrap("a verylongwordthatdoesnotfit b"), (Lines{"a", "verylongwordthatdoesnotfit", "b"}));
+    EXPECT_EQ(wrap("overlongwordnumberone overlongwordnumbertwo"), (Lines{"overlongwordnumberone", "overlongwordnumbertwo"}));
+}
+
+TEST_F(DrawingTest, UTF8WordsStayIntactAndAreMeasuredByBytes) {
+    // "Grüße" is seven bytes and "München" eight, so they take more room than their letter count.
+    EXPECT_EQ(wrap("Grüße aus Köln und München"), (Lines{"Grüße", "aus Köln", "und", "München"}));
+    EXPECT_EQ(wrap("日本語のテキスト 東京"), (Lines{"日本語のテキスト", "東京"}));
+}
+
+TEST_F(DrawingTest, EmbeddedNewlinesStartNewLines) {
+    EXPECT_EQ(wrap("one\ntwo"), (Lines{"one", "two"}));
+    EXPECT_EQ(wrap("one \n two"), (Lines{"one", "two"}));
+    EXPECT_EQ(wrap("one\n\ntwo"), (Lines{"one", "", "two"}));
+    EXPECT_EQ(wrap("\nstart"), (Lines{"", "start"}));
+}
+
+TEST_F(DrawingTest, NewlineAfterAnExactlyFullLineAddsNoBlankLine) {
+    EXPECT_EQ(wrap("abcdefghij\nk"), (Lines{"abcdefghij", "k"}));
+    EXPECT_EQ(wrap("abcd efghi\nk"), (Lines{"abcd efghi", "k"}));
+    EXPECT_EQ(wrap("abcd efg\nk"), (Lines{"abcd efg", "k"}));
+}
+
+TEST_F(DrawingTest, RepeatedLayoutsSkipMeasuring) {
+    Lines lines = wrap("cached layout of some words");
+    unsigned int measured = FakeXPLM::measureStringCount();
+    EXPECT_EQ(wrap("cached layout of some words"), lines);
+    EXPECT_EQ(FakeXPLM::measureStringCount(), measured);
+
+    // The width is part of the key.
+    EXPECT_EQ(wrap("cached layout of some words", 1.0f), (Lines{"cached layout of some words"}));
+}
@@ -0,0 +1,6 @@
+#ifndef FAKE_BASE_CEF_CALLBACK_H
+#define FAKE_BASE_CEF_CALLBACK_H
+
+#include "../internal/cef_fake_api.h"
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef FAKE_CEF_PARSER_H
+#define FAKE_CEF_PARSER_H
+
+#include "internal/cef_fake_api.h"
+
+#endif
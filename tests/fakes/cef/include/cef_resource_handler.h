@@ -0,0 +1,6 @@
+#ifndef FAKE_CEF_RESOURCE_HANDLER_H
+#define FAKE_CEF_RESOURCE_HANDLER_H
+
+#include "internal/cef_fake_api.h"
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef FAKE_CEF_VERSION_H
+#define FAKE_CEF_VERSION_H
+
+#define CEF_VERSION "0.0.0-fake"
+#define CEF_VERSION_MAJOR 0
+#define CHROME_VERSION_MAJOR 0
+
+#endif
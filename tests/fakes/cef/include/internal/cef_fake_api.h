@@ -0,0 +1,1251 @@
+#ifndef CEF_FAKE_API_H
+#define CEF_FAKE_API_H
+
+// Stand-in for the parts of the CEF API the plugin uses, so it can be compiled and exercised without
+// libcef. Everything lives in this one header; the real header names include it. Objects record what
+// was done to them (see the public members of CefBrowserHost and CefFrame), and work that CEF would do
+// asynchronously is queued until CefDoMessageLoopWork() runs. See fake_cef.h for the test controls.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Reference counting.
+
+class CefRefCount {
+    private:
+        mutable std::atomic<int> count{0};
+
+    public:
+        void AddRef() const {
+            count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        bool Release() const {
+            return count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        }
+
+        bool HasOneRef() const {
+            return count.load(std::memory_order_acquire) == 1;
+        }
+
+        bool HasAtLeastOneRef() const {
+            return count.load(std::memory_order_acquire) >= 1;
+        }
+};
+
+class CefBaseRefCounted {
+    public:
+        virtual void AddRef() const = 0;
+        virtual bool Release() const = 0;
+        virtual bool HasOneRef() const = 0;
+        virtual bool HasAtLeastOneRef() const = 0;
+
+    protected:
+        virtual ~CefBaseRefCounted() {}
+};
+
+#define IMPLEMENT_REFCOUNTING(ClassName)                                \
+    public:                                                             \
+        void AddRef() const override {                                  \
+            ref_count_.AddRef();                                        \
+        }                                                               \
+        bool Release() const override {                                 \
+            if (ref_count_.Release()) {                                 \
+                delete static_cast<const ClassName *>(this);            \
+                return true;                                            \
+            }                                                           \
+            return false;                                               \
+        }                                                               \
+        bool HasOneRef() const override {                               \
+            return ref_count_.HasOneRef();                              \
+        }                                                               \
+        bool HasAtLeastOneRef() const override {                        \
+            return ref_count_.HasAtLeastOneRef();                       \
+        }                                                               \
+                                                                        \
+    private:                                                            \
+        CefRefCount ref_count_
+
+template <class T> class CefRefPtr {
+    private:
+        T *ptr;
+
+        template <class U> friend class CefRefPtr;
+
+    public:
+        CefRefPtr() : ptr(nullptr) {}
+        CefRefPtr(std::nullptr_t) : ptr(nullptr) {}
+
+        CefRefPtr(T *p) : ptr(p) {
+            if (ptr) {
+                ptr->AddRef();
+            }
+        }
+
+        CefRefPtr(const CefRefPtr &other) : CefRefPtr(other.ptr) {}
+
+        template <class U, class = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+        CefRefPtr(const CefRefPtr<U> &other) : CefRefPtr(other.get()) {}
+
+        CefRefPtr(CefRefPtr &&other) noexcept : ptr(other.ptr) {
+            other.ptr = nullptr;
+        }
+
+        template <class U, class = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+        CefRefPtr(CefRefPtr<U> &&other) noexcept : ptr(other.ptr) {
+            other.ptr = nullptr;
+        }
+
+        ~CefRefPtr() {
+            if (ptr) {
+                ptr->Release();
+            }
+        }
+
+        CefRefPtr &operator=(T *p) {
+            if (p) {
+                p->AddRef();
+            }
+            T *old = ptr;
+            ptr = p;
+            if (old) {
+                old->Release();
+            }
+            return *this;
+        }
+
+        CefRefPtr &operator=(const CefRefPtr &other) {
+            return *this = other.ptr;
+        }
+
+        CefRefPtr &operator=(CefRefPtr &&other) noexcept {
+            std::swap(ptr, other.ptr);
+            return *this;
+        }
+
+        CefRefPtr &operator=(std::nullptr_t) {
+            return *this = static_cast<T *>(nullptr);
+        }
+
+        T *get() const {
+            return ptr;
+        }
+
+        T &operator*() const {
+            return *ptr;
+        }
+
+        T *operator->() const {
+            return ptr;
+        }
+
+        explicit operator bool() const {
+            return ptr != nullptr;
+        }
+
+        bool operator==(const CefRefPtr &other) const {
+            return ptr == other.ptr;
+        }
+
+        bool operator==(std::nullptr_t) const {
+            return ptr == nullptr;
+        }
+};
+
+// Strings. CEF stores UTF-16 by default, so conversions from and to std::string cost what they cost there.
+
+struct cef_string_t {
+    std::u16string value;
+};
+
+class CefString {
+    private:
+        cef_string_t owned;
+        cef_string_t *string;
+
+    public:
+        static std::u16string FromUtf8(const std::string &text);
+        static std::string ToUtf8(const std::u16string &text);
+
+        CefString() : string(&owned) {}
+        CefString(const CefString &other) : owned{other.string->value}, string(&owned) {}
+        CefString(CefString &&other) : owned{other.string == &other.owned ? std::move(other.owned.value) : other.string->value}, string(&owned) {}
+        CefString(const std::string &text) : owned{FromUtf8(text)}, string(&owned) {}
+        CefString(const char *text) : owned{FromUtf8(text ? text : "")}, string(&owned) {}
+        CefString(const std::u16string &text) : owned{text}, string(&owned) {}
+        CefString(const char16_t *text) : owned{text ? text : u""}, string(&owned) {}
+        // Refers to an existing string structure, e.g. a settings member, without owning it.
+        CefString(cef_string_t *src) : string(src) {}
+
+        CefString &operator=(const CefString &other) {
+            string->value = other.string->value;
+            return *this;
+        }
+
+        CefString &operator=(const std::string &text) {
+            string->value = FromUtf8(text);
+            return *this;
+        }
+
+        CefString &operator=(const char *text) {
+            string->value = FromUtf8(text ? text : "");
+            return *this;
+        }
+
+        std::string ToString() const {
+            return ToUtf8(string->value);
+        }
+
+        std::u16string ToString16() const {
+            return string->value;
+        }
+
+        operator std::string() const {
+            return ToString();
+        }
+
+        const char16_t *c_str() const {
+            return string->value.c_str();
+        }
+
+        size_t length() const {
+            return string->value.length();
+        }
+
+        size_t size() const {
+            return string->value.size();
+        }
+
+        bool empty() const {
+            return string->value.empty();
+        }
+
+        void clear() {
+            string->value.clear();
+        }
+
+        int compare(const CefString &other) const {
+            return string->value.compare(other.string->value);
+        }
+};
+
+inline bool operator<(const CefString &a, const CefString &b) {
+    return a.compare(b) < 0;
+}
+
+inline bool operator==(const CefString &a, const CefString &b) {
+    return a.compare(b) == 0;
+}
+
+inline bool operator!=(const CefString &a, const CefString &b) {
+    return a.compare(b) != 0;
+}
+
+// Plain types.
+
+typedef uint32_t cef_color_t;
+
+inline constexpr cef_color_t CefColorSetARGB(unsigned int a, unsigned int r, unsigned int g, unsigned int b) {
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+class CefRect {
+    public:
+        int x, y, width, height;
+
+        CefRect() : x(0), y(0), width(0), height(0) {}
+        CefRect(int aX, int aY, int aWidth, int aHeight) : x(aX), y(aY), width(aWidth), height(aHeight) {}
+};
+
+typedef unsigned long CefWindowHandle;
+typedef unsigned long CefCursorHandle;
+
+typedef enum {
+    TID_UI,
+    TID_FILE_BACKGROUND,
+    TID_FILE_USER_VISIBLE,
+    TID_FILE_USER_BLOCKING,
+    TID_PROCESS_LAUNCHER,
+    TID_IO,
+    TID_RENDERER,
+} cef_thread_id_t;
+typedef cef_thread_id_t CefThreadId;
+
+typedef enum {
+    PET_VIEW = 0,
+    PET_POPUP,
+} cef_paint_element_type_t;
+
+typedef enum {
+    CEF_TEXT_INPUT_MODE_DEFAULT,
+    CEF_TEXT_INPUT_MODE_NONE,
+    CEF_TEXT_INPUT_MODE_TEXT,
+    CEF_TEXT_INPUT_MODE_TEL,
+    CEF_TEXT_INPUT_MODE_URL,
+    CEF_TEXT_INPUT_MODE_EMAIL,
+    CEF_TEXT_INPUT_MODE_NUMERIC,
+    CEF_TEXT_INPUT_MODE_DECIMAL,
+    CEF_TEXT_INPUT_MODE_SEARCH,
+} cef_text_input_mode_t;
+
+typedef enum {
+    CT_POINTER = 0,
+    CT_CROSS,
+    CT_HAND,
+    CT_IBEAM,
+    CT_WAIT,
+    CT_HELP,
+    CT_VERTICALTEXT = 29,
+} cef_cursor_type_t;
+
+struct CefCursorInfo {
+    void *buffer = nullptr;
+    float image_scale_factor = 1.0f;
+};
+
+typedef enum {
+    ERR_NONE = 0,
+    ERR_FAILED = -2,
+    ERR_ABORTED = -3,
+    ERR_TIMED_OUT = -7,
+    ERR_CONNECTION_REFUSED = -102,
+    ERR_NAME_NOT_RESOLVED = -105,
+    ERR_INTERNET_DISCONNECTED = -106,
+} cef_errorcode_t;
+
+typedef enum {
+    JSDIALOGTYPE_ALERT = 0,
+    JSDIALOGTYPE_CONFIRM,
+    JSDIALOGTYPE_PROMPT,
+} cef_jsdialog_type_t;
+
+typedef enum {
+    FILE_DIALOG_OPEN = 0,
+    FILE_DIALOG_OPEN_MULTIPLE,
+    FILE_DIALOG_OPEN_FOLDER,
+    FILE_DIALOG_SAVE,
+} cef_file_dialog_mode_t;
+
+typedef enum {
+    CEF_WOD_UNKNOWN,
+    CEF_WOD_CURRENT_TAB,
+    CEF_WOD_SINGLETON_TAB,
+    CEF_WOD_NEW_FOREGROUND_TAB,
+    CEF_WOD_NEW_BACKGROUND_TAB,
+    CEF_WOD_NEW_POPUP,
+    CEF_WOD_NEW_WINDOW,
+} cef_window_open_disposition_t;
+
+typedef enum {
+    UR_UNKNOWN = 0,
+    UR_SUCCESS,
+    UR_IO_PENDING,
+    UR_CANCELED,
+    UR_FAILED,
+} cef_urlrequest_status_t;
+
+typedef enum {
+    UR_FLAG_NONE = 0,
+    UR_FLAG_SKIP_CACHE = 1 << 0,
+    UR_FLAG_ONLY_FROM_CACHE = 1 << 1,
+    UR_FLAG_DISABLE_CACHE = 1 << 2,
+    UR_FLAG_ALLOW_STORED_CREDENTIALS = 1 << 3,
+} cef_urlrequest_flags_t;
+
+typedef enum {
+    RV_CANCEL = 0,
+    RV_CONTINUE,
+    RV_CONTINUE_ASYNC,
+} cef_return_value_t;
+
+typedef enum {
+    RT_MAIN_FRAME = 0,
+    RT_SUB_FRAME,
+    RT_STYLESHEET,
+    RT_SCRIPT,
+    RT_IMAGE,
+    RT_FONT_RESOURCE,
+    RT_SUB_RESOURCE,
+    RT_OBJECT,
+    RT_MEDIA,
+    RT_WORKER,
+    RT_SHARED_WORKER,
+    RT_PREFETCH,
+    RT_FAVICON,
+    RT_XHR,
+    RT_PING,
+    RT_SERVICE_WORKER,
+    RT_CSP_REPORT,
+    RT_PLUGIN_RESOURCE,
+} cef_resource_type_t;
+
+typedef enum {
+    RESPONSE_FILTER_NEED_MORE_DATA,
+    RESPONSE_FILTER_DONE,
+    RESPONSE_FILTER_ERROR,
+} cef_response_filter_status_t;
+
+typedef enum {
+    EVENTFLAG_NONE = 0,
+    EVENTFLAG_CAPS_LOCK_ON = 1 << 0,
+    EVENTFLAG_SHIFT_DOWN = 1 << 1,
+    EVENTFLAG_CONTROL_DOWN = 1 << 2,
+    EVENTFLAG_ALT_DOWN = 1 << 3,
+    EVENTFLAG_LEFT_MOUSE_BUTTON = 1 << 4,
+    EVENTFLAG_MIDDLE_MOUSE_BUTTON = 1 << 5,
+    EVENTFLAG_RIGHT_MOUSE_BUTTON = 1 << 6,
+    EVENTFLAG_COMMAND_DOWN = 1 << 7,
+} cef_event_flags_t;
+
+typedef enum {
+    MBT_LEFT = 0,
+    MBT_MIDDLE,
+    MBT_RIGHT,
+} cef_mouse_button_type_t;
+
+typedef enum {
+    KEYEVENT_RAWKEYDOWN = 0,
+    KEYEVENT_KEYDOWN,
+    KEYEVENT_KEYUP,
+    KEYEVENT_CHAR,
+} cef_key_event_type_t;
+
+typedef enum {
+    CEF_PERMISSION_TYPE_NONE = 0,
+    CEF_PERMISSION_TYPE_CAMERA_STREAM = 1 << 2,
+    CEF_PERMISSION_TYPE_GEOLOCATION = 1 << 5,
+    CEF_PERMISSION_TYPE_MIC_STREAM = 1 << 9,
+    CEF_PERMISSION_TYPE_NOTIFICATIONS = 1 << 12,
+} cef_permission_request_types_t;
+
+typedef enum {
+    CEF_PERMISSION_RESULT_ACCEPT,
+    CEF_PERMISSION_RESULT_DENY,
+    CEF_PERMISSION_RESULT_DISMISS,
+    CEF_PERMISSION_RESULT_IGNORE,
+} cef_permission_request_result_t;
+
+typedef enum {
+    CEF_MEDIA_PERMISSION_NONE = 0,
+    CEF_MEDIA_PERMISSION_DEVICE_AUDIO_CAPTURE = 1 << 0,
+    CEF_MEDIA_PERMISSION_DEVICE_VIDEO_CAPTURE = 1 << 1,
+} cef_media_access_permission_types_t;
+
+struct CefMouseEvent {
+    int x = 0;
+    int y = 0;
+    uint32_t modifiers = 0;
+};
+
+struct CefKeyEvent {
+    cef_key_event_type_t type = KEYEVENT_RAWKEYDOWN;
+    uint32_t modifiers = 0;
+    int windows_key_code = 0;
+    int native_key_code = 0;
+    int is_system_key = 0;
+    char16_t character = 0;
+    char16_t unmodified_character = 0;
+    int focus_on_editable_field = 0;
+};
+
+struct CefMainArgs {
+    int argc = 0;
+    char **argv = nullptr;
+
+    CefMainArgs() {}
+    CefMainArgs(int aArgc, char **aArgv) : argc(aArgc), argv(aArgv) {}
+};
+
+struct CefSettings {
+    int no_sandbox = 0;
+    cef_string_t browser_subprocess_path;
+    cef_string_t framework_dir_path;
+    cef_string_t main_bundle_path;
+    int multi_threaded_message_loop = 0;
+    int external_message_pump = 0;
+    int windowless_rendering_enabled = 0;
+    cef_string_t cache_path;
+    cef_string_t resources_dir_path;
+    cef_string_t locales_dir_path;
+};
+
+struct CefRequestContextSettings {
+    cef_string_t cache_path;
+    int persist_session_cookies = 0;
+    int persist_user_preferences = 0;
+    cef_string_t accept_language_list;
+};
+
+struct CefBrowserSettings {
+    int windowless_frame_rate = 30;
+    cef_color_t background_color = 0;
+};
+
+struct CefWindowInfo {
+    CefWindowHandle parent_window = 0;
+    int windowless_rendering_enabled = 0;
+    int shared_texture_enabled = 0;
+
+    void SetAsWindowless(CefWindowHandle parent) {
+        parent_window = parent;
+        windowless_rendering_enabled = 1;
+    }
+};
+
+struct CefPopupFeatures {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+// Closures and tasks.
+
+namespace base {
+    typedef std::function<void()> OnceClosure;
+    typedef std::function<void()> RepeatingClosure;
+
+    template <typename T> T *Unretained(T *pointer) {
+        return pointer;
+    }
+
+    // Arguments are stored by value, like base::BindOnce does, and moved into the call.
+    template <typename Functor, typename... Args> OnceClosure BindOnce(Functor &&functor, Args &&...args) {
+        return [functor = std::forward<Functor>(functor), ... boundArgs = std::forward<Args>(args)]() mutable {
+            std::invoke(functor, std::move(boundArgs)...);
+        };
+    }
+}
+
+bool CefPostTask(CefThreadId threadId, base::OnceClosure closure);
+bool CefCurrentlyOn(CefThreadId threadId);
+
+// Forward declarations.
+
+class CefApp;
+class CefBrowser;
+class CefBrowserHost;
+class CefClient;
+class CefFrame;
+class CefRequest;
+class CefRequestContext;
+class CefResponse;
+class CefURLRequestClient;
+
+// Callbacks handed to the client. The defaults do nothing; tests subclass them to observe the result.
+
+class CefCallback : public virtual CefBaseRefCounted {
+    public:
+        virtual void Continue() {}
+        virtual void Cancel() {}
+};
+
+class CefAuthCallback : public virtual CefBaseRefCounted {
+    public:
+        virtual void Continue(const CefString &username, const CefString &password) {}
+        virtual void Cancel() {}
+};
+
+class CefJSDialogCallback : public virtual CefBaseRefCounted {
+    public:
+        virtual void Continue(bool success, const CefString &user_input) {}
+};
+
+class CefFileDialogCallback : public virtual CefBaseRefCounted {
+    public:
+        virtual void Continue(const std::vector<CefString> &file_paths) {}
+        virtual void Cancel() {}
+};
+
+class CefPermissionPromptCallback : public virtual CefBaseRefCounted {
+    public:
+        virtual void Continue(cef_permission_request_result_t result) {}
+};
+
+class CefMediaAccessCallback : public virtual CefBaseRefCounted {
+    public:
+        virtual void Continue(uint32_t allowed_permissions) {}
+        virtual void Cancel() {}
+};
+
+class CefBeforeDownloadCallback : public virtual CefBaseRefCounted {
+    public:
+        virtual void Continue(const CefString &download_path, bool show_dialog) {}
+};
+
+class CefDownloadItemCallback : public virtual CefBaseRefCounted {
+    public:
+        virtual void Cancel() {}
+        virtual void Pause() {}
+        virtual void Resume() {}
+};
+
+class CefResourceReadCallback : public virtual CefBaseRefCounted {
+    public:
+        virtual void Continue(int bytes_read) {}
+};
+
+class CefDownloadItem : public virtual CefBaseRefCounted {
+    public:
+        virtual bool IsValid() {
+            return true;
+        }
+
+        virtual bool IsComplete() {
+            return false;
+        }
+
+        virtual CefString GetFullPath() {
+            return CefString();
+        }
+};
+
+class CefDictionaryValue : public virtual CefBaseRefCounted {};
+class CefCommandLine : public virtual CefBaseRefCounted {};
+class CefRequestContextHandler : public virtual CefBaseRefCounted {};
+
+// Requests and responses.
+
+class CefRequest : public virtual CefBaseRefCounted {
+    private:
+        IMPLEMENT_REFCOUNTING(CefRequest);
+        CefString url;
+        CefString method;
+        int flags;
+        cef_resource_type_t resourceType;
+        uint64_t identifier;
+
+    public:
+        typedef std::multimap<CefString, CefString> HeaderMap;
+
+        static CefRefPtr<CefRequest> Create();
+
+        CefRequest();
+
+        HeaderMap headers;
+
+        CefString GetURL() {
+            return url;
+        }
+
+        void SetURL(const CefString &aUrl) {
+            url = aUrl;
+        }
+
+        CefString GetMethod() {
+            return method;
+        }
+
+        void SetMethod(const CefString &aMethod) {
+            method = aMethod;
+        }
+
+        int GetFlags() {
+            return flags;
+        }
+
+        void SetFlags(int aFlags) {
+            flags = aFlags;
+        }
+
+        cef_resource_type_t GetResourceType() {
+            return resourceType;
+        }
+
+        // Not in CEF, where the resource type comes from the renderer.
+        void SetResourceType(cef_resource_type_t aResourceType) {
+            resourceType = aResourceType;
+        }
+
+        uint64_t GetIdentifier() {
+            return identifier;
+        }
+
+        void GetHeaderMap(HeaderMap &headerMap) {
+            headerMap = headers;
+        }
+
+        void SetHeaderMap(const HeaderMap &headerMap) {
+            headers = headerMap;
+        }
+
+        CefString GetHeaderByName(const CefString &name);
+        void SetHeaderByName(const CefString &name, const CefString &value, bool overwrite);
+};
+
+class CefResponse : public virtual CefBaseRefCounted {
+    private:
+        IMPLEMENT_REFCOUNTING(CefResponse);
+        int status;
+        CefString statusText;
+        CefString mimeType;
+        CefString charset;
+        cef_errorcode_t error;
+
+    public:
+        typedef std::multimap<CefString, CefString> HeaderMap;
+
+        static CefRefPtr<CefResponse> Create();
+
+        CefResponse();
+
+        HeaderMap headers;
+
+        int GetStatus() {
+            return status;
+        }
+
+        void SetStatus(int aStatus) {
+            status = aStatus;
+        }
+
+        CefString GetStatusText() {
+            return statusText;
+        }
+
+        void SetStatusText(const CefString &aStatusText) {
+            statusText = aStatusText;
+        }
+
+        CefString GetMimeType() {
+            return mimeType;
+        }
+
+        void SetMimeType(const CefString &aMimeType) {
+            mimeType = aMimeType;
+        }
+
+        CefString GetCharset() {
+            return charset;
+        }
+
+        void SetCharset(const CefString &aCharset) {
+            charset = aCharset;
+        }
+
+        cef_errorcode_t GetError() {
+            return error;
+        }
+
+        void SetError(cef_errorcode_t aError) {
+            error = aError;
+        }
+
+        void GetHeaderMap(HeaderMap &headerMap) {
+            headerMap = headers;
+        }
+
+        void SetHeaderMap(const HeaderMap &headerMap) {
+            headers = headerMap;
+        }
+
+        CefString GetHeaderByName(const CefString &name);
+        void SetHeaderByName(const CefString &name, const CefString &value, bool overwrite);
+};
+
+class CefResponseFilter : public virtual CefBaseRefCounted {
+    public:
+        typedef cef_response_filter_status_t FilterStatus;
+
+        virtual bool InitFilter() = 0;
+        virtual FilterStatus Filter(void *data_in, size_t data_in_size, size_t &data_in_read, void *data_out, size_t data_out_size, size_t &data_out_written) = 0;
+};
+
+class CefStreamReader : public virtual CefBaseRefCounted {
+    private:
+        IMPLEMENT_REFCOUNTING(CefStreamReader);
+        std::string data;
+        size_t position;
+
+    public:
+        static CefRefPtr<CefStreamReader> CreateForData(void *data, size_t size);
+        static CefRefPtr<CefStreamReader> CreateForFile(const CefString &fileName);
+
+        CefStreamReader(std::string data);
+
+        size_t Read(void *ptr, size_t size, size_t n);
+        int Seek(int64_t offset, int whence);
+        int64_t Tell();
+        int Eof();
+
+        bool MayBlock() {
+            return false;
+        }
+};
+
+class CefResourceHandler : public virtual CefBaseRefCounted {
+    public:
+        virtual bool Open(CefRefPtr<CefRequest> request, bool &handle_request, CefRefPtr<CefCallback> callback) {
+            handle_request = true;
+            return true;
+        }
+
+        virtual void GetResponseHeaders(CefRefPtr<CefResponse> response, int64_t &response_length, CefString &redirectUrl) = 0;
+        virtual bool Read(void *data_out, int bytes_to_read, int &bytes_read, CefRefPtr<CefResourceReadCallback> callback) = 0;
+
+        virtual void Cancel() {}
+};
+
+class CefStreamResourceHandler : public CefResourceHandler {
+    private:
+        IMPLEMENT_REFCOUNTING(CefStreamResourceHandler);
+        int statusCode;
+        CefString statusText;
+        CefString mimeType;
+        CefResponse::HeaderMap headerMap;
+        CefRefPtr<CefStreamReader> stream;
+
+    public:
+        CefStreamResourceHandler(const CefString &mimeType, CefRefPtr<CefStreamReader> stream);
+        CefStreamResourceHandler(int statusCode, const CefString &statusText, const CefString &mimeType, CefResponse::HeaderMap headerMap, CefRefPtr<CefStreamReader> stream);
+
+        void GetResponseHeaders(CefRefPtr<CefResponse> response, int64_t &response_length, CefString &redirectUrl) override;
+        bool Read(void *data_out, int bytes_to_read, int &bytes_read, CefRefPtr<CefResourceReadCallback> callback) override;
+};
+
+// Runs on the UI thread, so callbacks arrive from CefDoMessageLoopWork(). The transfer itself is a
+// plain HTTP request made with libcurl.
+class CefURLRequest : public virtual CefBaseRefCounted {
+    private:
+        IMPLEMENT_REFCOUNTING(CefURLRequest);
+        CefRefPtr<CefRequest> request;
+        CefRefPtr<CefURLRequestClient> client;
+        CefRefPtr<CefResponse> response;
+        cef_urlrequest_status_t status;
+        cef_errorcode_t error;
+        void perform();
+
+    public:
+        static CefRefPtr<CefURLRequest> Create(CefRefPtr<CefRequest> request, CefRefPtr<CefURLRequestClient> client, CefRefPtr<CefRequestContext> request_context);
+
+        CefURLRequest(CefRefPtr<CefRequest> request, CefRefPtr<CefURLRequestClient> client);
+
+        CefRefPtr<CefRequest> GetRequest() {
+            return request;
+        }
+
+        CefRefPtr<CefURLRequestClient> GetClient() {
+            return client;
+        }
+
+        cef_urlrequest_status_t GetRequestStatus() {
+            return status;
+        }
+
+        cef_errorcode_t GetRequestError() {
+            return error;
+        }
+
+        CefRefPtr<CefResponse> GetResponse() {
+            return response;
+        }
+
+        void Cancel() {}
+};
+
+class CefURLRequestClient : public virtual CefBaseRefCounted {
+    public:
+        virtual void OnRequestComplete(CefRefPtr<CefURLRequest> request) = 0;
+        virtual void OnUploadProgress(CefRefPtr<CefURLRequest> request, int64_t current, int64_t total) = 0;
+        virtual void OnDownloadProgress(CefRefPtr<CefURLRequest> request, int64_t current, int64_t total) = 0;
+        virtual void OnDownloadData(CefRefPtr<CefURLRequest> request, const void *data, size_t data_length) = 0;
+        virtual bool GetAuthCredentials(bool isProxy, const CefString &host, int port, const CefString &realm, const CefString &scheme, CefRefPtr<CefAuthCallback> callback) = 0;
+};
+
+// Browsers.
+
+class CefRequestContext : public virtual CefBaseRefCounted {
+    private:
+        IMPLEMENT_REFCOUNTING(CefRequestContext);
+
+    public:
+        static CefRefPtr<CefRequestContext> CreateContext(const CefRequestContextSettings &settings, CefRefPtr<CefRequestContextHandler> handler);
+        static CefRefPtr<CefRequestContext> GetGlobalContext();
+
+        CefRequestContextSettings settings;
+};
+
+class CefFrame : public virtual CefBaseRefCounted {
+    private:
+        IMPLEMENT_REFCOUNTING(CefFrame);
+        CefString url;
+
+    public:
+        CefFrame(const CefString &url);
+
+        std::vector<std::string> loadedUrls;
+        std::vector<std::string> executedScripts;
+        unsigned int selectAllCount = 0;
+        unsigned int copyCount = 0;
+        unsigned int pasteCount = 0;
+
+        bool IsValid() {
+            return true;
+        }
+
+        bool IsMain() {
+            return true;
+        }
+
+        CefString GetURL() {
+            return url;
+        }
+
+        void LoadURL(const CefString &aUrl) {
+            url = aUrl;
+            loadedUrls.push_back(aUrl.ToString());
+        }
+
+        void ExecuteJavaScript(const CefString &code, const CefString &script_url, int start_line) {
+            executedScripts.push_back(code.ToString());
+        }
+
+        void SelectAll() {
+            selectAllCount++;
+        }
+
+        void Copy() {
+            copyCount++;
+        }
+
+        void Paste() {
+            pasteCount++;
+        }
+};
+
+class CefBrowserHost : public virtual CefBaseRefCounted {
+    private:
+        IMPLEMENT_REFCOUNTING(CefBrowserHost);
+        CefBrowser *browser;
+        CefRefPtr<CefClient> client;
+        CefRefPtr<CefRequestContext> requestContext;
+
+    public:
+        typedef cef_paint_element_type_t PaintElementType;
+
+        static bool CreateBrowser(const CefWindowInfo &windowInfo, CefRefPtr<CefClient> client, const CefString &url, const CefBrowserSettings &settings, CefRefPtr<CefDictionaryValue> extra_info, CefRefPtr<CefRequestContext> request_context);
+
+        CefBrowserHost(CefBrowser *browser, CefRefPtr<CefClient> client, CefRefPtr<CefRequestContext> requestContext, int frameRate);
+
+        bool hidden = false;
+        bool audioMuted = false;
+        bool focused = false;
+        bool closed = false;
+        int windowlessFrameRate;
+        unsigned int invalidateCount = 0;
+        unsigned int mouseMoveCount = 0;
+        unsigned int mouseClickCount = 0;
+        unsigned int mouseWheelCount = 0;
+        std::vector<CefKeyEvent> keyEvents;
+
+        CefRefPtr<CefBrowser> GetBrowser();
+
+        CefRefPtr<CefClient> GetClient() {
+            return client;
+        }
+
+        CefRefPtr<CefRequestContext> GetRequestContext() {
+            return requestContext;
+        }
+
+        void CloseBrowser(bool force_close);
+
+        void WasHidden(bool isHidden) {
+            hidden = isHidden;
+        }
+
+        void WasResized() {}
+
+        void Invalidate(PaintElementType type) {
+            invalidateCount++;
+        }
+
+        void SetWindowlessFrameRate(int frameRate) {
+            windowlessFrameRate = frameRate;
+        }
+
+        int GetWindowlessFrameRate() {
+            return windowlessFrameRate;
+        }
+
+        void SetAudioMuted(bool mute) {
+            audioMuted = mute;
+        }
+
+        bool IsAudioMuted() {
+            return audioMuted;
+        }
+
+        void SetFocus(bool focus) {
+            focused = focus;
+        }
+
+        void SendKeyEvent(const CefKeyEvent &event) {
+            keyEvents.push_back(event);
+        }
+
+        void SendMouseClickEvent(const CefMouseEvent &event, cef_mouse_button_type_t type, bool mouseUp, int clickCount) {
+            mouseClickCount++;
+        }
+
+        void SendMouseMoveEvent(const CefMouseEvent &event, bool mouseLeave) {
+            mouseMoveCount++;
+        }
+
+        void SendMouseWheelEvent(const CefMouseEvent &event, int deltaX, int deltaY) {
+            mouseWheelCount++;
+        }
+};
+
+class CefBrowser : public virtual CefBaseRefCounted {
+    private:
+        IMPLEMENT_REFCOUNTING(CefBrowser);
+        int identifier;
+        CefRefPtr<CefBrowserHost> host;
+        CefRefPtr<CefFrame> mainFrame;
+
+    public:
+        CefBrowser(int identifier, CefRefPtr<CefClient> client, CefRefPtr<CefRequestContext> requestContext, const CefString &url, int frameRate);
+
+        bool loading = false;
+        bool canGoBack = false;
+        bool canGoForward = false;
+        unsigned int reloadCount = 0;
+        unsigned int goBackCount = 0;
+
+        CefRefPtr<CefBrowserHost> GetHost() {
+            return host;
+        }
+
+        CefRefPtr<CefFrame> GetMainFrame() {
+            return mainFrame;
+        }
+
+        int GetIdentifier() {
+            return identifier;
+        }
+
+        bool IsLoading() {
+            return loading;
+        }
+
+        bool CanGoBack() {
+            return canGoBack;
+        }
+
+        bool CanGoForward() {
+            return canGoForward;
+        }
+
+        void GoBack() {
+            goBackCount++;
+        }
+
+        void GoForward() {}
+
+        void Reload() {
+            reloadCount++;
+        }
+
+        void StopLoad() {}
+};
+
+// Client handlers. Methods the plugin doesn't override have empty defaults, as in CEF.
+
+class CefDisplayHandler : public virtual CefBaseRefCounted {
+    public:
+        virtual void OnAddressChange(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, const CefString &url) {}
+        virtual void OnTitleChange(CefRefPtr<CefBrowser> browser, const CefString &title) {}
+
+        virtual bool OnCursorChange(CefRefPtr<CefBrowser> browser, CefCursorHandle cursor, cef_cursor_type_t type, const CefCursorInfo &custom_cursor_info) {
+            return false;
+        }
+};
+
+class CefRenderHandler : public virtual CefBaseRefCounted {
+    public:
+        typedef cef_paint_element_type_t PaintElementType;
+        typedef std::vector<CefRect> RectList;
+        typedef cef_text_input_mode_t TextInputMode;
+
+        virtual void GetViewRect(CefRefPtr<CefBrowser> browser, CefRect &rect) = 0;
+        virtual void OnPopupShow(CefRefPtr<CefBrowser> browser, bool show) {}
+        virtual void OnPopupSize(CefRefPtr<CefBrowser> browser, const CefRect &rect) {}
+        virtual void OnPaint(CefRefPtr<CefBrowser> browser, PaintElementType type, const RectList &dirtyRects, const void *buffer, int width, int height) = 0;
+        virtual void OnVirtualKeyboardRequested(CefRefPtr<CefBrowser> browser, TextInputMode input_mode) {}
+};
+
+class CefLifeSpanHandler : public virtual CefBaseRefCounted {
+    public:
+        typedef cef_window_open_disposition_t WindowOpenDisposition;
+
+        virtual bool OnBeforePopup(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, const CefString &target_url, const CefString &target_frame_name, WindowOpenDisposition target_disposition, bool user_gesture, const CefPopupFeatures &popupFeatures, CefWindowInfo &windowInfo, CefRefPtr<CefClient> &client, CefBrowserSettings &settings, CefRefPtr<CefDictionaryValue> &extra_info, bool *no_javascript_access) {
+            return false;
+        }
+
+        virtual void OnAfterCreated(CefRefPtr<CefBrowser> browser) {}
+
+        virtual bool DoClose(CefRefPtr<CefBrowser> browser) {
+            return false;
+        }
+
+        virtual void OnBeforeClose(CefRefPtr<CefBrowser> browser) {}
+};
+
+class CefLoadHandler : public virtual CefBaseRefCounted {
+    public:
+        typedef cef_errorcode_t ErrorCode;
+
+        virtual void OnLoadingStateChange(CefRefPtr<CefBrowser> browser, bool isLoading, bool canGoBack, bool canGoForward) {}
+        virtual void OnLoadEnd(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, int httpStatusCode) {}
+        virtual void OnLoadError(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, ErrorCode errorCode, const CefString &errorText, const CefString &failedUrl) {}
+};
+
+class CefDialogHandler : public virtual CefBaseRefCounted {
+    public:
+        typedef cef_file_dialog_mode_t FileDialogMode;
+
+        virtual bool OnFileDialog(CefRefPtr<CefBrowser> browser, FileDialogMode mode, const CefString &title, const CefString &default_file_path, const std::vector<CefString> &accept_filters, CefRefPtr<CefFileDialogCallback> callback) {
+            return false;
+        }
+};
+
+class CefJSDialogHandler : public virtual CefBaseRefCounted {
+    public:
+        typedef cef_jsdialog_type_t JSDialogType;
+
+        virtual bool OnJSDialog(CefRefPtr<CefBrowser> browser, const CefString &origin_url, JSDialogType dialog_type, const CefString &message_text, const CefString &default_prompt_text, CefRefPtr<CefJSDialogCallback> callback, bool &suppress_message) {
+            return false;
+        }
+};
+
+class CefFocusHandler : public virtual CefBaseRefCounted {
+    public:
+        virtual void OnTakeFocus(CefRefPtr<CefBrowser> browser, bool next) {}
+        virtual void OnGotFocus(CefRefPtr<CefBrowser> browser) {}
+};
+
+class CefPermissionHandler : public virtual CefBaseRefCounted {
+    public:
+        virtual bool OnRequestMediaAccessPermission(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, const CefString &requesting_origin, uint32_t requested_permissions, CefRefPtr<CefMediaAccessCallback> callback) {
+            return false;
+        }
+
+        virtual bool OnShowPermissionPrompt(CefRefPtr<CefBrowser> browser, uint64_t prompt_id, const CefString &requesting_origin, uint32_t requested_permissions, CefRefPtr<CefPermissionPromptCallback> callback) {
+            return false;
+        }
+};
+
+class CefDownloadHandler : public virtual CefBaseRefCounted {
+    public:
+        virtual void OnBeforeDownload(CefRefPtr<CefBrowser> browser, CefRefPtr<CefDownloadItem> download_item, const CefString &suggested_name, CefRefPtr<CefBeforeDownloadCallback> callback) {}
+        virtual void OnDownloadUpdated(CefRefPtr<CefBrowser> browser, CefRefPtr<CefDownloadItem> download_item, CefRefPtr<CefDownloadItemCallback> callback) {}
+};
+
+class CefResourceRequestHandler : public virtual CefBaseRefCounted {
+    public:
+        typedef cef_urlrequest_status_t URLRequestStatus;
+
+        virtual cef_return_value_t OnBeforeResourceLoad(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request, CefRefPtr<CefCallback> callback) {
+            return RV_CONTINUE;
+        }
+
+        virtual CefRefPtr<CefResourceHandler> GetResourceHandler(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request) {
+            return nullptr;
+        }
+
+        virtual CefRefPtr<CefResponseFilter> GetResourceResponseFilter(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response) {
+            return nullptr;
+        }
+
+        virtual void OnResourceLoadComplete(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request, CefRefPtr<CefResponse> response, URLRequestStatus status, int64_t received_content_length) {}
+};
+
+class CefRequestHandler : public virtual CefBaseRefCounted {
+    public:
+        virtual bool OnBeforeBrowse(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request, bool user_gesture, bool is_redirect) {
+            return false;
+        }
+
+        virtual CefRefPtr<CefResourceRequestHandler> GetResourceRequestHandler(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request, bool is_navigation, bool is_download, const CefString &request_initiator, bool &disable_default_handling) {
+            return nullptr;
+        }
+
+        virtual void OnDocumentAvailableInMainFrame(CefRefPtr<CefBrowser> browser) {}
+};
+
+class CefClient : public virtual CefBaseRefCounted {
+    public:
+        virtual CefRefPtr<CefDialogHandler> GetDialogHandler() {
+            return nullptr;
+        }
+
+        virtual CefRefPtr<CefDisplayHandler> GetDisplayHandler() {
+            return nullptr;
+        }
+
+        virtual CefRefPtr<CefDownloadHandler> GetDownloadHandler() {
+            return nullptr;
+        }
+
+        virtual CefRefPtr<CefFocusHandler> GetFocusHandler() {
+            return nullptr;
+        }
+
+        virtual CefRefPtr<CefJSDialogHandler> GetJSDialogHandler() {
+            return nullptr;
+        }
+
+        virtual CefRefPtr<CefLifeSpanHandler> GetLifeSpanHandler() {
+            return nullptr;
+        }
+
+        virtual CefRefPtr<CefLoadHandler> GetLoadHandler() {
+            return nullptr;
+        }
+
+        virtual CefRefPtr<CefPermissionHandler> GetPermissionHandler() {
+            return nullptr;
+        }
+
+        virtual CefRefPtr<CefRenderHandler> GetRenderHandler() {
+            return nullptr;
+        }
+
+        virtual CefRefPtr<CefRequestHandler> GetRequestHandler() {
+            return nullptr;
+        }
+};
+
+// Application.
+
+class CefBrowserProcessHandler : public virtual CefBaseRefCounted {
+    public:
+        virtual void OnContextInitialized() {}
+        virtual void OnScheduleMessagePumpWork(int64_t delay_ms) {}
+};
+
+class CefApp : public virtual CefBaseRefCounted {
+    public:
+        virtual void OnBeforeCommandLineProcessing(const CefString &process_type, CefRefPtr<CefCommandLine> command_line) {}
+
+        virtual CefRefPtr<CefBrowserProcessHandler> GetBrowserProcessHandler() {
+            return nullptr;
+        }
+};
+
+bool CefInitialize(const CefMainArgs &args, const CefSettings &settings, CefRefPtr<CefApp> application, void *windows_sandbox_info);
+void CefShutdown();
+void CefDoMessageLoopWork();
+
+#endif
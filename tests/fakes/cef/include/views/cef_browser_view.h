@@ -0,0 +1,6 @@
+#ifndef FAKE_VIEWS_CEF_BROWSER_VIEW_H
+#define FAKE_VIEWS_CEF_BROWSER_VIEW_H
+
+#include "../internal/cef_fake_api.h"
+
+#endif
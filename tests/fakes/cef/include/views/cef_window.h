@@ -0,0 +1,6 @@
+#ifndef FAKE_VIEWS_CEF_WINDOW_H
+#define FAKE_VIEWS_CEF_WINDOW_H
+
+#include "../internal/cef_fake_api.h"
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef FAKE_WRAPPER_CEF_CLOSURE_TASK_H
+#define FAKE_WRAPPER_CEF_CLOSURE_TASK_H
+
+#include "../internal/cef_fake_api.h"
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef FAKE_CEF_HELPERS_H
+#define FAKE_CEF_HELPERS_H
+
+#include "../internal/cef_fake_api.h"
+
+#define CEF_REQUIRE_UI_THREAD() ((void)0)
+#define CEF_REQUIRE_IO_THREAD() ((void)0)
+
+#endif
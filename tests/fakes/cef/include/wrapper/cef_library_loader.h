@@ -0,0 +1,6 @@
+#ifndef FAKE_CEF_LIBRARY_LOADER_H
+#define FAKE_CEF_LIBRARY_LOADER_H
+
+// Only used on macOS, where the framework is loaded at runtime.
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef FAKE_WRAPPER_CEF_STREAM_RESOURCE_HANDLER_H
+#define FAKE_WRAPPER_CEF_STREAM_RESOURCE_HANDLER_H
+
+#include "../internal/cef_fake_api.h"
+
+#endif
@@ -0,0 +1,482 @@
+#include "fake_cef.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <curl/curl.h>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace {
+    // Runs TID_FILE_BACKGROUND tasks one after another on a single thread, like a sequenced task runner.
+    class BackgroundRunner {
+    private:
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::condition_variable idleCondition;
+        std::deque<base::OnceClosure> tasks;
+        std::thread thread;
+        bool busy = false;
+        bool stopping = false;
+
+        void run() {
+            while (true) {
+                base::OnceClosure task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    condition.wait(lock, [this]() {
+                        return stopping || !tasks.empty();
+                    });
+
+                    if (tasks.empty()) {
+                        return;
+                    }
+
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                    busy = true;
+                }
+
+                task();
+
+                std::lock_guard<std::mutex> lock(mutex);
+                busy = false;
+                idleCondition.notify_all();
+            }
+        }
+
+    public:
+        std::thread::id threadId;
+
+        ~BackgroundRunner() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            condition.notify_all();
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+
+        void post(base::OnceClosure task) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tasks.push_back(std::move(task));
+                if (!thread.joinable()) {
+                    thread = std::thread(&BackgroundRunner::run, this);
+                    threadId = thread.get_id();
+                }
+            }
+            condition.notify_one();
+        }
+
+        void wait() {
+            std::unique_lock<std::mutex> lock(mutex);
+            idleCondition.wait(lock, [this]() {
+                return tasks.empty() && !busy;
+            });
+        }
+    };
+
+    std::mutex uiMutex;
+    std::deque<base::OnceClosure> uiTasks;
+    BackgroundRunner background;
+    CefRefPtr<CefApp> application;
+    CefRefPtr<CefBrowser> newestBrowser;
+    unsigned int messageLoopWorks = 0;
+    std::atomic<unsigned int> scheduledPumps{0};
+    int nextBrowserId = 1;
+    uint64_t nextRequestId = 1;
+
+    void postUiTask(base::OnceClosure task) {
+        {
+            std::lock_guard<std::mutex> lock(uiMutex);
+            uiTasks.push_back(std::move(task));
+        }
+
+        // With an external message pump, CEF asks the application to call CefDoMessageLoopWork().
+        CefRefPtr<CefBrowserProcessHandler> handler = application ? application->GetBrowserProcessHandler() : nullptr;
+        if (handler) {
+            scheduledPumps++;
+            handler->OnScheduleMessagePumpWork(0);
+        }
+    }
+
+    bool equalsIgnoreCase(const CefString &a, const CefString &b) {
+        std::u16string left = a.ToString16();
+        std::u16string right = b.ToString16();
+        return std::equal(left.begin(), left.end(), right.begin(), right.end(), [](char16_t x, char16_t y) {
+            return (x < 128 ? tolower(x) : x) == (y < 128 ? tolower(y) : y);
+        });
+    }
+
+    CefString findHeader(const std::multimap<CefString, CefString> &headers, const CefString &name) {
+        for (const auto &[key, value] : headers) {
+            if (equalsIgnoreCase(key, name)) {
+                return value;
+            }
+        }
+        return CefString();
+    }
+
+    void setHeader(std::multimap<CefString, CefString> &headers, const CefString &name, const CefString &value, bool overwrite) {
+        auto existing = std::find_if(headers.begin(), headers.end(), [&](const auto &item) {
+            return equalsIgnoreCase(item.first, name);
+        });
+
+        if (existing != headers.end() && !overwrite) {
+            return;
+        }
+
+        for (auto it = headers.begin(); it != headers.end();) {
+            it = equalsIgnoreCase(it->first, name) ? headers.erase(it) : std::next(it);
+        }
+        headers.insert(std::make_pair(name, value));
+    }
+
+    size_t curlWrite(char *data, size_t size, size_t count, void *userData) {
+        static_cast<std::string *>(userData)->append(data, size * count);
+        return size * count;
+    }
+
+    size_t curlHeader(char *data, size_t size, size_t count, void *userData) {
+        std::string line(data, size * count);
+        size_t colon = line.find(':');
+        if (colon != std::string::npos) {
+            std::string value = line.substr(colon + 1);
+            value.erase(0, value.find_first_not_of(" \t"));
+            value.erase(value.find_last_not_of(" \t\r\n") + 1);
+            static_cast<CefResponse *>(userData)->headers.insert(std::make_pair(line.substr(0, colon), value));
+        }
+        return size * count;
+    }
+}
+
+// Strings
+
+std::u16string CefString::FromUtf8(const std::string &text) {
+    std::u16string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size();) {
+        unsigned char lead = text[i];
+        size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xe ? 3 : (lead >> 3) == 0x1e ? 4 : 1;
+        if (i + length > text.size()) {
+            length = 1;
+        }
+
+        char32_t codePoint = length == 1 ? lead : lead & (0x7f >> length);
+        for (size_t j = 1; j < length; ++j) {
+            codePoint = (codePoint << 6) | (text[i + j] & 0x3f);
+        }
+        i += length;
+
+        if (codePoint >= 0x10000) {
+            codePoint -= 0x10000;
+            result.push_back((char16_t)(0xd800 + (codePoint >> 10)));
+            result.push_back((char16_t)(0xdc00 + (codePoint & 0x3ff)));
+        } else {
+            result.push_back((char16_t)codePoint);
+        }
+    }
+    return result;
+}
+
+std::string CefString::ToUtf8(const std::u16string &text) {
+    std::string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        char32_t codePoint = text[i];
+        if (codePoint >= 0xd800 && codePoint < 0xdc00 && i + 1 < text.size()) {
+            codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (text[++i] - 0xdc00);
+        }
+
+        if (codePoint < 0x80) {
+            result.push_back((char)codePoint);
+        } else if (codePoint < 0x800) {
+            result.push_back((char)(0xc0 | (codePoint >> 6)));
+            result.push_back((char)(0x80 | (codePoint & 0x3f)));
+        } else if (codePoint < 0x10000) {
+            result.push_back((char)(0xe0 | (codePoint >> 12)));
+            result.push_back((char)(0x80 | ((codePoint >> 6) & 0x3f)));
+            result.push_back((char)(0x80 | (codePoint & 0x3f)));
+        } else {
+            result.push_back((char)(0xf0 | (codePoint >> 18)));
+            result.push_back((char)(0x80 | ((codePoint >> 12) & 0x3f)));
+            result.push_back((char)(0x80 | ((codePoint >> 6) & 0x3f)));
+            result.push_back((char)(0x80 | (codePoint & 0x3f)));
+        }
+    }
+    return result;
+}
+
+// Requests and responses
+
+CefRefPtr<CefRequest> CefRequest::Create() {
+    return new CefRequest();
+}
+
+CefRequest::CefRequest() : method("GET"), flags(UR_FLAG_NONE), resourceType(RT_MAIN_FRAME), identifier(nextRequestId++) {}
+
+CefString CefRequest::GetHeaderByName(const CefString &name) {
+    return findHeader(headers, name);
+}
+
+void CefRequest::SetHeaderByName(const CefString &name, const CefString &value, bool overwrite) {
+    setHeader(headers, name, value, overwrite);
+}
+
+CefRefPtr<CefResponse> CefResponse::Create() {
+    return new CefResponse();
+}
+
+CefResponse::CefResponse() : status(0), error(ERR_NONE) {}
+
+CefString CefResponse::GetHeaderByName(const CefString &name) {
+    return findHeader(headers, name);
+}
+
+void CefResponse::SetHeaderByName(const CefString &name, const CefString &value, bool overwrite) {
+    setHeader(headers, name, value, overwrite);
+}
+
+// Streams
+
+CefRefPtr<CefStreamReader> CefStreamReader::CreateForData(void *data, size_t size) {
+    return new CefStreamReader(std::string(static_cast<const char *>(data), size));
+}
+
+CefRefPtr<CefStreamReader> CefStreamReader::CreateForFile(const CefString &fileName) {
+    std::ifstream file(fileName.ToString(), std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+
+    return new CefStreamReader(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+}
+
+CefStreamReader::CefStreamReader(std::string aData) : data(std::move(aData)), position(0) {}
+
+size_t CefStreamReader::Read(void *ptr, size_t size, size_t n) {
+    size_t count = std::min(n, (data.size() - position) / std::max<size_t>(size, 1));
+    memcpy(ptr, data.data() + position, count * size);
+    position += count * size;
+    return count;
+}
+
+int CefStreamReader::Seek(int64_t offset, int whence) {
+    int64_t base = whence == SEEK_SET ? 0 : whence == SEEK_CUR ? (int64_t)position : (int64_t)data.size();
+    if (base + offset < 0 || base + offset > (int64_t)data.size()) {
+        return -1;
+    }
+
+    position = (size_t)(base + offset);
+    return 0;
+}
+
+int64_t CefStreamReader::Tell() {
+    return (int64_t)position;
+}
+
+int CefStreamReader::Eof() {
+    return position >= data.size();
+}
+
+CefStreamResourceHandler::CefStreamResourceHandler(const CefString &aMimeType, CefRefPtr<CefStreamReader> aStream) : CefStreamResourceHandler(200, "OK", aMimeType, {}, aStream) {}
+
+CefStreamResourceHandler::CefStreamResourceHandler(int aStatusCode, const CefString &aStatusText, const CefString &aMimeType, CefResponse::HeaderMap aHeaderMap, CefRefPtr<CefStreamReader> aStream) : statusCode(aStatusCode), statusText(aStatusText), mimeType(aMimeType), headerMap(std::move(aHeaderMap)), stream(aStream) {}
+
+void CefStreamResourceHandler::GetResponseHeaders(CefRefPtr<CefResponse> response, int64_t &response_length, CefString &redirectUrl) {
+    response->SetStatus(statusCode);
+    response->SetStatusText(statusText);
+    response->SetMimeType(mimeType);
+    response->SetHeaderMap(headerMap);
+    response_length = -1;
+}
+
+bool CefStreamResourceHandler::Read(void *data_out, int bytes_to_read, int &bytes_read, CefRefPtr<CefResourceReadCallback> callback) {
+    bytes_read = stream ? (int)stream->Read(data_out, 1, bytes_to_read) : 0;
+    return bytes_read > 0;
+}
+
+// URL requests
+
+CefRefPtr<CefURLRequest> CefURLRequest::Create(CefRefPtr<CefRequest> request, CefRefPtr<CefURLRequestClient> client, CefRefPtr<CefRequestContext> request_context) {
+    CefRefPtr<CefURLRequest> urlRequest = new CefURLRequest(request, client);
+    postUiTask([urlRequest]() {
+        urlRequest->perform();
+    });
+    return urlRequest;
+}
+
+CefURLRequest::CefURLRequest(CefRefPtr<CefRequest> aRequest, CefRefPtr<CefURLRequestClient> aClient) : request(aRequest), client(aClient), response(CefResponse::Create()), status(UR_IO_PENDING), error(ERR_NONE) {}
+
+void CefURLRequest::perform() {
+    std::string body;
+    CURL *curl = curl_easy_init();
+    struct curl_slist *headerList = nullptr;
+    for (const auto &[name, value] : request->headers) {
+        headerList = curl_slist_append(headerList, (name.ToString() + ": " + value.ToString()).c_str());
+    }
+
+    std::string url = request->GetURL().ToString();
+    std::string method = request->GetMethod().ToString();
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, method.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headerList);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curlWrite);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curlHeader);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, response.get());
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    CURLcode result = curl_easy_perform(curl);
+
+    long statusCode = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &statusCode);
+    curl_slist_free_all(headerList);
+    curl_easy_cleanup(curl);
+
+    if (result != CURLE_OK) {
+        status = UR_FAILED;
+        error = ERR_FAILED;
+        response->SetError(ERR_FAILED);
+    } else {
+        status = UR_SUCCESS;
+        response->SetStatus((int)statusCode);
+        std::string contentType = response->GetHeaderByName("Content-Type").ToString();
+        response->SetMimeType(contentType.substr(0, contentType.find(';')));
+        if (!body.empty()) {
+            client->OnDownloadData(this, body.data(), body.size());
+        }
+    }
+
+    client->OnRequestComplete(this);
+}
+
+// Browsers
+
+CefRefPtr<CefRequestContext> CefRequestContext::CreateContext(const CefRequestContextSettings &settings, CefRefPtr<CefRequestContextHandler> handler) {
+    CefRefPtr<CefRequestContext> context = new CefRequestContext();
+    context->settings = settings;
+    return context;
+}
+
+CefRefPtr<CefRequestContext> CefRequestContext::GetGlobalContext() {
+    static CefRefPtr<CefRequestContext> global = new CefRequestContext();
+    return global;
+}
+
+CefFrame::CefFrame(const CefString &aUrl) : url(aUrl) {}
+
+bool CefBrowserHost::CreateBrowser(const CefWindowInfo &windowInfo, CefRefPtr<CefClient> client, const CefString &url, const CefBrowserSettings &settings, CefRefPtr<CefDictionaryValue> extra_info, CefRefPtr<CefRequestContext> request_context) {
+    CefRefPtr<CefBrowser> browser = new CefBrowser(nextBrowserId++, client, request_context, url, settings.windowless_frame_rate);
+    newestBrowser = browser;
+    postUiTask([client, browser]() {
+        CefRefPtr<CefLifeSpanHandler> handler = client ? client->GetLifeSpanHandler() : nullptr;
+        if (handler) {
+            handler->OnAfterCreated(browser);
+        }
+    });
+    return true;
+}
+
+CefBrowserHost::CefBrowserHost(CefBrowser *aBrowser, CefRefPtr<CefClient> aClient, CefRefPtr<CefRequestContext> aRequestContext, int frameRate) : browser(aBrowser), client(aClient), requestContext(aRequestContext), windowlessFrameRate(frameRate) {}
+
+CefRefPtr<CefBrowser> CefBrowserHost::GetBrowser() {
+    return browser;
+}
+
+void CefBrowserHost::CloseBrowser(bool force_close) {
+    if (closed) {
+        return;
+    }
+
+    closed = true;
+    CefRefPtr<CefBrowser> closing = browser;
+    CefRefPtr<CefBrowserHost> host = this;
+    postUiTask([host, closing]() {
+        CefRefPtr<CefLifeSpanHandler> handler = host->client ? host->client->GetLifeSpanHandler() : nullptr;
+        if (handler) {
+            handler->DoClose(closing);
+            handler->OnBeforeClose(closing);
+        }
+
+        // The client usually holds the browser, which holds this host; let go of it once closed.
+        host->client = nullptr;
+    });
+}
+
+CefBrowser::CefBrowser(int aIdentifier, CefRefPtr<CefClient> client, CefRefPtr<CefRequestContext> requestContext, const CefString &url, int frameRate) : identifier(aIdentifier) {
+    host = new CefBrowserHost(this, client, requestContext ? requestContext : CefRequestContext::GetGlobalContext(), frameRate);
+    mainFrame = new CefFrame(url);
+}
+
+// Global functions
+
+bool CefPostTask(CefThreadId threadId, base::OnceClosure closure) {
+    if (threadId == TID_UI) {
+        postUiTask(std::move(closure));
+    } else {
+        background.post(std::move(closure));
+    }
+    return true;
+}
+
+bool CefCurrentlyOn(CefThreadId threadId) {
+    bool onBackground = std::this_thread::get_id() == background.threadId;
+    return threadId == TID_UI ? !onBackground : onBackground;
+}
+
+bool CefInitialize(const CefMainArgs &args, const CefSettings &settings, CefRefPtr<CefApp> app, void *windows_sandbox_info) {
+    application = app;
+    return true;
+}
+
+void CefShutdown() {
+    application = nullptr;
+}
+
+void CefDoMessageLoopWork() {
+    std::deque<base::OnceClosure> tasks;
+    {
+        std::lock_guard<std::mutex> lock(uiMutex);
+        messageLoopWorks++;
+        tasks.swap(uiTasks);
+    }
+
+    for (auto &task : tasks) {
+        task();
+    }
+}
+
+// Test controls
+
+void FakeCef::reset() {
+    background.wait();
+    std::lock_guard<std::mutex> lock(uiMutex);
+    uiTasks.clear();
+    messageLoopWorks = 0;
+    scheduledPumps = 0;
+    newestBrowser = nullptr;
+}
+
+void FakeCef::waitForBackgroundTasks() {
+    background.wait();
+}
+
+unsigned int FakeCef::messageLoopWorkCount() {
+    std::lock_guard<std::mutex> lock(uiMutex);
+    return messageLoopWorks;
+}
+
+unsigned int FakeCef::scheduledPumpCount() {
+    return scheduledPumps;
+}
+
+CefRefPtr<CefBrowser> FakeCef::lastBrowser() {
+    return newestBrowser;
+}
@@ -0,0 +1,20 @@
+#ifndef FAKE_CEF_H
+#define FAKE_CEF_H
+
+#include <include/cef_app.h>
+
+// Test controls for the CEF stand-in in fake_cef.cpp. UI thread tasks, browser creation and URL requests
+// run from CefDoMessageLoopWork() on the calling thread; TID_FILE_BACKGROUND tasks run on a real thread.
+class FakeCef {
+public:
+    // Drops queued UI tasks, waits for background tasks and forgets the browsers created so far.
+    static void reset();
+    static void waitForBackgroundTasks();
+
+    static unsigned int messageLoopWorkCount();
+    // How often CEF asked the application to pump, i.e. OnScheduleMessagePumpWork calls.
+    static unsigned int scheduledPumpCount();
+    static CefRefPtr<CefBrowser> lastBrowser();
+};
+
+#endif
@@ -0,0 +1,176 @@
+#include "fake_gl.h"
+#include <GL/gl.h>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+
+namespace {
+    FakeGLCounters glCounters = {};
+    std::unordered_map<GLuint, std::vector<unsigned char>> buffers;
+    GLuint nextBuffer = 1;
+    GLuint boundUnpackBuffer = 0;
+    GLint unpackRowLength = 0;
+
+    void genBuffers(GLsizei n, GLuint *ids) {
+        for (GLsizei i = 0; i < n; ++i) {
+            ids[i] = nextBuffer++;
+            buffers[ids[i]];
+        }
+    }
+
+    void deleteBuffers(GLsizei n, const GLuint *ids) {
+        for (GLsizei i = 0; i < n; ++i) {
+            buffers.erase(ids[i]);
+        }
+    }
+
+    void bindBuffer(GLenum target, GLuint buffer) {
+        if (target == GL_PIXEL_UNPACK_BUFFER) {
+            boundUnpackBuffer = buffer;
+        }
+    }
+
+    void bufferData(GLenum target, ptrdiff_t size, const void *data, GLenum usage) {
+        auto it = buffers.find(boundUnpackBuffer);
+        if (target != GL_PIXEL_UNPACK_BUFFER || it == buffers.end()) {
+            return;
+        }
+
+        glCounters.bufferDatas++;
+        if (!data && !it->second.empty()) {
+            glCounters.orphanedBuffers++;
+        }
+        it->second.assign((size_t)size, 0);
+        if (data) {
+            memcpy(it->second.data(), data, size);
+        }
+    }
+
+    void *mapBuffer(GLenum target, GLenum access) {
+        auto it = buffers.find(boundUnpackBuffer);
+        if (target != GL_PIXEL_UNPACK_BUFFER || it == buffers.end() || it->second.empty()) {
+            return nullptr;
+        }
+
+        glCounters.mappedBuffers++;
+        return it->second.data();
+    }
+
+    GLboolean unmapBuffer(GLenum target) {
+        return GL_TRUE;
+    }
+}
+
+void FakeGL::reset() {
+    glCounters = {};
+}
+
+const FakeGLCounters &FakeGL::counters() {
+    return glCounters;
+}
+
+unsigned int FakeGL::drawCalls() {
+    return glCounters.begins + glCounters.drawArrays;
+}
+
+extern "C" {
+
+void (*glXGetProcAddressARB(const GLubyte *procName))(void) {
+    static const std::unordered_map<std::string, void (*)(void)> functions = {
+        {"glGenBuffers", (void (*)(void))genBuffers},
+        {"glDeleteBuffers", (void (*)(void))deleteBuffers},
+        {"glBindBuffer", (void (*)(void))bindBuffer},
+        {"glBufferData", (void (*)(void))bufferData},
+        {"glMapBuffer", (void (*)(void))mapBuffer},
+        {"glUnmapBuffer", (void (*)(void))unmapBuffer},
+    };
+
+    auto it = functions.find((const char *)procName);
+    return it == functions.end() ? nullptr : it->second;
+}
+
+void glBegin(GLenum mode) {
+    glCounters.begins++;
+}
+
+void glEnd(void) {}
+void glVertex2f(GLfloat x, GLfloat y) {}
+void glTexCoord2f(GLfloat s, GLfloat t) {}
+void glColor3f(GLfloat red, GLfloat green, GLfloat blue) {}
+void glColor4f(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {}
+void glLineWidth(GLfloat width) {}
+void glEnable(GLenum cap) {}
+void glDisable(GLenum cap) {}
+void glDepthMask(GLboolean flag) {}
+void glPushMatrix(void) {}
+void glPopMatrix(void) {}
+void glLoadIdentity(void) {}
+void glTranslatef(GLfloat x, GLfloat y, GLfloat z) {}
+void glRotatef(GLfloat angle, GLfloat x, GLfloat y, GLfloat z) {}
+void glScalef(GLfloat x, GLfloat y, GLfloat z) {}
+void glEnableClientState(GLenum cap) {}
+void glDisableClientState(GLenum cap) {}
+void glVertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *ptr) {}
+void glTexCoordPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *ptr) {}
+
+// Identity matrices over a 2x2 viewport: one pixel per unit.
+void glGetFloatv(GLenum pname, GLfloat *params) {
+    for (int i = 0; i < 16; ++i) {
+        params[i] = i % 5 == 0 ? 1.0f : 0.0f;
+    }
+}
+
+void glGetIntegerv(GLenum pname, GLint *params) {
+    if (pname == GL_VIEWPORT) {
+        params[0] = 0;
+        params[1] = 0;
+        params[2] = 2;
+        params[3] = 2;
+    }
+}
+
+void glDrawArrays(GLenum mode, GLint first, GLsizei count) {
+    glCounters.drawArrays++;
+    glCounters.drawArraysVertices += count;
+}
+
+void glPixelStorei(GLenum pname, GLint param) {
+    if (pname == GL_UNPACK_ROW_LENGTH) {
+        unpackRowLength = param;
+    }
+}
+
+void glTexParameteri(GLenum target, GLenum pname, GLint param) {}
+
+void glTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels) {
+    glCounters.texImages++;
+}
+
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels) {
+    glCounters.texSubImages++;
+    glCounters.texSubImagePixels += (size_t)width * height;
+
+    auto it = buffers.find(boundUnpackBuffer);
+    if (boundUnpackBuffer == 0 || it == buffers.end()) {
+        return;
+    }
+
+    // With a pixel buffer bound, the pointer is an offset into it.
+    glCounters.pixelBufferUploads++;
+    size_t rowLength = unpackRowLength > 0 ? unpackRowLength : width;
+    size_t end = (size_t)pixels + (((size_t)height - 1) * rowLength + width) * 4;
+    if (height > 0 && end > it->second.size()) {
+        glCounters.outOfBoundsReads++;
+    }
+}
+
+void glDeleteTextures(GLsizei n, const GLuint *textures) {
+    glCounters.deletedTextures += n;
+}
+
+}
@@ -0,0 +1,33 @@
+#ifndef FAKE_GL_H
+#define FAKE_GL_H
+
+#include <cstddef>
+
+struct FakeGLCounters {
+    unsigned int begins;
+    unsigned int drawArrays;
+    size_t drawArraysVertices;
+    unsigned int texImages;
+    unsigned int texSubImages;
+    size_t texSubImagePixels;
+    unsigned int deletedTextures;
+    unsigned int bufferDatas;
+    unsigned int orphanedBuffers;
+    unsigned int mappedBuffers;
+    unsigned int pixelBufferUploads;
+    // Sub-images whose last source row ends past the bound pixel buffer.
+    unsigned int outOfBoundsReads;
+};
+
+// Test controls for the GL functions in fake_gl.cpp. Nothing is drawn; calls are counted, and pixel
+// buffer objects are backed by memory so uploads through them can be checked.
+class FakeGL {
+public:
+    static void reset();
+    static const FakeGLCounters &counters();
+
+    // Draw calls: immediate mode blocks plus vertex array draws.
+    static unsigned int drawCalls();
+};
+
+#endif
@@ -0,0 +1,621 @@
+#include "fake_xplm.h"
+#include <XPLMDataAccess.h>
+#include <XPLMDisplay.h>
+#include <XPLMGraphics.h>
+#include <XPLMMenus.h>
+#include <XPLMPlanes.h>
+#include <XPLMPlugin.h>
+#include <XPLMProcessing.h>
+#include <XPLMSound.h>
+#include <XPLMUtilities.h>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+    struct FakeDataref {
+        std::string name;
+        XPLMDataTypeID types = xplmType_Unknown;
+        bool removed = false;
+        int intValue = 0;
+        float floatValue = 0.0f;
+        double doubleValue = 0.0;
+        std::vector<int> intArray;
+        std::string data;
+        XPLMGetDatai_f readInt = nullptr;
+        XPLMSetDatai_f writeInt = nullptr;
+        XPLMGetDataf_f readFloat = nullptr;
+        XPLMSetDataf_f writeFloat = nullptr;
+        XPLMGetDatad_f readDouble = nullptr;
+        XPLMSetDatad_f writeDouble = nullptr;
+        XPLMGetDatavi_f readIntArray = nullptr;
+        XPLMSetDatavi_f writeIntArray = nullptr;
+        XPLMGetDatab_f readData = nullptr;
+        XPLMSetDatab_f writeData = nullptr;
+        void *readRefcon = nullptr;
+        void *writeRefcon = nullptr;
+        bool accessor = false;
+    };
+
+    struct FakeCommandHandler {
+        XPLMCommandCallback_f callback;
+        void *refcon;
+    };
+
+    struct FakeCommand {
+        std::string name;
+        unsigned int count = 0;
+        std::vector<FakeCommandHandler> handlers;
+    };
+
+    struct FakeWindow {
+        XPLMCreateWindow_t params;
+    };
+
+    // Records are never freed, so handles cached by the plugin survive reset().
+    std::mutex mutex;
+    std::deque<FakeDataref> datarefStorage;
+    std::unordered_map<std::string, FakeDataref *> datarefs;
+    std::deque<FakeCommand> commandStorage;
+    std::unordered_map<std::string, FakeCommand *> commands;
+    std::deque<FakeWindow> windows;
+    XPLMWindowID keyboardFocus = nullptr;
+    std::thread::id simThread = std::this_thread::get_id();
+    std::string log;
+    unsigned int offThreadDebugs = 0;
+    unsigned int measureStrings = 0;
+    int nextTextureId = 1;
+    int boundTexture = 0;
+    float elapsedTime = 0.0f;
+    float flightLoopIntervalSeconds = 0.0f;
+    int cycleNumber = 0;
+    std::string systemPath = "/tmp/X-Plane 12/";
+    std::string aircraftFilename = "Cessna_172SP.acf";
+    std::string aircraftPath = "/tmp/X-Plane 12/Aircraft/Laminar Research/Cessna 172 SP/Cessna_172SP.acf";
+    int menuStorage[2];
+
+    FakeDataref *dataref(XPLMDataRef ref) {
+        FakeDataref *fake = (FakeDataref *)ref;
+        return fake && !fake->removed ? fake : nullptr;
+    }
+
+    FakeDataref &valueDataref(const std::string &name, XPLMDataTypeID type) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = datarefs.find(name);
+        if (it == datarefs.end() || it->second->accessor) {
+            if (it != datarefs.end()) {
+                it->second->removed = true;
+            }
+            FakeDataref &created = datarefStorage.emplace_back();
+            created.name = name;
+            it = datarefs.insert_or_assign(name, &created).first;
+        }
+        it->second->types = type;
+        return *it->second;
+    }
+
+    void invokeCommand(XPLMCommandRef ref, XPLMCommandPhase phase) {
+        FakeCommand *command = (FakeCommand *)ref;
+        if (!command) {
+            return;
+        }
+
+        std::vector<FakeCommandHandler> handlers;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (phase == xplm_CommandBegin) {
+                command->count++;
+            }
+            handlers = command->handlers;
+        }
+
+        for (auto &handler : handlers) {
+            if (!handler.callback(ref, phase, handler.refcon)) {
+                break;
+            }
+        }
+    }
+}
+
+void FakeXPLM::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &[name, ref] : datarefs) {
+        ref->removed = true;
+    }
+    datarefs.clear();
+    for (auto &[name, command] : commands) {
+        command->handlers.clear();
+    }
+    commands.clear();
+    keyboardFocus = nullptr;
+    simThread = std::this_thread::get_id();
+    log.clear();
+    offThreadDebugs = 0;
+    measureStrings = 0;
+    boundTexture = 0;
+    elapsedTime = 0.0f;
+    flightLoopIntervalSeconds = 0.0f;
+    cycleNumber = 0;
+}
+
+void FakeXPLM::setElapsedTime(float seconds) {
+    elapsedTime = seconds;
+    cycleNumber++;
+}
+
+void FakeXPLM::advanceTime(float seconds) {
+    setElapsedTime(elapsedTime + seconds);
+}
+
+void FakeXPLM::setSystemPath(const std::string &path) {
+    systemPath = path;
+}
+
+void FakeXPLM::setAircraft(const std::string &filename, const std::string &path) {
+    aircraftFilename = filename;
+    aircraftPath = path;
+}
+
+void FakeXPLM::setInt(const std::string &name, int value) {
+    valueDataref(name, xplmType_Int).intValue = value;
+}
+
+void FakeXPLM::setFloat(const std::string &name, float value) {
+    FakeDataref &ref = valueDataref(name, xplmType_Float | xplmType_Double);
+    ref.floatValue = value;
+    ref.doubleValue = value;
+}
+
+void FakeXPLM::setDouble(const std::string &name, double value) {
+    FakeDataref &ref = valueDataref(name, xplmType_Float | xplmType_Double);
+    ref.doubleValue = value;
+    ref.floatValue = (float)value;
+}
+
+void FakeXPLM::setIntArray(const std::string &name, const std::vector<int> &values) {
+    valueDataref(name, xplmType_IntArray).intArray = values;
+}
+
+void FakeXPLM::setData(const std::string &name, const std::string &value) {
+    valueDataref(name, xplmType_Data).data = value;
+}
+
+bool FakeXPLM::hasDataref(const std::string &name) {
+    return XPLMFindDataRef(name.c_str()) != nullptr;
+}
+
+int FakeXPLM::getInt(const std::string &name) {
+    return XPLMGetDatai(XPLMFindDataRef(name.c_str()));
+}
+
+float FakeXPLM::getFloat(const std::string &name) {
+    return XPLMGetDataf(XPLMFindDataRef(name.c_str()));
+}
+
+std::string FakeXPLM::getData(const std::string &name) {
+    XPLMDataRef ref = XPLMFindDataRef(name.c_str());
+    int length = XPLMGetDatab(ref, nullptr, 0, 0);
+    std::string value(std::max(length, 0), '\0');
+    XPLMGetDatab(ref, value.data(), 0, length);
+    return value.substr(0, strnlen(value.c_str(), value.size()));
+}
+
+std::string FakeXPLM::debugLog() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return log;
+}
+
+unsigned int FakeXPLM::offThreadDebugCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return offThreadDebugs;
+}
+
+unsigned int FakeXPLM::commandCount(const std::string &name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = commands.find(name);
+    return it == commands.end() ? 0 : it->second->count;
+}
+
+unsigned int FakeXPLM::measureStringCount() {
+    return measureStrings;
+}
+
+int FakeXPLM::lastBoundTexture() {
+    return boundTexture;
+}
+
+float FakeXPLM::flightLoopInterval() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return flightLoopIntervalSeconds;
+}
+
+// XPLMDataAccess
+
+XPLMDataRef XPLMFindDataRef(const char *inDataRefName) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = datarefs.find(inDataRefName);
+    return it == datarefs.end() ? nullptr : it->second;
+}
+
+int XPLMGetDatai(XPLMDataRef inDataRef) {
+    FakeDataref *ref = dataref(inDataRef);
+    if (!ref || !(ref->types & xplmType_Int)) {
+        return 0;
+    }
+
+    return ref->readInt ? ref->readInt(ref->readRefcon) : ref->intValue;
+}
+
+void XPLMSetDatai(XPLMDataRef inDataRef, int inValue) {
+    FakeDataref *ref = dataref(inDataRef);
+    if (!ref || !(ref->types & xplmType_Int)) {
+        return;
+    }
+
+    if (ref->writeInt) {
+        ref->writeInt(ref->writeRefcon, inValue);
+    } else if (!ref->accessor) {
+        ref->intValue = inValue;
+    }
+}
+
+float XPLMGetDataf(XPLMDataRef inDataRef) {
+    FakeDataref *ref = dataref(inDataRef);
+    if (!ref || !(ref->types & xplmType_Float)) {
+        return 0.0f;
+    }
+
+    return ref->readFloat ? ref->readFloat(ref->readRefcon) : ref->floatValue;
+}
+
+void XPLMSetDataf(XPLMDataRef inDataRef, float inValue) {
+    FakeDataref *ref = dataref(inDataRef);
+    if (!ref || !(ref->types & xplmType_Float)) {
+        return;
+    }
+
+    if (ref->writeFloat) {
+        ref->writeFloat(ref->writeRefcon, inValue);
+    } else if (!ref->accessor) {
+        ref->floatValue = inValue;
+        ref->doubleValue = inValue;
+    }
+}
+
+double XPLMGetDatad(XPLMDataRef inDataRef) {
+    FakeDataref *ref = dataref(inDataRef);
+    if (!ref || !(ref->types & xplmType_Double)) {
+        return 0.0;
+    }
+
+    return ref->readDouble ? ref->readDouble(ref->readRefcon) : ref->doubleValue;
+}
+
+void XPLMSetDatad(XPLMDataRef inDataRef, double inValue) {
+    FakeDataref *ref = dataref(inDataRef);
+    if (!ref || !(ref->types & xplmType_Double)) {
+        return;
+    }
+
+    if (ref->writeDouble) {
+        ref->writeDouble(ref->writeRefcon, inValue);
+    } else if (!ref->accessor) {
+        ref->doubleValue = inValue;
+        ref->floatValue = (float)inValue;
+    }
+}
+
+int XPLMGetDatavi(XPLMDataRef inDataRef, int *outValues, int inOffset, int inMax) {
+    FakeDataref *ref = dataref(inDataRef);
+    if (!ref || !(ref->types & xplmType_IntArray)) {
+        return 0;
+    }
+
+    if (ref->readIntArray) {
+        return ref->readIntArray(ref->readRefcon, outValues, inOffset, inMax);
+    }
+
+    int size = (int)ref->intArray.size();
+    if (!outValues) {
+        return size;
+    }
+
+    int count = std::clamp(size - inOffset, 0, inMax);
+    std::copy_n(ref->intArray.begin() + inOffset, count, outValues);
+    return count;
+}
+
+void XPLMSetDatavi(XPLMDataRef inDataRef, int *inValues, int inOffset, int inCount) {
+    FakeDataref *ref = dataref(inDataRef);
+    if (!ref || !(ref->types & xplmType_IntArray)) {
+        return;
+    }
+
+    if (ref->writeIntArray) {
+        ref->writeIntArray(ref->writeRefcon, inValues, inOffset, inCount);
+    } else if (!ref->accessor) {
+        if ((int)ref->intArray.size() < inOffset + inCount) {
+            ref->intArray.resize(inOffset + inCount);
+        }
+        std::copy_n(inValues, inCount, ref->intArray.begin() + inOffset);
+    }
+}
+
+int XPLMGetDatab(XPLMDataRef inDataRef, void *outValue, int inOffset, int inMaxBytes) {
+    FakeDataref *ref = dataref(inDataRef);
+    if (!ref || !(ref->types & xplmType_Data)) {
+        return 0;
+    }
+
+    if (ref->readData) {
+        return ref->readData(ref->readRefcon, outValue, inOffset, inMaxBytes);
+    }
+
+    int size = (int)ref->data.size();
+    if (!outValue) {
+        return size;
+    }
+
+    int count = std::clamp(size - inOffset, 0, inMaxBytes);
+    memcpy(outValue, ref->data.data() + inOffset, count);
+    return count;
+}
+
+void XPLMSetDatab(XPLMDataRef inDataRef, void *inValue, int inOffset, int inLength) {
+    FakeDataref *ref = dataref(inDataRef);
+    if (!ref || !(ref->types & xplmType_Data)) {
+        return;
+    }
+
+    if (ref->writeData) {
+        ref->writeData(ref->writeRefcon, inValue, inOffset, inLength);
+    } else if (!ref->accessor) {
+        if ((int)ref->data.size() < inOffset + inLength) {
+            ref->data.resize(inOffset + inLength);
+        }
+        memcpy(ref->data.data() + inOffset, inValue, inLength);
+    }
+}
+
+XPLMDataRef XPLMRegisterDataAccessor(const char *inDataName, XPLMDataTypeID inDataType, int inIsWritable, XPLMGetDatai_f inReadInt, XPLMSetDatai_f inWriteInt, XPLMGetDataf_f inReadFloat, XPLMSetDataf_f inWriteFloat, XPLMGetDatad_f inReadDouble, XPLMSetDatad_f inWriteDouble, XPLMGetDatavi_f inReadIntArray, XPLMSetDatavi_f inWriteIntArray, XPLMGetDatavf_f inReadFloatArray, XPLMSetDatavf_f inWriteFloatArray, XPLMGetDatab_f inReadData, XPLMSetDatab_f inWriteData, void *inReadRefcon, void *inWriteRefcon) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = datarefs.find(inDataName);
+    if (it != datarefs.end()) {
+        it->second->removed = true;
+    }
+
+    FakeDataref &ref = datarefStorage.emplace_back();
+    ref.name = inDataName;
+    ref.types = inDataType;
+    ref.accessor = true;
+    ref.readInt = inReadInt;
+    ref.readFloat = inReadFloat;
+    ref.readDouble = inReadDouble;
+    ref.readIntArray = inReadIntArray;
+    ref.readData = inReadData;
+    if (inIsWritable) {
+        ref.writeInt = inWriteInt;
+        ref.writeFloat = inWriteFloat;
+        ref.writeDouble = inWriteDouble;
+        ref.writeIntArray = inWriteIntArray;
+        ref.writeData = inWriteData;
+    }
+    ref.readRefcon = inReadRefcon;
+    ref.writeRefcon = inWriteRefcon;
+    datarefs.insert_or_assign(ref.name, &ref);
+    return &ref;
+}
+
+void XPLMUnregisterDataAccessor(XPLMDataRef inDataRef) {
+    std::lock_guard<std::mutex> lock(mutex);
+    FakeDataref *ref = (FakeDataref *)inDataRef;
+    if (!ref || ref->removed) {
+        return;
+    }
+
+    ref->removed = true;
+    auto it = datarefs.find(ref->name);
+    if (it != datarefs.end() && it->second == ref) {
+        datarefs.erase(it);
+    }
+}
+
+// XPLMUtilities
+
+void XPLMDebugString(const char *inString) {
+    std::lock_guard<std::mutex> lock(mutex);
+    log += inString;
+    if (std::this_thread::get_id() != simThread) {
+        offThreadDebugs++;
+    }
+}
+
+void XPLMGetSystemPath(char *outSystemPath) {
+    strcpy(outSystemPath, systemPath.c_str());
+}
+
+XPLMLanguageCode XPLMGetLanguage(void) {
+    return xplm_Language_English;
+}
+
+XPLMCommandRef XPLMFindCommand(const char *inName) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = commands.find(inName);
+    return it == commands.end() ? nullptr : it->second;
+}
+
+XPLMCommandRef XPLMCreateCommand(const char *inName, const char *inDescription) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = commands.find(inName);
+    if (it != commands.end()) {
+        return it->second;
+    }
+
+    FakeCommand &command = commandStorage.emplace_back();
+    command.name = inName;
+    commands[command.name] = &command;
+    return &command;
+}
+
+void XPLMCommandBegin(XPLMCommandRef inCommand) {
+    invokeCommand(inCommand, xplm_CommandBegin);
+}
+
+void XPLMCommandEnd(XPLMCommandRef inCommand) {
+    invokeCommand(inCommand, xplm_CommandEnd);
+}
+
+void XPLMCommandOnce(XPLMCommandRef inCommand) {
+    invokeCommand(inCommand, xplm_CommandBegin);
+    invokeCommand(inCommand, xplm_CommandEnd);
+}
+
+void XPLMRegisterCommandHandler(XPLMCommandRef inComand, XPLMCommandCallback_f inHandler, int inBefore, void *inRefcon) {
+    std::lock_guard<std::mutex> lock(mutex);
+    FakeCommand *command = (FakeCommand *)inComand;
+    if (command) {
+        command->handlers.push_back({inHandler, inRefcon});
+    }
+}
+
+void XPLMUnregisterCommandHandler(XPLMCommandRef inComand, XPLMCommandCallback_f inHandler, int inBefore, void *inRefcon) {
+    std::lock_guard<std::mutex> lock(mutex);
+    FakeCommand *command = (FakeCommand *)inComand;
+    if (!command) {
+        return;
+    }
+
+    std::erase_if(command->handlers, [&](const FakeCommandHandler &handler) {
+        return handler.callback == inHandler && handler.refcon == inRefcon;
+    });
+}
+
+// XPLMProcessing
+
+float XPLMGetElapsedTime(void) {
+    return elapsedTime;
+}
+
+int XPLMGetCycleNumber(void) {
+    return cycleNumber;
+}
+
+void XPLMRegisterFlightLoopCallback(XPLMFlightLoop_f inFlightLoop, float inInterval, void *inRefcon) {
+    std::lock_guard<std::mutex> lock(mutex);
+    flightLoopIntervalSeconds = inInterval;
+}
+
+void XPLMUnregisterFlightLoopCallback(XPLMFlightLoop_f inFlightLoop, void *inRefcon) {}
+
+void XPLMSetFlightLoopCallbackInterval(XPLMFlightLoop_f inFlightLoop, float inInterval, int inRelativeToNow, void *inRefcon) {
+    std::lock_guard<std::mutex> lock(mutex);
+    flightLoopIntervalSeconds = inInterval;
+}
+
+// XPLMGraphics
+
+void XPLMSetGraphicsState(int inEnableFog, int inNumberTexUnits, int inEnableLighting, int inEnableAlphaTesting, int inEnableAlphaBlending, int inEnableDepthTesting, int inEnableDepthWriting) {}
+
+void XPLMBindTexture2d(int inTextureNum, int inTextureUnit) {
+    boundTexture = inTextureNum;
+}
+
+void XPLMGenerateTextureNumbers(int *outTextureIDs, int inCount) {
+    for (int i = 0; i < inCount; ++i) {
+        outTextureIDs[i] = nextTextureId++;
+    }
+}
+
+void XPLMDrawString(float *inColorRGB, int inXOffset, int inYOffset, const char *inChar, int *inWordWrapWidth, XPLMFontID inFontID) {}
+
+float XPLMMeasureString(XPLMFontID inFontID, const char *inChar, int inNumChars) {
+    // Every byte is 8 pixels wide, 6 in the basic font.
+    measureStrings++;
+    return inNumChars * (inFontID == xplmFont_Basic ? 6.0f : 8.0f);
+}
+
+// XPLMDisplay
+
+int XPLMRegisterDrawCallback(XPLMDrawCallback_f inCallback, XPLMDrawingPhase inPhase, int inWantsBefore, void *inRefcon) {
+    return 1;
+}
+
+int XPLMUnregisterDrawCallback(XPLMDrawCallback_f inCallback, XPLMDrawingPhase inPhase, int inWantsBefore, void *inRefcon) {
+    return 1;
+}
+
+XPLMWindowID XPLMCreateWindowEx(XPLMCreateWindow_t *inParams) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return &windows.emplace_back(FakeWindow{*inParams});
+}
+
+void XPLMDestroyWindow(XPLMWindowID inWindowID) {
+    if (keyboardFocus == inWindowID) {
+        keyboardFocus = nullptr;
+    }
+}
+
+void XPLMGetScreenBoundsGlobal(int *outLeft, int *outTop, int *outRight, int *outBottom) {
+    *outLeft = 0;
+    *outTop = 1080;
+    *outRight = 1920;
+    *outBottom = 0;
+}
+
+void XPLMGetWindowGeometry(XPLMWindowID inWindowID, int *outLeft, int *outTop, int *outRight, int *outBottom) {
+    FakeWindow *window = (FakeWindow *)inWindowID;
+    *outLeft = window ? window->params.left : 0;
+    *outTop = window ? window->params.top : 0;
+    *outRight = window ? window->params.right : 0;
+    *outBottom = window ? window->params.bottom : 0;
+}
+
+void XPLMSetWindowTitle(XPLMWindowID inWindowID, const char *inWindowTitle) {}
+void XPLMSetWindowPositioningMode(XPLMWindowID inWindowID, XPLMWindowPositioningMode inPositioningMode, int inMonitorIndex) {}
+void XPLMBringWindowToFront(XPLMWindowID inWindow) {}
+
+void XPLMTakeKeyboardFocus(XPLMWindowID inWindow) {
+    keyboardFocus = inWindow;
+}
+
+int XPLMHasKeyboardFocus(XPLMWindowID inWindow) {
+    return inWindow && keyboardFocus == inWindow;
+}
+
+// XPLMMenus
+
+XPLMMenuID XPLMFindPluginsMenu(void) {
+    return &menuStorage[0];
+}
+
+XPLMMenuID XPLMCreateMenu(const char *inName, XPLMMenuID inParentMenu, int inParentItem, XPLMMenuHandler_f inHandler, void *inMenuRef) {
+    return &menuStorage[1];
+}
+
+int XPLMAppendMenuItem(XPLMMenuID inMenu, const char *inItemName, void *inItemRef, int inDeprecatedAndIgnored) {
+    return 0;
+}
+
+// XPLMPlanes
+
+void XPLMGetNthAircraftModel(int inIndex, char *outFileName, char *outPath) {
+    strcpy(outFileName, inIndex == XPLM_USER_AIRCRAFT ? aircraftFilename.c_str() : "");
+    strcpy(outPath, inIndex == XPLM_USER_AIRCRAFT ? aircraftPath.c_str() : "");
+}
+
+// XPLMPlugin
+
+void XPLMEnableFeature(const char *inFeature, int inEnable) {}
+
+// XPLMSound
+
+FMOD_CHANNEL *XPLMPlayPCMOnBus(void *audioBuffer, uint32_t bufferSize, FMOD_SOUND_FORMAT soundFormat, int freqHz, int numChannels, int loops, XPLMAudioBus audioType, XPLMPCMComplete_f inCallback, void *inRefcon) {
+    return nullptr;
+}
+
+FMOD_RESULT XPLMSetAudioVolume(FMOD_CHANNEL *fmod_channel, float source_volume) {
+    return 0;
+}
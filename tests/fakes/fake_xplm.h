@@ -0,0 +1,42 @@
+#ifndef FAKE_XPLM_H
+#define FAKE_XPLM_H
+
+#include <string>
+#include <vector>
+
+// Test controls for the in-memory XPLM in fake_xplm.cpp. Datarefs set here behave like X-Plane's own:
+// they can be found, read and written by the plugin. Datarefs the plugin registers are reached through
+// its accessors, the same as another plugin would see them.
+class FakeXPLM {
+public:
+    // Forgets all datarefs, commands, windows and log output, and makes the calling thread the sim thread.
+    // Handles from before stay valid, but read as zero and can't be found anymore.
+    static void reset();
+
+    static void setElapsedTime(float seconds);
+    static void advanceTime(float seconds);
+    static void setSystemPath(const std::string &path);
+    static void setAircraft(const std::string &filename, const std::string &path);
+
+    static void setInt(const std::string &name, int value);
+    static void setFloat(const std::string &name, float value);
+    static void setDouble(const std::string &name, double value);
+    static void setIntArray(const std::string &name, const std::vector<int> &values);
+    static void setData(const std::string &name, const std::string &value);
+
+    static bool hasDataref(const std::string &name);
+    static int getInt(const std::string &name);
+    static float getFloat(const std::string &name);
+    static std::string getData(const std::string &name);
+
+    static std::string debugLog();
+    // XPLM may only be called from the sim thread; the fake counts the debug strings that weren't.
+    static unsigned int offThreadDebugCount();
+    static unsigned int commandCount(const std::string &name);
+    static unsigned int measureStringCount();
+    static int lastBoundTexture();
+    // Interval last passed to XPLMRegisterFlightLoopCallback() or XPLMSetFlightLoopCallbackInterval().
+    static float flightLoopInterval();
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef XPLM_DATA_ACCESS_H
+#define XPLM_DATA_ACCESS_H
+
+#include "XPLMDefs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void *XPLMDataRef;
+
+enum {
+    xplmType_Unknown = 0,
+    xplmType_Int = 1,
+    xplmType_Float = 2,
+    xplmType_Double = 4,
+    xplmType_FloatArray = 8,
+    xplmType_IntArray = 16,
+    xplmType_Data = 32,
+};
+typedef int XPLMDataTypeID;
+
+typedef int (*XPLMGetDatai_f)(void *inRefcon);
+typedef void (*XPLMSetDatai_f)(void *inRefcon, int inValue);
+typedef float (*XPLMGetDataf_f)(void *inRefcon);
+typedef void (*XPLMSetDataf_f)(void *inRefcon, float inValue);
+typedef double (*XPLMGetDatad_f)(void *inRefcon);
+typedef void (*XPLMSetDatad_f)(void *inRefcon, double inValue);
+typedef int (*XPLMGetDatavi_f)(void *inRefcon, int *outValues, int inOffset, int inMax);
+typedef void (*XPLMSetDatavi_f)(void *inRefcon, int *inValues, int inOffset, int inCount);
+typedef int (*XPLMGetDatavf_f)(void *inRefcon, float *outValues, int inOffset, int inMax);
+typedef void (*XPLMSetDatavf_f)(void *inRefcon, float *inValues, int inOffset, int inCount);
+typedef int (*XPLMGetDatab_f)(void *inRefcon, void *outValue, int inOffset, int inMaxLength);
+typedef void (*XPLMSetDatab_f)(void *inRefcon, void *inValue, int inOffset, int inLength);
+
+XPLMDataRef XPLMFindDataRef(const char *inDataRefName);
+int XPLMGetDatai(XPLMDataRef inDataRef);
+void XPLMSetDatai(XPLMDataRef inDataRef, int inValue);
+float XPLMGetDataf(XPLMDataRef inDataRef);
+void XPLMSetDataf(XPLMDataRef inDataRef, float inValue);
+double XPLMGetDatad(XPLMDataRef inDataRef);
+void XPLMSetDatad(XPLMDataRef inDataRef, double inValue);
+int XPLMGetDatavi(XPLMDataRef inDataRef, int *outValues, int inOffset, int inMax);
+void XPLMSetDatavi(XPLMDataRef inDataRef, int *inValues, int inOffset, int inCount);
+int XPLMGetDatab(XPLMDataRef inDataRef, void *outValue, int inOffset, int inMaxBytes);
+void XPLMSetDatab(XPLMDataRef inDataRef, void *inValue, int inOffset, int inLength);
+
+XPLMDataRef XPLMRegisterDataAccessor(const char *inDataName,
+                                     XPLMDataTypeID inDataType,
+                                     int inIsWritable,
+                                     XPLMGetDatai_f inReadInt,
+                                     XPLMSetDatai_f inWriteInt,
+                                     XPLMGetDataf_f inReadFloat,
+                                     XPLMSetDataf_f inWriteFloat,
+                                     XPLMGetDatad_f inReadDouble,
+                                     XPLMSetDatad_f inWriteDouble,
+                                     XPLMGetDatavi_f inReadIntArray,
+                                     XPLMSetDatavi_f inWriteIntArray,
+                                     XPLMGetDatavf_f inReadFloatArray,
+                                     XPLMSetDatavf_f inWriteFloatArray,
+                                     XPLMGetDatab_f inReadData,
+                                     XPLMSetDatab_f inWriteData,
+                                     void *inReadRefcon,
+                                     void *inWriteRefcon);
+void XPLMUnregisterDataAccessor(XPLMDataRef inDataRef);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef XPLM_DEFS_H
+#define XPLM_DEFS_H
+
+// Stand-in for the X-Plane SDK header, declaring only what the plugin uses. See fake_xplm.h.
+
+#ifdef __cplusplus
+#define PLUGIN_API extern "C" __attribute__((visibility("default")))
+#else
+#define PLUGIN_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int XPLMPluginID;
+
+#define XPLM_NO_PLUGIN_ID (-1)
+
+enum {
+    xplm_ShiftFlag = 1,
+    xplm_OptionAltFlag = 2,
+    xplm_ControlFlag = 4,
+    xplm_DownFlag = 8,
+    xplm_UpFlag = 16,
+};
+typedef int XPLMKeyFlags;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef XPLM_DISPLAY_H
+#define XPLM_DISPLAY_H
+
+#include "XPLMDefs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    xplm_Phase_FirstCockpit = 35,
+    xplm_Phase_Panel = 40,
+    xplm_Phase_Gauges = 45,
+    xplm_Phase_Window = 50,
+    xplm_Phase_LastCockpit = 55,
+};
+typedef int XPLMDrawingPhase;
+
+typedef int (*XPLMDrawCallback_f)(XPLMDrawingPhase inPhase, int inIsBefore, void *inRefcon);
+
+int XPLMRegisterDrawCallback(XPLMDrawCallback_f inCallback, XPLMDrawingPhase inPhase, int inWantsBefore, void *inRefcon);
+int XPLMUnregisterDrawCallback(XPLMDrawCallback_f inCallback, XPLMDrawingPhase inPhase, int inWantsBefore, void *inRefcon);
+
+typedef void *XPLMWindowID;
+
+enum {
+    xplm_MouseDown = 1,
+    xplm_MouseDrag = 2,
+    xplm_MouseUp = 3,
+};
+typedef int XPLMMouseStatus;
+
+enum {
+    xplm_CursorDefault = 0,
+    xplm_CursorHidden = 1,
+    xplm_CursorArrow = 2,
+    xplm_CursorCustom = 3,
+};
+typedef int XPLMCursorStatus;
+
+enum {
+    xplm_WindowLayerFlightOverlay = 0,
+    xplm_WindowLayerFloatingWindows = 1,
+    xplm_WindowLayerModal = 2,
+    xplm_WindowLayerGrowlNotifications = 3,
+};
+typedef int XPLMWindowLayer;
+
+enum {
+    xplm_WindowDecorationNone = 0,
+    xplm_WindowDecorationRoundRectangle = 1,
+    xplm_WindowDecorationSelfDecorated = 2,
+    xplm_WindowDecorationSelfDecoratedResizable = 3,
+};
+typedef int XPLMWindowDecoration;
+
+enum {
+    xplm_WindowPositionFree = 0,
+    xplm_WindowCenterOnMonitor = 1,
+    xplm_WindowFullScreenOnMonitor = 2,
+    xplm_WindowFullScreenOnAllMonitors = 3,
+    xplm_WindowPopOut = 4,
+    xplm_WindowVR = 5,
+};
+typedef int XPLMWindowPositioningMode;
+
+typedef void (*XPLMDrawWindow_f)(XPLMWindowID inWindowID, void *inRefcon);
+typedef void (*XPLMHandleKey_f)(XPLMWindowID inWindowID, char inKey, XPLMKeyFlags inFlags, char inVirtualKey, void *inRefcon, int losingFocus);
+typedef int (*XPLMHandleMouseClick_f)(XPLMWindowID inWindowID, int x, int y, XPLMMouseStatus inMouse, void *inRefcon);
+typedef XPLMCursorStatus (*XPLMHandleCursor_f)(XPLMWindowID inWindowID, int x, int y, void *inRefcon);
+typedef int (*XPLMHandleMouseWheel_f)(XPLMWindowID inWindowID, int x, int y, int wheel, int clicks, void *inRefcon);
+
+typedef struct {
+    int structSize;
+    int left;
+    int top;
+    int right;
+    int bottom;
+    int visible;
+    XPLMDrawWindow_f drawWindowFunc;
+    XPLMHandleMouseClick_f handleMouseClickFunc;
+    XPLMHandleKey_f handleKeyFunc;
+    XPLMHandleCursor_f handleCursorFunc;
+    XPLMHandleMouseWheel_f handleMouseWheelFunc;
+    void *refcon;
+    XPLMWindowDecoration decorateAsFloatingWindow;
+    XPLMWindowLayer layer;
+    XPLMHandleMouseClick_f handleRightClickFunc;
+} XPLMCreateWindow_t;
+
+XPLMWindowID XPLMCreateWindowEx(XPLMCreateWindow_t *inParams);
+void XPLMDestroyWindow(XPLMWindowID inWindowID);
+void XPLMGetScreenBoundsGlobal(int *outLeft, int *outTop, int *outRight, int *outBottom);
+void XPLMGetWindowGeometry(XPLMWindowID inWindowID, int *outLeft, int *outTop, int *outRight, int *outBottom);
+void XPLMSetWindowTitle(XPLMWindowID inWindowID, const char *inWindowTitle);
+void XPLMSetWindowPositioningMode(XPLMWindowID inWindowID, XPLMWindowPositioningMode inPositioningMode, int inMonitorIndex);
+void XPLMBringWindowToFront(XPLMWindowID inWindow);
+void XPLMTakeKeyboardFocus(XPLMWindowID inWindow);
+int XPLMHasKeyboardFocus(XPLMWindowID inWindow);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef XPLM_GRAPHICS_H
+#define XPLM_GRAPHICS_H
+
+#include "XPLMDefs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    xplmFont_Basic = 0,
+    xplmFont_Proportional = 18,
+};
+typedef int XPLMFontID;
+
+void XPLMSetGraphicsState(int inEnableFog, int inNumberTexUnits, int inEnableLighting, int inEnableAlphaTesting, int inEnableAlphaBlending, int inEnableDepthTesting, int inEnableDepthWriting);
+void XPLMBindTexture2d(int inTextureNum, int inTextureUnit);
+void XPLMGenerateTextureNumbers(int *outTextureIDs, int inCount);
+void XPLMDrawString(float *inColorRGB, int inXOffset, int inYOffset, const char *inChar, int *inWordWrapWidth, XPLMFontID inFontID);
+float XPLMMeasureString(XPLMFontID inFontID, const char *inChar, int inNumChars);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
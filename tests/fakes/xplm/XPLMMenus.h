@@ -0,0 +1,21 @@
+#ifndef XPLM_MENUS_H
+#define XPLM_MENUS_H
+
+#include "XPLMDefs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void *XPLMMenuID;
+typedef void (*XPLMMenuHandler_f)(void *inMenuRef, void *inItemRef);
+
+XPLMMenuID XPLMFindPluginsMenu(void);
+XPLMMenuID XPLMCreateMenu(const char *inName, XPLMMenuID inParentMenu, int inParentItem, XPLMMenuHandler_f inHandler, void *inMenuRef);
+int XPLMAppendMenuItem(XPLMMenuID inMenu, const char *inItemName, void *inItemRef, int inDeprecatedAndIgnored);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
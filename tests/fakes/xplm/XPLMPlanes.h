@@ -0,0 +1,18 @@
+#ifndef XPLM_PLANES_H
+#define XPLM_PLANES_H
+
+#include "XPLMDefs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define XPLM_USER_AIRCRAFT 0
+
+void XPLMGetNthAircraftModel(int inIndex, char *outFileName, char *outPath);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef XPLM_PLUGIN_H
+#define XPLM_PLUGIN_H
+
+#include "XPLMDefs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define XPLM_MSG_PLANE_CRASHED 101
+#define XPLM_MSG_PLANE_LOADED 102
+#define XPLM_MSG_AIRPORT_LOADED 103
+#define XPLM_MSG_SCENERY_LOADED 104
+#define XPLM_MSG_AIRPLANE_COUNT_CHANGED 105
+#define XPLM_MSG_PLANE_UNLOADED 106
+
+void XPLMEnableFeature(const char *inFeature, int inEnable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
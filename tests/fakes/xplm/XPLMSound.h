@@ -0,0 +1,48 @@
+#ifndef XPLM_SOUND_H
+#define XPLM_SOUND_H
+
+#include "XPLMDefs.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct FMOD_CHANNEL FMOD_CHANNEL;
+typedef int FMOD_RESULT;
+
+typedef enum {
+    FMOD_SOUND_FORMAT_NONE,
+    FMOD_SOUND_FORMAT_PCM8,
+    FMOD_SOUND_FORMAT_PCM16,
+    FMOD_SOUND_FORMAT_PCM24,
+    FMOD_SOUND_FORMAT_PCM32,
+    FMOD_SOUND_FORMAT_PCMFLOAT,
+} FMOD_SOUND_FORMAT;
+
+enum {
+    xplm_AudioRadioCom1 = 0,
+    xplm_AudioRadioCom2 = 1,
+    xplm_AudioRadioPilot = 2,
+    xplm_AudioRadioCopilot = 3,
+    xplm_AudioExteriorAircraft = 4,
+    xplm_AudioExteriorEnvironment = 5,
+    xplm_AudioExteriorUnprocessed = 6,
+    xplm_AudioInterior = 7,
+    xplm_AudioUI = 8,
+    xplm_AudioGround = 9,
+    xplm_Master = 10,
+};
+typedef int XPLMAudioBus;
+
+typedef void (*XPLMPCMComplete_f)(void *inRefcon, FMOD_RESULT status);
+
+FMOD_CHANNEL *XPLMPlayPCMOnBus(void *audioBuffer, uint32_t bufferSize, FMOD_SOUND_FORMAT soundFormat, int freqHz, int numChannels, int loops, XPLMAudioBus audioType, XPLMPCMComplete_f inCallback, void *inRefcon);
+FMOD_RESULT XPLMSetAudioVolume(FMOD_CHANNEL *fmod_channel, float source_volume);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef XPLM_UTILITIES_H
+#define XPLM_UTILITIES_H
+
+#include "XPLMDefs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void *XPLMCommandRef;
+
+enum {
+    xplm_CommandBegin = 0,
+    xplm_CommandContinue = 1,
+    xplm_CommandEnd = 2,
+};
+typedef int XPLMCommandPhase;
+
+typedef int (*XPLMCommandCallback_f)(XPLMCommandRef inCommand, XPLMCommandPhase inPhase, void *inRefcon);
+
+enum {
+    xplm_Language_Unknown = 0,
+    xplm_Language_English = 1,
+    xplm_Language_French = 2,
+    xplm_Language_German = 3,
+    xplm_Language_Italian = 4,
+    xplm_Language_Spanish = 5,
+    xplm_Language_Korean = 6,
+    xplm_Language_Russian = 7,
+    xplm_Language_Greek = 8,
+    xplm_Language_Japanese = 9,
+    xplm_Language_Chinese = 10,
+    xplm_Language_Ukrainian = 11,
+};
+typedef int XPLMLanguageCode;
+
+void XPLMDebugString(const char *inString);
+void XPLMGetSystemPath(char *outSystemPath);
+XPLMLanguageCode XPLMGetLanguage(void);
+
+XPLMCommandRef XPLMFindCommand(const char *inName);
+void XPLMCommandBegin(XPLMCommandRef inCommand);
+void XPLMCommandEnd(XPLMCommandRef inCommand);
+void XPLMCommandOnce(XPLMCommandRef inCommand);
+XPLMCommandRef XPLMCreateCommand(const char *inName, const char *inDescription);
+void XPLMRegisterCommandHandler(XPLMCommandRef inComand, XPLMCommandCallback_f inHandler, int inBefore, void *inRefcon);
+void XPLMUnregisterCommandHandler(XPLMCommandRef inComand, XPLMCommandCallback_f inHandler, int inBefore, void *inRefcon);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,76 @@
+#include "frame_rate_governor.h"
+#include <gtest/gtest.h>
+
+class FrameRateGovernorTest : public ::testing::Test {
+protected:
+    FrameRateGovernor governor = FrameRateGovernor(60, 2);
+    float time = 0.0f;
+
+    // Advances in 0.1 s ticks with the given paint rate and returns the rate the governor settles on.
+    int run(float seconds, float paintsPerSecond, float simFrameRate = 0.0f) {
+        float paintCredit = 0.0f;
+        for (float end = time + seconds; time < end - 0.001f;) {
+            time += 0.1f;
+            for (paintCredit += paintsPerSecond * 0.1f; paintCredit >= 1.0f; paintCredit -= 1.0f) {
+                governor.notifyPaint();
+            }
+            governor.update(time, simFrameRate);
+        }
+        return governor.frameRate;
+    }
+};
+
+TEST_F(FrameRateGovernorTest, StaticPageSettlesOnTheIdleRate) {
+    EXPECT_EQ(run(5.0f, 0.0f), 2);
+    EXPECT_EQ(governor.reason, "idle");
+}
+
+TEST_F(FrameRateGovernorTest, InputRaisesTheRateImmediately) {
+    run(5.0f, 0.0f);
+    governor.notifyInput(time);
+    governor.update(time, 0.0f);
+    EXPECT_EQ(governor.frameRate, 60);
+    EXPECT_EQ(governor.reason, "input");
+}
+
+TEST_F(FrameRateGovernorTest, SlowPageAtTheIdleRateIsNotTreatedAsAnimation) {
+    run(5.0f, 0.0f);
+
+    // Two paints a second saturate 2 fps, which used to jump straight to 60.
+    EXPECT_EQ(run(10.0f, 2.0f), 4);
+    EXPECT_EQ(governor.reason, "page updates");
+}
+
+TEST_F(FrameRateGovernorTest, SaturatedPageClimbsToTheMaximum) {
+    run(5.0f, 0.0f);
+    EXPECT_EQ(run(10.0f, 60.0f), 60);
+    EXPECT_EQ(governor.reason, "animation");
+}
+
+TEST_F(FrameRateGovernorTest, LowerRateMustBeWantedForTheWholeDelay) {
+    run(5.0f, 0.0f);
+    governor.notifyInput(time);
+    run(0.1f, 0.0f);
+    ASSERT_EQ(governor.frameRate, 60);
+
+    // Input stays active for 2 s; the idle rate is wanted from then on and applies 2 s later.
+    EXPECT_EQ(run(3.5f, 0.0f), 60);
+    EXPECT_EQ(run(0.7f, 0.0f), 2);
+}
+
+TEST_F(FrameRateGovernorTest, RaisedRateRestartsTheLowerDelay) {
+    run(5.0f, 0.0f);
+    governor.notifyInput(time);
+    run(3.0f, 0.0f);
+
+    // A single lower-rate tick long ago must not let a later request drop the rate right away.
+    governor.notifyInput(time);
+    run(2.1f, 0.0f);
+    EXPECT_EQ(governor.frameRate, 60);
+}
+
+TEST_F(FrameRateGovernorTest, SimFrameRateCapsTheRate) {
+    governor.notifyInput(time);
+    EXPECT_EQ(run(2.5f, 0.0f, 20.0f), 10);
+    EXPECT_EQ(governor.reason, "sim frame rate");
+}
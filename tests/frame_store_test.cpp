@@ -0,0 +1,112 @@
+#include "frame_store.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class FrameStoreTest : public ::testing::Test {
+protected:
+    static constexpr unsigned short width = 16;
+    static constexpr unsigned short height = 8;
+
+    static std::vector<unsigned char> filled(unsigned char value) {
+        return std::vector<unsigned char>((size_t)width * height * 4, value);
+    }
+
+    static unsigned char pixelAt(const FrameStore &store, int x, int y) {
+        return store.frontPixels()[((size_t)y * store.stride() + x) * 4];
+    }
+};
+
+TEST_F(FrameStoreTest, AcquireOnlySucceedsAfterAWrite) {
+    FrameStore store(width, height, 4);
+    EXPECT_FALSE(store.acquire());
+
+    auto frame = filled(7);
+    store.write(frame.data(), width, height, {{0, 0, width, height, 0, 0}});
+    ASSERT_TRUE(store.acquire());
+    EXPECT_EQ(pixelAt(store, 0, 0), 7);
+    EXPECT_EQ(pixelAt(store, width - 1, height - 1), 7);
+    ASSERT_EQ(store.frontRects().size(), 1u);
+    EXPECT_EQ(store.frontRects()[0].width, width);
+
+    EXPECT_FALSE(store.acquire());
+}
+
+TEST_F(FrameStoreTest, PartialPaintsKeepEarlierContent) {
+    FrameStore store(width, height, 4);
+    auto base = filled(1);
+    store.write(base.data(), width, height, {{0, 0, width, height, 0, 0}});
+    ASSERT_TRUE(store.acquire());
+
+    // Each later paint lands in a different back buffer, which must still hold the earlier frames.
+    auto second = filled(2);
+    store.write(second.data(), width, height, {{0, 0, 4, 4, 0, 0}});
+    ASSERT_TRUE(store.acquire());
+    auto third = filled(3);
+    store.write(third.data(), width, height, {{8, 4, 4, 4, 8, 4}});
+    ASSERT_TRUE(store.acquire());
+
+    EXPECT_EQ(pixelAt(store, 0, 0), 2);
+    EXPECT_EQ(pixelAt(store, 9, 5), 3);
+    EXPECT_EQ(pixelAt(store, 15, 0), 1);
+    ASSERT_EQ(store.frontRects().size(), 1u);
+    EXPECT_EQ(store.frontRects()[0].x, 8);
+}
+
+TEST_F(FrameStoreTest, SkippedFramesCarryTheirRectsForward) {
+    FrameStore store(width, height, 4);
+    auto frame = filled(5);
+    store.write(frame.data(), width, height, {{0, 0, 2, 2, 0, 0}});
+    store.write(frame.data(), width, height, {{4, 4, 2, 2, 4, 4}});
+    store.write(frame.data(), width, height, {{10, 0, 2, 2, 10, 0}});
+
+    ASSERT_TRUE(store.acquire());
+    EXPECT_EQ(store.frontRects().size(), 3u);
+    EXPECT_EQ(pixelAt(store, 0, 0), 5);
+    EXPECT_EQ(pixelAt(store, 5, 5), 5);
+    EXPECT_EQ(pixelAt(store, 11, 1), 5);
+}
+
+TEST_F(FrameStoreTest, RegionsAreClippedToTheFrame) {
+    FrameStore store(width, height, 4);
+    auto frame = filled(9);
+    store.write(frame.data(), width, height, {{12, 6, 10, 10, 12, 6}, {-1, 0, 4, 4, 0, 0}});
+
+    ASSERT_TRUE(store.acquire());
+    ASSERT_EQ(store.frontRects().size(), 1u);
+    EXPECT_EQ(store.frontRects()[0].width, 4);
+    EXPECT_EQ(store.frontRects()[0].height, 2);
+    EXPECT_EQ(pixelAt(store, 15, 7), 9);
+    EXPECT_EQ(pixelAt(store, 0, 0), 0);
+}
+
+TEST_F(FrameStoreTest, ConcurrentReaderNeverSeesATornFrame) {
+    FrameStore store(width, height, 4);
+    std::atomic<bool> done = false;
+    std::thread writer([&]() {
+        for (int value = 1; value < 256; ++value) {
+            auto frame = filled((unsigned char)value);
+            store.write(frame.data(), width, height, {{0, 0, width, height, 0, 0}});
+        }
+        done = true;
+    });
+
+    unsigned char last = 0;
+    bool finished = false;
+    while (!finished) {
+        finished = done;
+        if (!store.acquire()) {
+            continue;
+        }
+
+        unsigned char value = pixelAt(store, 0, 0);
+        EXPECT_GE(value, last);
+        for (size_t i = 0; i < (size_t)width * height * 4; ++i) {
+            ASSERT_EQ(store.frontPixels()[i], value);
+        }
+        last = value;
+    }
+    writer.join();
+    EXPECT_EQ(last, 255);
+}
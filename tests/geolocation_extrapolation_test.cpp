@@ -0,0 +1,54 @@
+#include "geolocation_channel.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+// Runs the injected receiver under node, since the extrapolation only exists as page JavaScript.
+class GeolocationExtrapolationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (system("node --version > /dev/null 2>&1") != 0) {
+            GTEST_SKIP() << "node is not installed";
+        }
+    }
+
+    static double field(const std::string &json, const std::string &name) {
+        size_t position = json.find("\"" + name + "\":");
+        return position == std::string::npos ? -1.0 : atof(json.c_str() + position + name.size() + 3);
+    }
+
+    std::string replay(int rate) {
+        std::string scriptPath = testing::TempDir() + "geolocation_receiver_" + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".js";
+        std::ofstream(scriptPath) << GeolocationChannel::getInstance()->receiverScript((float)rate, true);
+
+        std::string command = "node \"" TEST_DATA_DIR "/geolocation_replay.js\" \"" + scriptPath + "\" \"" TEST_DATA_DIR "/geolocation_track.csv\" " + std::to_string(rate);
+        std::string output;
+        FILE *pipe = popen(command.c_str(), "r");
+        char buffer[256];
+        while (pipe && fgets(buffer, sizeof(buffer), pipe)) {
+            output += buffer;
+        }
+        if (pipe) {
+            pclose(pipe);
+        }
+        return output;
+    }
+};
+
+TEST_F(GeolocationExtrapolationTest, FollowsTheTrackBetweenOneHertzSamples) {
+    std::string result = replay(1);
+    ASSERT_GT(field(result, "checked"), 1000.0) << result;
+
+    // Holding the last sample lags up to 63 m at 70 m/s; moving along the track stays within a few meters, even in the turn.
+    EXPECT_GT(field(result, "heldError"), 50.0) << result;
+    EXPECT_LT(field(result, "extrapolatedError"), 3.0) << result;
+    EXPECT_LT(field(result, "headingError"), 3.5) << result;
+}
+
+TEST_F(GeolocationExtrapolationTest, HigherSourceRatesTightenTheError) {
+    std::string result = replay(5);
+    ASSERT_GT(field(result, "checked"), 500.0) << result;
+    EXPECT_LT(field(result, "extrapolatedError"), 0.5) << result;
+}
@@ -0,0 +1,61 @@
+#include "image.h"
+#include "appstate.h"
+#include "asset_cache.h"
+#include "config.h"
+#include "fake_gl.h"
+#include "fake_xplm.h"
+#include "hash.h"
+#include "path.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+class ImageTest : public ::testing::Test {
+protected:
+    std::string directory;
+
+    void SetUp() override {
+        FakeXPLM::reset();
+        FakeGL::reset();
+        directory = testing::TempDir() + "image_test_" + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        Path::getInstance()->pluginDirectory = directory;
+    }
+
+    void TearDown() override {
+        AssetCache::getInstance()->destroy();
+        AppState::getInstance()->pixelScale = 1.0f;
+        std::filesystem::remove_all(directory);
+    }
+};
+
+TEST_F(ImageTest, VectorsAreRasterizedAtTheDrawnPixelSize) {
+    std::string source = "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"16\" height=\"16\"><circle cx=\"8\" cy=\"8\" r=\"6\" fill=\"#fff\"/></svg>";
+    std::string filename = directory + "/icon.svg";
+    std::ofstream(filename, std::ios::binary) << source;
+
+    // A 1600 pixel wide tablet, drawn at 1.5 pixels per unit.
+    AppState::getInstance()->tabletDimensions = {0, 0, 1600, 960, 2048, 1024, 1600, 960};
+    AppState::getInstance()->pixelScale = 1.5f;
+    Image image(filename);
+#if SCALE_IMAGES
+    EXPECT_EQ(image.pixelsWidth, 32u);
+    std::string raster = "_48x48.raw";
+#else
+    EXPECT_EQ(image.pixelsWidth, 16u);
+    std::string raster = "_24x24.raw";
+#endif
+    EXPECT_EQ(image.pixelsHeight, image.pixelsWidth);
+
+    std::string rasterCacheFilename = directory + "/raster_cache/" + Hash::ToHex(Hash::Fnv1a(source)) + raster;
+    for (int i = 0; i < 500 && !std::filesystem::exists(rasterCacheFilename); ++i) {
+        AssetCache::getInstance()->update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_TRUE(std::filesystem::exists(rasterCacheFilename));
+    image.destroy();
+}
@@ -0,0 +1,106 @@
+#ifndef LOCAL_HTTP_SERVER_H
+#define LOCAL_HTTP_SERVER_H
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <functional>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+// Single-threaded HTTP/1.0 stand-in on 127.0.0.1, for code that fetches with curl or CefURLRequest.
+// The handler gets the raw request and returns the raw response; an empty response leaves the
+// connection hanging until the server stops, like a stalled upstream.
+class LocalHttpServer {
+public:
+    typedef std::function<std::string(const std::string &request)> Handler;
+
+    explicit LocalHttpServer(Handler aHandler) : handler(aHandler) {
+        listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(listenSocket, (sockaddr *)&address, sizeof(address));
+        listen(listenSocket, 8);
+
+        socklen_t length = sizeof(address);
+        getsockname(listenSocket, (sockaddr *)&address, &length);
+        listenPort = ntohs(address.sin_port);
+        thread = std::thread([this]() {
+            run();
+        });
+    }
+
+    ~LocalHttpServer() {
+        stopped = true;
+        thread.join();
+        close(listenSocket);
+    }
+
+    static std::string response(int status, const std::string &body, const std::string &headers = "") {
+        return "HTTP/1.0 " + std::to_string(status) + " Status\r\nContent-Length: " + std::to_string(body.size()) + "\r\n" + headers + "\r\n" + body;
+    }
+
+    std::string url(const std::string &path) const {
+        return "http://127.0.0.1:" + std::to_string(listenPort) + path;
+    }
+
+    unsigned int requestCount() const {
+        return requests;
+    }
+
+private:
+    Handler handler;
+    int listenSocket;
+    unsigned short listenPort;
+    std::atomic<bool> stopped = false;
+    std::atomic<unsigned int> requests = 0;
+    std::thread thread;
+
+    bool waitReadable(int fd) {
+        pollfd entry = {fd, POLLIN, 0};
+        while (!stopped) {
+            if (poll(&entry, 1, 20) > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run() {
+        while (waitReadable(listenSocket)) {
+            int client = accept(listenSocket, nullptr, nullptr);
+            if (client < 0) {
+                continue;
+            }
+
+            std::string request;
+            char buffer[4096];
+            while (request.find("\r\n\r\n") == std::string::npos && waitReadable(client)) {
+                ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+                if (received <= 0) {
+                    break;
+                }
+                request.append(buffer, received);
+            }
+
+            requests++;
+            std::string reply = handler(request);
+            if (reply.empty()) {
+                while (waitReadable(client) && recv(client, buffer, sizeof(buffer), 0) > 0) {
+                }
+            } else {
+                send(client, reply.data(), reply.size(), MSG_NOSIGNAL);
+            }
+            close(client);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include "lru_cache.h"
+#include <gtest/gtest.h>
+#include <string>
+
+TEST(LruCacheTest, EvictsTheLeastRecentlyInsertedFirst) {
+    LruCache<int> cache(3);
+    cache.insert("a", 1);
+    cache.insert("b", 2);
+    cache.insert("c", 3);
+    cache.insert("d", 4);
+
+    EXPECT_EQ(cache.find("a"), nullptr);
+    ASSERT_NE(cache.find("b"), nullptr);
+    EXPECT_EQ(*cache.find("b"), 2);
+    EXPECT_EQ(*cache.find("c"), 3);
+    EXPECT_EQ(*cache.find("d"), 4);
+
+    // The finds above used b, c and d in that order, so b goes next.
+    cache.insert("e", 5);
+    EXPECT_EQ(cache.find("b"), nullptr);
+    EXPECT_NE(cache.find("c"), nullptr);
+}
+
+TEST(LruCacheTest, FindRefreshesAnEntry) {
+    LruCache<int> cache(2);
+    cache.insert("a", 1);
+    cache.insert("b", 2);
+    ASSERT_NE(cache.find("a"), nullptr);
+
+    cache.insert("c", 3);
+    EXPECT_EQ(cache.find("b"), nullptr);
+    EXPECT_NE(cache.find("a"), nullptr);
+    EXPECT_NE(cache.find("c"), nullptr);
+}
+
+TEST(LruCacheTest, InsertingAnExistingKeyReplacesAndRefreshesIt) {
+    LruCache<std::string> cache(2);
+    cache.insert("a", "first");
+    cache.insert("b", "second");
+    EXPECT_EQ(cache.insert("a", "replaced"), "replaced");
+
+    cache.insert("c", "third");
+    EXPECT_EQ(cache.find("b"), nullptr);
+    ASSERT_NE(cache.find("a"), nullptr);
+    EXPECT_EQ(*cache.find("a"), "replaced");
+}
+
+TEST(LruCacheTest, ClearDropsEverything) {
+    LruCache<int> cache(2);
+    cache.insert("a", 1);
+    cache.clear();
+    EXPECT_EQ(cache.find("a"), nullptr);
+
+    cache.insert("b", 2);
+    cache.insert("c", 3);
+    EXPECT_NE(cache.find("b"), nullptr);
+    EXPECT_NE(cache.find("c"), nullptr);
+}
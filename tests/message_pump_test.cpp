@@ -0,0 +1,107 @@
+#include "message_pump.h"
+#include "appstate.h"
+#include "fake_cef.h"
+#include "fake_xplm.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+static float flightLoop(float inElapsedSinceLastCall, float inElapsedTimeSinceLastFlightLoop, int inCounter, void *inRefcon) {
+    return 0.0f;
+}
+
+class MessagePumpTest : public ::testing::Test {
+protected:
+    MessagePump *pump;
+
+    void SetUp() override {
+        FakeXPLM::reset();
+        FakeCef::reset();
+        pump = MessagePump::getInstance();
+        pump->reset();
+        pump->setFlightLoop(flightLoop);
+    }
+
+    void scheduleFromCefThread(long long delayMilliseconds) {
+        std::thread([this, delayMilliseconds]() {
+            pump->scheduleWork(delayMilliseconds);
+        }).join();
+    }
+};
+
+TEST_F(MessagePumpTest, HiddenWithoutCallbacksWaitsForTheMaintenancePump) {
+    // Before the first pump the loop still only ticks at the tablet poll interval.
+    EXPECT_FLOAT_EQ(pump->nextFlightLoopInterval(false), AppState::getInstance()->tabletPollInterval());
+    ASSERT_TRUE(pump->pumpInBackground());
+
+    float interval = pump->nextFlightLoopInterval(false);
+    EXPECT_GT(interval, 0.9f);
+    EXPECT_LE(interval, 1.0f);
+    EXPECT_FALSE(pump->pumpInBackground());
+}
+
+TEST_F(MessagePumpTest, HiddenWithNothingScheduledParksTheFlightLoop) {
+    scheduleFromCefThread(0);
+    ASSERT_TRUE(pump->pumpInBackground());
+
+    EXPECT_GT(pump->nextFlightLoopInterval(false), 4.9f);
+    EXPECT_FALSE(pump->pumpInBackground());
+}
+
+TEST_F(MessagePumpTest, WorkScheduledOnACefThreadShortensTheNextWakeUp) {
+    scheduleFromCefThread(0);
+    ASSERT_TRUE(pump->pumpInBackground());
+    ASSERT_GT(pump->nextFlightLoopInterval(false), 4.9f);
+
+    // XPLM can't be called from here, so the loop isn't woken, but its next interval drops back.
+    scheduleFromCefThread(0);
+    EXPECT_EQ(FakeXPLM::flightLoopInterval(), 0.0f);
+    EXPECT_LE(pump->nextFlightLoopInterval(false), 1.0f);
+}
+
+TEST_F(MessagePumpTest, WorkScheduledOnTheSimThreadWakesTheParkedLoop) {
+    scheduleFromCefThread(0);
+    ASSERT_TRUE(pump->pumpInBackground());
+    ASSERT_GT(pump->nextFlightLoopInterval(false), 4.9f);
+
+    pump->scheduleWork(0);
+    EXPECT_EQ(FakeXPLM::flightLoopInterval(), -1.0f);
+}
+
+TEST_F(MessagePumpTest, InputWakesTheParkedLoop) {
+    ASSERT_TRUE(pump->pumpInBackground());
+    ASSERT_GT(pump->nextFlightLoopInterval(false), 0.9f);
+
+    pump->notifyInput();
+    EXPECT_EQ(FakeXPLM::flightLoopInterval(), -1.0f);
+    EXPECT_EQ(pump->nextFlightLoopInterval(true), -1.0f);
+}
+
+TEST_F(MessagePumpTest, VisibleIdlePageParksUntilItsNextPump) {
+    ASSERT_TRUE(pump->pumpIfDue());
+    EXPECT_FALSE(pump->pumpIfDue());
+
+    // The first pump of an idle page doubles the estimated interval to 0.5 seconds.
+    float interval = pump->nextFlightLoopInterval(true);
+    EXPECT_GT(interval, 0.4f);
+    EXPECT_LE(interval, 0.5f);
+
+    pump->notifyInput();
+    EXPECT_EQ(FakeXPLM::flightLoopInterval(), -1.0f);
+    EXPECT_EQ(pump->nextFlightLoopInterval(true), -1.0f);
+}
+
+TEST_F(MessagePumpTest, VisiblePageWithCallbacksParksAtTheSafetyNet) {
+    scheduleFromCefThread(0);
+    ASSERT_TRUE(pump->pumpIfDue());
+
+    EXPECT_GT(pump->nextFlightLoopInterval(true), 0.9f);
+    pump->scheduleWork(10);
+    EXPECT_EQ(FakeXPLM::flightLoopInterval(), -1.0f);
+    EXPECT_LE(pump->nextFlightLoopInterval(true), 0.01f);
+}
+
+TEST_F(MessagePumpTest, TabletIsPolledQuicklyWithoutPower) {
+    AppState::getInstance()->hasPower = false;
+    EXPECT_GT(AppState::getInstance()->tabletPollInterval(), 0.0f);
+    EXPECT_LE(AppState::getInstance()->tabletPollInterval(), 0.25f);
+}
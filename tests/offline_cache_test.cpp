@@ -0,0 +1,152 @@
+#include "offline_cache.h"
+#include "fake_cef.h"
+#include "fake_xplm.h"
+#include "local_http_server.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+class OfflineCacheTest : public ::testing::Test {
+protected:
+    std::string directory = testing::TempDir() + "offline_cache_test_" + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    std::vector<std::string> patterns = {"http://127.0.0.1:*"};
+    OfflineCache *cache;
+
+    void SetUp() override {
+        FakeXPLM::reset();
+        FakeCef::reset();
+        std::filesystem::remove_all(directory);
+        cache = OfflineCache::getInstance();
+        cache->initialize(directory, patterns);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory);
+    }
+
+    CefRefPtr<CefBrowser> createBrowser() {
+        CefWindowInfo windowInfo;
+        windowInfo.SetAsWindowless(0);
+        CefBrowserHost::CreateBrowser(windowInfo, nullptr, "about:blank", CefBrowserSettings(), nullptr, nullptr);
+        CefDoMessageLoopWork();
+        return FakeCef::lastBrowser();
+    }
+
+    std::string serve(CefRefPtr<CefBrowser> browser, const std::string &url) {
+        CefRefPtr<CefRequest> request = CefRequest::Create();
+        request->SetURL(url);
+        request->SetMethod("GET");
+        CefRefPtr<CefResourceHandler> handler = cache->createResourceHandler(browser, request);
+        if (!handler) {
+            return "";
+        }
+
+        std::string body;
+        char buffer[256];
+        int bytesRead = 0;
+        while (handler->Read(buffer, sizeof(buffer), bytesRead, nullptr)) {
+            body.append(buffer, bytesRead);
+        }
+        return body;
+    }
+
+    CefRefPtr<CefResponse> responseHeaders(CefRefPtr<CefBrowser> browser, const std::string &url) {
+        CefRefPtr<CefRequest> request = CefRequest::Create();
+        request->SetURL(url);
+        request->SetMethod("GET");
+        CefRefPtr<CefResourceHandler> handler = cache->createResourceHandler(browser, request);
+        if (!handler) {
+            return nullptr;
+        }
+
+        CefRefPtr<CefResponse> response = CefResponse::Create();
+        int64_t length = 0;
+        CefString redirectUrl;
+        handler->GetResponseHeaders(response, length, redirectUrl);
+        return response;
+    }
+
+    void storeOnFileThread(const std::string &url, const std::string &body) {
+        std::thread([&]() {
+            cache->store(url, "application/json", {{"Content-Type", "application/json"}}, body);
+        }).join();
+    }
+};
+
+TEST_F(OfflineCacheTest, RevalidationStoresTheChangedResponse) {
+    std::mutex bodyMutex;
+    std::string currentBody = "{\"version\": 2}";
+    LocalHttpServer server([&](const std::string &request) {
+        std::lock_guard<std::mutex> lock(bodyMutex);
+        return LocalHttpServer::response(200, currentBody, "Content-Type: application/json\r\n");
+    });
+    std::string url = server.url("/data.json");
+    CefRefPtr<CefBrowser> browser = createBrowser();
+
+    storeOnFileThread(url, "{\"version\": 1}");
+    // Reloading the index marks every entry as unchecked, so the next serve revalidates.
+    cache->initialize(directory, patterns);
+    EXPECT_EQ(serve(browser, url), "{\"version\": 1}");
+
+    CefDoMessageLoopWork();
+    FakeCef::waitForBackgroundTasks();
+    EXPECT_EQ(server.requestCount(), 1u);
+
+    cache->initialize(directory, patterns);
+    EXPECT_EQ(serve(browser, url), "{\"version\": 2}");
+    EXPECT_EQ(FakeXPLM::offThreadDebugCount(), 0u);
+}
+
+TEST_F(OfflineCacheTest, UnchangedResponseKeepsOneObject) {
+    LocalHttpServer server([](const std::string &request) {
+        return LocalHttpServer::response(200, "same", "Content-Type: text/plain\r\n");
+    });
+    std::string url = server.url("/same.txt");
+    CefRefPtr<CefBrowser> browser = createBrowser();
+
+    storeOnFileThread(url, "same");
+    cache->initialize(directory, patterns);
+    EXPECT_EQ(serve(browser, url), "same");
+    CefDoMessageLoopWork();
+    FakeCef::waitForBackgroundTasks();
+
+    auto objects = std::distance(std::filesystem::directory_iterator(directory + "/objects"), std::filesystem::directory_iterator());
+    EXPECT_EQ(objects, 1);
+}
+
+TEST_F(OfflineCacheTest, CachedResponseReplaysTheOriginalHeaders) {
+    LocalHttpServer server([](const std::string &request) {
+        return LocalHttpServer::response(200, "<p>Grüße</p>", "Content-Type: text/html; charset=ISO-8859-1\r\nContent-Language: de\r\nAccess-Control-Allow-Origin: *\r\nX-Not-Stored: 1\r\n");
+    });
+    std::string url = server.url("/page.html");
+    CefRefPtr<CefBrowser> browser = createBrowser();
+
+    storeOnFileThread(url, "<p>Grüße</p>");
+    cache->initialize(directory, patterns);
+    EXPECT_EQ(serve(browser, url), "<p>Grüße</p>");
+    CefDoMessageLoopWork();
+    FakeCef::waitForBackgroundTasks();
+    ASSERT_EQ(server.requestCount(), 1u);
+
+    // Only the headers changed, and they survive reloading the index.
+    cache->initialize(directory, patterns);
+    CefRefPtr<CefResponse> response = responseHeaders(browser, url);
+    ASSERT_TRUE(response);
+    EXPECT_EQ(response->GetStatus(), 200);
+    EXPECT_EQ(response->GetMimeType().ToString(), "text/html");
+    EXPECT_EQ(response->GetCharset().ToString(), "ISO-8859-1");
+    EXPECT_EQ(response->GetHeaderByName("Content-Type").ToString(), "text/html; charset=ISO-8859-1");
+    EXPECT_EQ(response->GetHeaderByName("Content-Language").ToString(), "de");
+    EXPECT_EQ(response->GetHeaderByName("Access-Control-Allow-Origin").ToString(), "*");
+    EXPECT_TRUE(response->GetHeaderByName("X-Not-Stored").empty());
+}
+
+TEST_F(OfflineCacheTest, WriteFailureIsNotLoggedFromTheFileThread) {
+    std::filesystem::remove_all(directory + "/objects");
+    std::ofstream(directory + "/objects") << "not a directory";
+
+    storeOnFileThread("http://127.0.0.1:1/broken.json", "{}");
+    EXPECT_EQ(FakeXPLM::offThreadDebugCount(), 0u);
+}
@@ -0,0 +1,74 @@
+#include "sprite_batch.h"
+#include "appstate.h"
+#include "asset_cache.h"
+#include "fake_gl.h"
+#include "fake_xplm.h"
+#include "image.h"
+#include "lodepng.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+class SpriteBatchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        FakeXPLM::reset();
+        FakeGL::reset();
+    }
+
+    void TearDown() override {
+        AssetCache::getInstance()->destroy();
+    }
+};
+
+TEST_F(SpriteBatchTest, QuadsSharingATextureGoOutInOneCall) {
+    SpriteBatch batch;
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(batch.add(7, 10.0f * i, 10.0f, 8.0f, 8.0f, 0, 0.0f, 0.0f, 0.5f, 0.5f));
+    }
+
+    batch.draw(1.0f);
+    EXPECT_EQ(FakeGL::counters().drawArrays, 1u);
+    EXPECT_EQ(FakeGL::counters().drawArraysVertices, 30u);
+    EXPECT_EQ(FakeGL::counters().begins, 0u);
+    EXPECT_EQ(FakeXPLM::lastBoundTexture(), 7);
+}
+
+TEST_F(SpriteBatchTest, OtherTexturesAndPlaceholdersBecomeRunsInDrawOrder) {
+    SpriteBatch batch;
+    ASSERT_TRUE(batch.add(7, 0.0f, 0.0f, 8.0f, 8.0f, 0, 0.0f, 0.0f, 0.5f, 0.5f));
+    ASSERT_TRUE(batch.add(7, 10.0f, 0.0f, 8.0f, 8.0f, 90, 0.0f, 0.0f, 0.5f, 0.5f));
+    ASSERT_TRUE(batch.add(9, 20.0f, 0.0f, 128.0f, 128.0f, 0, 0.0f, 0.0f, 1.0f, 1.0f));
+    batch.addPlaceholder(30.0f, 0.0f, 8.0f, 8.0f);
+    ASSERT_TRUE(batch.add(7, 40.0f, 0.0f, 8.0f, 8.0f, 0, 0.5f, 0.5f, 1.0f, 1.0f));
+    EXPECT_FALSE(batch.add(0, 50.0f, 0.0f, 8.0f, 8.0f, 0, 0.0f, 0.0f, 1.0f, 1.0f));
+
+    batch.draw(1.0f);
+    EXPECT_EQ(FakeGL::counters().drawArrays, 4u);
+    EXPECT_EQ(FakeGL::counters().drawArraysVertices, 30u);
+    EXPECT_EQ(FakeGL::counters().begins, 0u);
+    EXPECT_EQ(FakeXPLM::lastBoundTexture(), 7);
+
+    // Drawing clears the batch for the next frame.
+    batch.draw(1.0f);
+    EXPECT_EQ(FakeGL::counters().drawArrays, 4u);
+}
+
+TEST_F(SpriteBatchTest, PendingImageAddsAPlaceholderInsteadOfDrawingImmediately) {
+    AppState::getInstance()->tabletDimensions = {0, 0, 800, 480, 800, 480, 800, 450};
+    std::string filename = testing::TempDir() + "sprite_batch_test_" + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".png";
+    std::vector<unsigned char> pixels(12 * 12 * 4, 255);
+    ASSERT_EQ(lodepng_encode32_file(filename.c_str(), pixels.data(), 12, 12), 0u);
+
+    Image image(filename);
+    image.setPosition(0.5f, 0.5f);
+    SpriteBatch batch;
+    image.addToBatch(batch);
+    EXPECT_EQ(FakeGL::counters().begins, 0u);
+
+    batch.draw(1.0f);
+    EXPECT_EQ(FakeGL::counters().drawArrays, 1u);
+    EXPECT_EQ(FakeGL::counters().drawArraysVertices, 6u);
+    EXPECT_EQ(FakeGL::counters().begins, 0u);
+    image.destroy();
+}
@@ -0,0 +1,100 @@
+#include "texture_atlas.h"
+#include "fake_gl.h"
+#include "fake_xplm.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+class TextureAtlasTest : public ::testing::Test {
+protected:
+    // 16x16 images take 18x18 with their padding, so three fit on each of three shelves.
+    static constexpr unsigned short size = 64;
+    std::vector<unsigned char> pixels;
+
+    void SetUp() override {
+        FakeXPLM::reset();
+        FakeGL::reset();
+        pixels.assign(32 * 32 * 4, 255);
+    }
+
+    static int texelX(const AtlasRegion &region) {
+        return (int)(region.u1 * size);
+    }
+
+    static int texelY(const AtlasRegion &region) {
+        return (int)(region.v1 * size);
+    }
+};
+
+TEST_F(TextureAtlasTest, RemovedRegionIsReusedWhileOthersStayInUse) {
+    TextureAtlas atlas(size);
+    AtlasRegion regions[9];
+    for (auto &region : regions) {
+        ASSERT_TRUE(atlas.add(pixels.data(), 16, 16, &region));
+    }
+
+    AtlasRegion extra;
+    EXPECT_FALSE(atlas.add(pixels.data(), 16, 16, &extra));
+
+    atlas.remove(regions[4]);
+    ASSERT_TRUE(atlas.add(pixels.data(), 16, 16, &extra));
+    EXPECT_EQ(texelX(extra), texelX(regions[4]));
+    EXPECT_EQ(texelY(extra), texelY(regions[4]));
+    atlas.destroy();
+}
+
+TEST_F(TextureAtlasTest, RemovedSlotIsWipedBeforeReuse) {
+    TextureAtlas atlas(size);
+    AtlasRegion first;
+    AtlasRegion second;
+    ASSERT_TRUE(atlas.add(pixels.data(), 16, 16, &first));
+    ASSERT_TRUE(atlas.add(pixels.data(), 16, 16, &second));
+
+    size_t uploadedPixels = FakeGL::counters().texSubImagePixels;
+    atlas.remove(first);
+    EXPECT_EQ(FakeGL::counters().texSubImagePixels - uploadedPixels, 18u * 18u);
+
+    // A smaller image goes into the wiped slot, and the rest of it stays free.
+    AtlasRegion small;
+    ASSERT_TRUE(atlas.add(pixels.data(), 8, 8, &small));
+    EXPECT_EQ(texelX(small), texelX(first));
+    EXPECT_EQ(texelY(small), texelY(first));
+    AtlasRegion beside;
+    ASSERT_TRUE(atlas.add(pixels.data(), 6, 6, &beside));
+    EXPECT_EQ(texelX(beside), texelX(first) + 10);
+    EXPECT_EQ(texelY(beside), texelY(first));
+    atlas.destroy();
+}
+
+TEST_F(TextureAtlasTest, NeighbouringFreeSlotsMergeForLargerImages) {
+    TextureAtlas atlas(size);
+    AtlasRegion regions[9];
+    for (auto &region : regions) {
+        ASSERT_TRUE(atlas.add(pixels.data(), 16, 16, &region));
+    }
+
+    atlas.remove(regions[3]);
+    atlas.remove(regions[4]);
+    AtlasRegion wide;
+    ASSERT_TRUE(atlas.add(pixels.data(), 32, 16, &wide));
+    EXPECT_EQ(texelX(wide), texelX(regions[3]));
+    EXPECT_EQ(texelY(wide), texelY(regions[3]));
+    atlas.destroy();
+}
+
+TEST_F(TextureAtlasTest, RemovingTheLastRegionStartsOver) {
+    TextureAtlas atlas(size);
+    AtlasRegion regions[3];
+    for (auto &region : regions) {
+        ASSERT_TRUE(atlas.add(pixels.data(), 16, 16, &region));
+    }
+
+    for (auto &region : regions) {
+        atlas.remove(region);
+    }
+
+    AtlasRegion large;
+    ASSERT_TRUE(atlas.add(pixels.data(), 32, 32, &large));
+    EXPECT_EQ(texelX(large), 1);
+    EXPECT_EQ(texelY(large), 1);
+    atlas.destroy();
+}
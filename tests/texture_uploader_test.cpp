@@ -0,0 +1,59 @@
+#include "texture_uploader.h"
+#include "fake_gl.h"
+#include "fake_xplm.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+class TextureUploaderTest : public ::testing::Test {
+protected:
+    static constexpr unsigned short width = 64;
+    static constexpr unsigned short height = 32;
+    std::vector<unsigned char> pixels;
+
+    void SetUp() override {
+        FakeXPLM::reset();
+        FakeGL::reset();
+        pixels.assign((size_t)width * (height + 8) * 4, 0);
+    }
+};
+
+TEST_F(TextureUploaderTest, UploadsReuseThePixelBufferRing) {
+    TextureUploader uploader(1, width, height, 4);
+    ASSERT_TRUE(uploader.usesPixelBuffers());
+    unsigned int initialBufferDatas = FakeGL::counters().bufferDatas;
+
+    for (int frame = 0; frame < 10; ++frame) {
+        uploader.queue({{0, frame, width, 1}});
+        uploader.flush(pixels.data(), width);
+        uploader.endFrame();
+    }
+
+    EXPECT_EQ(FakeGL::counters().bufferDatas, initialBufferDatas);
+    EXPECT_EQ(FakeGL::counters().orphanedBuffers, 0u);
+    EXPECT_EQ(FakeGL::counters().mappedBuffers, 10u);
+    EXPECT_EQ(FakeGL::counters().pixelBufferUploads, 10u);
+    EXPECT_EQ(FakeGL::counters().outOfBoundsReads, 0u);
+    uploader.destroy();
+}
+
+TEST_F(TextureUploaderTest, RowsBeyondThePixelBufferUploadFromClientMemory) {
+    TextureUploader uploader(1, width, height, 4);
+    uploader.queue({{0, height - 2, width, 8}});
+    uploader.flush(pixels.data(), width);
+
+    EXPECT_EQ(FakeGL::counters().texSubImages, 1u);
+    EXPECT_EQ(FakeGL::counters().pixelBufferUploads, 0u);
+    EXPECT_EQ(FakeGL::counters().outOfBoundsReads, 0u);
+    uploader.destroy();
+}
+
+TEST_F(TextureUploaderTest, WideSourceUploadsFromClientMemory) {
+    TextureUploader uploader(1, width, height, 4);
+    std::vector<unsigned char> wide((size_t)width * 2 * height * 4, 0);
+    uploader.queue({{width, 0, width, height}});
+    uploader.flush(wide.data(), width * 2);
+
+    EXPECT_EQ(FakeGL::counters().texSubImages, 1u);
+    EXPECT_EQ(FakeGL::counters().pixelBufferUploads, 0u);
+    uploader.destroy();
+}
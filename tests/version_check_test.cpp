@@ -0,0 +1,60 @@
+#include "appstate.h"
+#include "fake_xplm.h"
+#include "local_http_server.h"
+#include <gtest/gtest.h>
+#include <chrono>
+
+class VersionCheckTest : public ::testing::Test {
+protected:
+    std::atomic<bool> aborted = false;
+    std::string error;
+
+    void SetUp() override {
+        FakeXPLM::reset();
+    }
+};
+
+TEST_F(VersionCheckTest, ReadsTheLatestReleaseTag) {
+    LocalHttpServer server([](const std::string &request) {
+        return LocalHttpServer::response(200, R"([{"tag_name": "v1.2.3"}])");
+    });
+
+    EXPECT_EQ(AppState::fetchLatestVersionTag(server.url("/releases"), aborted, error), "1.2.3");
+    EXPECT_TRUE(error.empty());
+    EXPECT_EQ(server.requestCount(), 1u);
+}
+
+TEST_F(VersionCheckTest, FailuresAreReturnedInsteadOfLogged) {
+    LocalHttpServer server([](const std::string &request) {
+        return LocalHttpServer::response(200, "rate limited");
+    });
+
+    std::string tag;
+    std::thread([&]() {
+        tag = AppState::fetchLatestVersionTag(server.url("/releases"), aborted, error);
+    }).join();
+
+    EXPECT_TRUE(tag.empty());
+    EXPECT_NE(error.find("Could not parse"), std::string::npos);
+    EXPECT_EQ(FakeXPLM::offThreadDebugCount(), 0u);
+}
+
+TEST_F(VersionCheckTest, AbortCutsAStalledFetchShort) {
+    LocalHttpServer server([](const std::string &request) {
+        return std::string();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    std::string tag;
+    std::thread fetch([&]() {
+        tag = AppState::fetchLatestVersionTag(server.url("/releases"), aborted, error);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    aborted = true;
+    fetch.join();
+
+    // Without the abort this would wait for VERSION_CHECK_TIMEOUT_SECONDS.
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(2000));
+    EXPECT_TRUE(tag.empty());
+    EXPECT_NE(error.find("aborted"), std::string::npos) << error;
+}